@@ -575,6 +575,257 @@ LZ4_memcpy_using_offset(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const si
 #endif
 
 
+/*-************************************
+*  Runtime CPU dispatch
+**************************************/
+/* On x86, gcc and clang can compile individual functions for a more recent ISA
+ * than the rest of the binary, using target attributes. */
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && ((defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__))
+#  define LZ4_X86_TARGETS 1
+#  include <immintrin.h>
+#  define LZ4_TARGET_SSSE3 __attribute__((target("ssse3")))
+#  define LZ4_TARGET_AVX2  __attribute__((target("avx2,bmi,bmi2")))
+#endif
+
+/*
+ * LZ4_CPU_DISPATCH :
+ * The hot loops of LZ4_compress_fast() and of the safe decoders (LZ4_decompress_safe(),
+ * its _partial(), _continue() and _usingDict() variants) are compiled
+ * several times, for different ISA levels (AVX2+BMI2, SSSE3 for decoding, baseline),
+ * and each invocation is bound to the best flavor supported by the host cpu.
+ * This way, a single binary built for baseline x86 runs at full speed on recent cpus.
+ * Only available on x86, with gcc >= 5 or clang. Set to 0 to disable.
+ */
+#ifndef LZ4_CPU_DISPATCH
+#  ifdef LZ4_X86_TARGETS
+#    define LZ4_CPU_DISPATCH 1
+#  else
+#    define LZ4_CPU_DISPATCH 0
+#  endif
+#endif
+#if LZ4_CPU_DISPATCH && !defined(LZ4_X86_TARGETS)
+#  undef  LZ4_CPU_DISPATCH
+#  define LZ4_CPU_DISPATCH 0
+#endif
+
+#if LZ4_CPU_DISPATCH
+typedef enum {
+    LZ4_cpu_unknown = 0,
+    LZ4_cpu_baseline,
+    LZ4_cpu_ssse3,
+    LZ4_cpu_avx2     /* avx2 + bmi + bmi2 */
+} LZ4_cpuLevel_e;
+
+/* LZ4_cpuLevel() :
+ * Probes the host cpu on first invocation, then returns the cached result.
+ * Like CPU_IsSupported_AVX2() in 7-zip, __builtin_cpu_supports("avx2") also checks
+ * that the OS saves ymm registers.
+ * Concurrent first invocations may probe more than once : they store the same value. */
+static LZ4_cpuLevel_e LZ4_cpuLevel(void)
+{
+    static int g_cpuLevel = LZ4_cpu_unknown;
+    int level = __atomic_load_n(&g_cpuLevel, __ATOMIC_RELAXED);
+    if (unlikely(level == LZ4_cpu_unknown)) {
+        __builtin_cpu_init();
+        level = LZ4_cpu_baseline;
+        if (__builtin_cpu_supports("ssse3")) level = LZ4_cpu_ssse3;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi")
+          && __builtin_cpu_supports("bmi2")) level = LZ4_cpu_avx2;
+        __atomic_store_n(&g_cpuLevel, level, __ATOMIC_RELAXED);
+    }
+    return (LZ4_cpuLevel_e)level;
+}
+#endif
+
+
+/*-************************************
+*  Decoding kernels
+**************************************/
+/*
+ * LZ4_DEC_SIMD :
+ * Explicitly vectorized literal and match copy kernels for the fast decoding loop.
+ * On x86, SSSE3 and AVX2 kernels are compiled using target attributes,
+ * and are selected at runtime by LZ4_CPU_DISPATCH.
+ * On AArch64, NEON is part of the base ISA, so its kernels are used directly.
+ * Set to 0 to only use portable kernels.
+ */
+#ifndef LZ4_DEC_SIMD
+#  if LZ4_FAST_DEC_LOOP && defined(LZ4_X86_TARGETS)
+#    define LZ4_DEC_SIMD 1
+#  elif LZ4_FAST_DEC_LOOP && defined(__aarch64__) && defined(__ARM_NEON) \
+      && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#    define LZ4_DEC_SIMD 1
+#  else
+#    define LZ4_DEC_SIMD 0
+#  endif
+#endif
+
+typedef enum {   /* same values as LZ4_decodeKernel_e */
+    decodeKernel_portable = 0,
+    decodeKernel_ssse3,
+    decodeKernel_avx2,
+    decodeKernel_neon
+} decodeKernel_directive;
+
+#if LZ4_DEC_SIMD && defined(LZ4_X86_TARGETS)
+#  define LZ4_DEC_SIMD_X86 1
+#elif LZ4_DEC_SIMD && defined(__aarch64__)
+#  define LZ4_DEC_SIMD_NEON 1
+#  include <arm_neon.h>
+#endif
+
+/* kernel used when there is no runtime selection */
+#if defined(LZ4_DEC_SIMD_X86) && defined(__AVX2__)
+#  define LZ4_DEC_KERNEL_DEFAULT decodeKernel_avx2
+#elif defined(LZ4_DEC_SIMD_X86) && defined(__SSSE3__)
+#  define LZ4_DEC_KERNEL_DEFAULT decodeKernel_ssse3
+#elif defined(LZ4_DEC_SIMD_NEON)
+#  define LZ4_DEC_KERNEL_DEFAULT decodeKernel_neon
+#else
+#  define LZ4_DEC_KERNEL_DEFAULT decodeKernel_portable
+#endif
+
+#if LZ4_DEC_SIMD
+
+/* Short offsets (< 16) : the match is a repetition of its first `offset` bytes.
+ * A 32-byte pattern is built once with a byte shuffle, using row `offset` of LZ4_dec_patternTable
+ * (pattern[i] = match[i % offset]), then stored repeatedly,
+ * advancing by the largest multiple of `offset` <= 32, so that the pattern stays in phase.
+ * Row 0 is never used : offset==0 (corrupted input) is routed to the portable path. */
+static const BYTE LZ4_dec_patternTable[16][32] = {
+    { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 },
+    { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 },
+    { 0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1 },
+    { 0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0, 1,2,0,1,2,0,1,2,0,1,2,0,1,2,0,1 },
+    { 0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3, 0,1,2,3,0,1,2,3,0,1,2,3,0,1,2,3 },
+    { 0,1,2,3,4,0,1,2,3,4,0,1,2,3,4,0, 1,2,3,4,0,1,2,3,4,0,1,2,3,4,0,1 },
+    { 0,1,2,3,4,5,0,1,2,3,4,5,0,1,2,3, 4,5,0,1,2,3,4,5,0,1,2,3,4,5,0,1 },
+    { 0,1,2,3,4,5,6,0,1,2,3,4,5,6,0,1, 2,3,4,5,6,0,1,2,3,4,5,6,0,1,2,3 },
+    { 0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7, 0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7 },
+    { 0,1,2,3,4,5,6,7,8,0,1,2,3,4,5,6, 7,8,0,1,2,3,4,5,6,7,8,0,1,2,3,4 },
+    { 0,1,2,3,4,5,6,7,8,9,0,1,2,3,4,5, 6,7,8,9,0,1,2,3,4,5,6,7,8,9,0,1 },
+    { 0,1,2,3,4,5,6,7,8,9,10,0,1,2,3,4, 5,6,7,8,9,10,0,1,2,3,4,5,6,7,8,9 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,0,1,2,3, 4,5,6,7,8,9,10,11,0,1,2,3,4,5,6,7 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,12,0,1,2, 3,4,5,6,7,8,9,10,11,12,0,1,2,3,4,5 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,0,1, 2,3,4,5,6,7,8,9,10,11,12,13,0,1,2,3 },
+    { 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,0, 1,2,3,4,5,6,7,8,9,10,11,12,13,14,0,1 }
+};
+static const BYTE LZ4_dec_patternStep[16] = { 32, 32, 32, 30, 32, 30, 30, 28, 32, 27, 30, 22, 24, 26, 28, 30 };
+
+#endif /* LZ4_DEC_SIMD */
+
+#if defined(LZ4_DEC_SIMD_X86)
+
+/* Kernels are plain `static __inline` (not LZ4_FORCE_INLINE) :
+ * they can only be inlined into functions compiled for a compatible target,
+ * which is the case of the decoder instances selecting them. */
+
+/* same contract as LZ4_wildCopy32(), without overlap (offset >= 32) */
+LZ4_TARGET_AVX2 static __inline void
+LZ4_wildCopy32_avx2(BYTE* d, const BYTE* s, BYTE* e)
+{
+    do {
+        _mm256_storeu_si256((__m256i*)(void*)d, _mm256_loadu_si256((const __m256i*)(const void*)s));
+        d += 32; s += 32;
+    } while (d < e);
+}
+
+/* same contract as LZ4_memcpy_using_offset(), but can write up to 32 bytes beyond dstEnd */
+LZ4_TARGET_SSSE3 static __inline void
+LZ4_memcpy_using_offset_ssse3(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const size_t offset)
+{
+    __m128i const src = _mm_loadu_si128((const __m128i*)(const void*)srcPtr);
+    __m128i const lo = _mm_shuffle_epi8(src, _mm_loadu_si128((const __m128i*)(const void*)LZ4_dec_patternTable[offset]));
+    __m128i const hi = _mm_shuffle_epi8(src, _mm_loadu_si128((const __m128i*)(const void*)(LZ4_dec_patternTable[offset]+16)));
+    size_t const step = LZ4_dec_patternStep[offset];
+    assert(offset < 16);
+    do {
+        _mm_storeu_si128((__m128i*)(void*)dstPtr, lo);
+        _mm_storeu_si128((__m128i*)(void*)(dstPtr+16), hi);
+        dstPtr += step;
+    } while (dstPtr < dstEnd);
+}
+
+LZ4_TARGET_AVX2 static __inline void
+LZ4_memcpy_using_offset_avx2(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const size_t offset)
+{
+    __m256i const src = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(const void*)srcPtr));
+    __m256i const pattern = _mm256_shuffle_epi8(src, _mm256_loadu_si256((const __m256i*)(const void*)LZ4_dec_patternTable[offset]));
+    size_t const step = LZ4_dec_patternStep[offset];
+    assert(offset < 16);
+    do {
+        _mm256_storeu_si256((__m256i*)(void*)dstPtr, pattern);
+        dstPtr += step;
+    } while (dstPtr < dstEnd);
+}
+
+#elif defined(LZ4_DEC_SIMD_NEON)
+
+LZ4_FORCE_INLINE void
+LZ4_memcpy_using_offset_neon(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const size_t offset)
+{
+    uint8x16_t const src = vld1q_u8(srcPtr);
+    uint8x16_t const lo = vqtbl1q_u8(src, vld1q_u8(LZ4_dec_patternTable[offset]));
+    uint8x16_t const hi = vqtbl1q_u8(src, vld1q_u8(LZ4_dec_patternTable[offset]+16));
+    size_t const step = LZ4_dec_patternStep[offset];
+    assert(offset < 16);
+    do {
+        vst1q_u8(dstPtr, lo);
+        vst1q_u8(dstPtr+16, hi);
+        dstPtr += step;
+    } while (dstPtr < dstEnd);
+}
+
+#endif
+
+#if LZ4_FAST_DEC_LOOP
+
+/* The helpers below select a kernel within LZ4_decompress_generic().
+ * `kernel` is a compile-time constant, so only one branch survives in each instance.
+ * They all can overwrite up to 32 bytes beyond dstEnd. */
+
+/* literal copy : no overlap */
+LZ4_FORCE_INLINE void
+LZ4_dec_literalCopy32(BYTE* d, const BYTE* s, BYTE* e, decodeKernel_directive kernel)
+{
+#if defined(LZ4_DEC_SIMD_X86)
+    if (kernel == decodeKernel_avx2) { LZ4_wildCopy32_avx2(d, s, e); return; }
+#endif
+    (void)kernel;
+    LZ4_wildCopy32(d, s, e);
+}
+
+/* match copy : offset >= 16 */
+LZ4_FORCE_INLINE void
+LZ4_dec_matchCopy32(BYTE* d, const BYTE* s, BYTE* e, size_t offset, decodeKernel_directive kernel)
+{
+#if defined(LZ4_DEC_SIMD_X86)
+    if ((kernel == decodeKernel_avx2) && (offset >= 32)) { LZ4_wildCopy32_avx2(d, s, e); return; }
+#endif
+    (void)offset; (void)kernel;
+    LZ4_wildCopy32(d, s, e);
+}
+
+/* match copy : offset < 16 */
+LZ4_FORCE_INLINE void
+LZ4_dec_shortOffsetCopy(BYTE* dstPtr, const BYTE* srcPtr, BYTE* dstEnd, const size_t offset, decodeKernel_directive kernel)
+{
+    /* offset==0 only comes from corrupted input : decode it the same way on every kernel */
+    if (unlikely(offset == 0)) kernel = decodeKernel_portable;
+#if defined(LZ4_DEC_SIMD_X86)
+    if (kernel == decodeKernel_avx2) { LZ4_memcpy_using_offset_avx2(dstPtr, srcPtr, dstEnd, offset); return; }
+    if (kernel == decodeKernel_ssse3) { LZ4_memcpy_using_offset_ssse3(dstPtr, srcPtr, dstEnd, offset); return; }
+#elif defined(LZ4_DEC_SIMD_NEON)
+    if (kernel == decodeKernel_neon) { LZ4_memcpy_using_offset_neon(dstPtr, srcPtr, dstEnd, offset); return; }
+#endif
+    (void)kernel;
+    LZ4_memcpy_using_offset(dstPtr, srcPtr, dstEnd, offset);
+}
+
+#endif /* LZ4_FAST_DEC_LOOP */
+
+
 /*-************************************
 *  Common functions
 **************************************/
@@ -776,34 +1027,37 @@ int LZ4_decompress_safe_partial_forceExtDict(const char* source, char* dest,
 /*-******************************
 *  Compression functions
 ********************************/
-LZ4_FORCE_INLINE U32 LZ4_hash4(U32 sequence, tableType_t const tableType)
+/* hashLog : the table holds 2^hashLog 4-byte cells,
+ * which means 2^(hashLog+1) cells in byU16 mode.
+ * Within a single compression, it is a compile-time constant whenever the caller passes one */
+LZ4_FORCE_INLINE U32 LZ4_hash4(U32 sequence, tableType_t const tableType, U32 const hashLog)
 {
     if (tableType == byU16)
-        return ((sequence * 2654435761U) >> ((MINMATCH*8)-(LZ4_HASHLOG+1)));
+        return ((sequence * 2654435761U) >> ((MINMATCH*8)-(hashLog+1)));
     else
-        return ((sequence * 2654435761U) >> ((MINMATCH*8)-LZ4_HASHLOG));
+        return ((sequence * 2654435761U) >> ((MINMATCH*8)-hashLog));
 }
 
-LZ4_FORCE_INLINE U32 LZ4_hash5(U64 sequence, tableType_t const tableType)
+LZ4_FORCE_INLINE U32 LZ4_hash5(U64 sequence, tableType_t const tableType, U32 const hashLog)
 {
-    const U32 hashLog = (tableType == byU16) ? LZ4_HASHLOG+1 : LZ4_HASHLOG;
+    const U32 cellLog = (tableType == byU16) ? hashLog+1 : hashLog;
     if (LZ4_isLittleEndian()) {
         const U64 prime5bytes = 889523592379ULL;
-        return (U32)(((sequence << 24) * prime5bytes) >> (64 - hashLog));
+        return (U32)(((sequence << 24) * prime5bytes) >> (64 - cellLog));
     } else {
         const U64 prime8bytes = 11400714785074694791ULL;
-        return (U32)(((sequence >> 24) * prime8bytes) >> (64 - hashLog));
+        return (U32)(((sequence >> 24) * prime8bytes) >> (64 - cellLog));
     }
 }
 
-LZ4_FORCE_INLINE U32 LZ4_hashPosition(const void* const p, tableType_t const tableType)
+LZ4_FORCE_INLINE U32 LZ4_hashPosition(const void* const p, tableType_t const tableType, U32 const hashLog)
 {
-    if ((sizeof(reg_t)==8) && (tableType != byU16)) return LZ4_hash5(LZ4_read_ARCH(p), tableType);
+    if ((sizeof(reg_t)==8) && (tableType != byU16)) return LZ4_hash5(LZ4_read_ARCH(p), tableType, hashLog);
 
 #ifdef LZ4_STATIC_LINKING_ONLY_ENDIANNESS_INDEPENDENT_OUTPUT
-    return LZ4_hash4(LZ4_readLE32(p), tableType);
+    return LZ4_hash4(LZ4_readLE32(p), tableType, hashLog);
 #else
-    return LZ4_hash4(LZ4_read32(p), tableType);
+    return LZ4_hash4(LZ4_read32(p), tableType, hashLog);
 #endif
 }
 
@@ -840,9 +1094,9 @@ LZ4_FORCE_INLINE void LZ4_putPositionOnHash(const BYTE* p, U32 h,
     hashTable[h] = p;
 }
 
-LZ4_FORCE_INLINE void LZ4_putPosition(const BYTE* p, void* tableBase, tableType_t tableType)
+LZ4_FORCE_INLINE void LZ4_putPosition(const BYTE* p, void* tableBase, tableType_t tableType, U32 hashLog)
 {
-    U32 const h = LZ4_hashPosition(p, tableType);
+    U32 const h = LZ4_hashPosition(p, tableType, hashLog);
     LZ4_putPositionOnHash(p, h, tableBase, tableType);
 }
 
@@ -876,32 +1130,52 @@ static const BYTE* LZ4_getPositionOnHash(U32 h, const void* tableBase, tableType
 
 LZ4_FORCE_INLINE const BYTE*
 LZ4_getPosition(const BYTE* p,
-                const void* tableBase, tableType_t tableType)
+                const void* tableBase, tableType_t tableType, U32 hashLog)
 {
-    U32 const h = LZ4_hashPosition(p, tableType);
+    U32 const h = LZ4_hashPosition(p, tableType, hashLog);
     return LZ4_getPositionOnHash(h, tableBase, tableType);
 }
 
+/* LZ4_streamHashLog() :
+ * table size selected for this state, see LZ4_setStreamHashLog() */
+LZ4_FORCE_INLINE U32 LZ4_streamHashLog(const LZ4_stream_t_internal* cctx)
+{
+    return cctx->hashLog ? cctx->hashLog : LZ4_HASHLOG;
+}
+
+/* LZ4_streamTableLog() :
+ * only the first 2^tableLog cells of the table are guaranteed to hold valid indexes.
+ * LZ4_initStream() clears the whole table, one-shot compression may clear less. */
+LZ4_FORCE_INLINE U32 LZ4_streamTableLog(const LZ4_stream_t_internal* cctx)
+{
+    return cctx->tableLog ? cctx->tableLog : LZ4_HASHLOG;
+}
+
 LZ4_FORCE_INLINE void
 LZ4_prepareTable(LZ4_stream_t_internal* const cctx,
            const int inputSize,
            const tableType_t tableType) {
+    U32 const hashLog = LZ4_streamHashLog(cctx);
     /* If the table hasn't been used, it's guaranteed to be zeroed out, and is
      * therefore safe to use no matter what mode we're in. Otherwise, we figure
      * out if it's safe to leave as is or whether it needs to be reset.
+     * Either way, the cells addressed by hashLog must be valid.
      */
-    if ((tableType_t)cctx->tableType != clearedTable) {
+    if ( ((tableType_t)cctx->tableType != clearedTable)
+      || (LZ4_streamTableLog(cctx) < hashLog) ) {
         assert(inputSize >= 0);
         if ((tableType_t)cctx->tableType != tableType
           || ((tableType == byU16) && cctx->currentOffset + (unsigned)inputSize >= 0xFFFFU)
           || ((tableType == byU32) && cctx->currentOffset > 1 GB)
           || tableType == byPtr
-          || inputSize >= 4 KB)
+          || inputSize >= 4 KB
+          || LZ4_streamTableLog(cctx) < hashLog)
         {
-            DEBUGLOG(4, "LZ4_prepareTable: Resetting table in %p", (void*)cctx);
-            MEM_INIT(cctx->hashTable, 0, LZ4_HASHTABLESIZE);
+            DEBUGLOG(4, "LZ4_prepareTable: Resetting table in %p (hashLog=%u)", (void*)cctx, hashLog);
+            MEM_INIT(cctx->hashTable, 0, (size_t)4 << hashLog);
             cctx->currentOffset = 0;
             cctx->tableType = (U32)clearedTable;
+            cctx->tableLog = (U16)hashLog;
         } else {
             DEBUGLOG(4, "LZ4_prepareTable: Re-use hash table (no reset)");
         }
@@ -938,6 +1212,7 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
                  const int maxOutputSize,
                  const limitedOutput_directive outputDirective,
                  const tableType_t tableType,
+                 const U32 hashLog,
                  const dict_directive dictDirective,
                  const dictIssue_directive dictIssue,
                  const int acceleration)
@@ -978,10 +1253,11 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
     U32 offset = 0;
     U32 forwardH;
 
-    DEBUGLOG(5, "LZ4_compress_generic_validated: srcSize=%i, tableType=%u", inputSize, tableType);
+    DEBUGLOG(5, "LZ4_compress_generic_validated: srcSize=%i, tableType=%u, hashLog=%u", inputSize, tableType, hashLog);
     assert(ip != NULL);
     if (tableType == byU16) assert(inputSize<LZ4_64Klimit);  /* Size too large (not within 64K limit) */
     if (tableType == byPtr) assert(dictDirective==noDict);   /* only supported use case with byPtr */
+    assert(hashLog >= LZ4_HASHLOG_MIN && hashLog <= LZ4_streamTableLog(cctx));
     /* If init conditions are not met, we don't have to mark stream
      * as having dirty context, since no action was taken yet */
     if (outputDirective == fillOutput && maxOutputSize < 1) { return 0; } /* Impossible to store anything */
@@ -1004,13 +1280,13 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
     if (inputSize<LZ4_minLength) goto _last_literals;        /* Input too small, no compression (all literals) */
 
     /* First Byte */
-    {   U32 const h = LZ4_hashPosition(ip, tableType);
+    {   U32 const h = LZ4_hashPosition(ip, tableType, hashLog);
         if (tableType == byPtr) {
             LZ4_putPositionOnHash(ip, h, cctx->hashTable, byPtr);
         } else {
             LZ4_putIndexOnHash(startIndex, h, cctx->hashTable, tableType);
     }   }
-    ip++; forwardH = LZ4_hashPosition(ip, tableType);
+    ip++; forwardH = LZ4_hashPosition(ip, tableType, hashLog);
 
     /* Main Loop */
     for ( ; ; ) {
@@ -1033,7 +1309,7 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
                 assert(ip < mflimitPlusOne);
 
                 match = LZ4_getPositionOnHash(h, cctx->hashTable, tableType);
-                forwardH = LZ4_hashPosition(forwardIp, tableType);
+                forwardH = LZ4_hashPosition(forwardIp, tableType, hashLog);
                 LZ4_putPositionOnHash(ip, h, cctx->hashTable, tableType);
 
             } while ( (match+LZ4_DISTANCE_MAX < ip)
@@ -1083,7 +1359,7 @@ LZ4_FORCE_INLINE int LZ4_compress_generic_validated(
                 } else {   /* single continuous memory segment */
                     match = base + matchIndex;
                 }
-                forwardH = LZ4_hashPosition(forwardIp, tableType);
+                forwardH = LZ4_hashPosition(forwardIp, tableType, hashLog);
                 LZ4_putIndexOnHash(current, h, cctx->hashTable, tableType);
 
                 DEBUGLOG(7, "candidate at pos=%u  (offset=%u \n", matchIndex, current - matchIndex);
@@ -1203,7 +1479,7 @@ _next_match:
                         const BYTE* ptr;
                         DEBUGLOG(5, "Clearing %u positions", (U32)(filledIp - ip));
                         for (ptr = ip; ptr <= filledIp; ++ptr) {
-                            U32 const h = LZ4_hashPosition(ptr, tableType);
+                            U32 const h = LZ4_hashPosition(ptr, tableType, hashLog);
                             LZ4_clearHash(h, cctx->hashTable, tableType);
                         }
                     }
@@ -1235,7 +1511,7 @@ _next_match:
         if (ip >= mflimitPlusOne) break;
 
         /* Fill table */
-        {   U32 const h = LZ4_hashPosition(ip-2, tableType);
+        {   U32 const h = LZ4_hashPosition(ip-2, tableType, hashLog);
             if (tableType == byPtr) {
                 LZ4_putPositionOnHash(ip-2, h, cctx->hashTable, byPtr);
             } else {
@@ -1246,15 +1522,15 @@ _next_match:
         /* Test next position */
         if (tableType == byPtr) {
 
-            match = LZ4_getPosition(ip, cctx->hashTable, tableType);
-            LZ4_putPosition(ip, cctx->hashTable, tableType);
+            match = LZ4_getPosition(ip, cctx->hashTable, tableType, hashLog);
+            LZ4_putPosition(ip, cctx->hashTable, tableType, hashLog);
             if ( (match+LZ4_DISTANCE_MAX >= ip)
               && (LZ4_read32(match) == LZ4_read32(ip)) )
             { token=op++; *token=0; goto _next_match; }
 
         } else {   /* byU32, byU16 */
 
-            U32 const h = LZ4_hashPosition(ip, tableType);
+            U32 const h = LZ4_hashPosition(ip, tableType, hashLog);
             U32 const current = (U32)(ip-base);
             U32 matchIndex = LZ4_getIndexOnHash(h, cctx->hashTable, tableType);
             assert(matchIndex < current);
@@ -1297,7 +1573,7 @@ _next_match:
         }
 
         /* Prepare next loop */
-        forwardH = LZ4_hashPosition(++ip, tableType);
+        forwardH = LZ4_hashPosition(++ip, tableType, hashLog);
 
     }
 
@@ -1352,6 +1628,7 @@ LZ4_FORCE_INLINE int LZ4_compress_generic(
                  const int dstCapacity,
                  const limitedOutput_directive outputDirective,
                  const tableType_t tableType,
+                 const U32 hashLog,
                  const dict_directive dictDirective,
                  const dictIssue_directive dictIssue,
                  const int acceleration)
@@ -1377,33 +1654,103 @@ LZ4_FORCE_INLINE int LZ4_compress_generic(
     return LZ4_compress_generic_validated(cctx, src, dst, srcSize,
                 inputConsumed, /* only written into if outputDirective == fillOutput */
                 dstCapacity, outputDirective,
-                tableType, dictDirective, dictIssue, acceleration);
+                tableType, hashLog, dictDirective, dictIssue, acceleration);
 }
 
 
-int LZ4_compress_fast_extState(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration)
+/* LZ4_initStreamTable() :
+ * same as LZ4_initStream(), but only clears the 2^hashLog cells which are going to be used,
+ * which is much cheaper for small inputs. */
+static LZ4_stream_t_internal* LZ4_initStreamTable(void* state, U32 hashLog)
+{
+    LZ4_stream_t_internal* const ctx = &((LZ4_stream_t*)state)->internal_donotuse;
+    assert(hashLog >= LZ4_HASHLOG_MIN && hashLog <= LZ4_HASHLOG);
+    if (hashLog == LZ4_HASHLOG) return &LZ4_initStream(state, sizeof(LZ4_stream_t))->internal_donotuse;
+    MEM_INIT(ctx->hashTable, 0, (size_t)4 << hashLog);
+    ctx->dictionary = NULL;
+    ctx->dictCtx = NULL;
+    ctx->currentOffset = 0;
+    ctx->tableType = (U32)clearedTable;
+    ctx->dictSize = 0;
+    ctx->hashLog = 0;
+    ctx->tableLog = (U16)hashLog;
+    return ctx;
+}
+
+static U32 LZ4_clampHashLog(int hashLog)
+{
+    if (hashLog < LZ4_HASHLOG_MIN) return LZ4_HASHLOG_MIN;
+    if (hashLog > LZ4_HASHLOG) return LZ4_HASHLOG;
+    return (U32)hashLog;
+}
+
+int LZ4_adaptiveHashLog(int srcSize)
+{
+    /* about one cell per 2 input bytes : below that, collisions start to cost ratio */
+    int hashLog = LZ4_HASHLOG_MIN;
+    while ((hashLog < LZ4_HASHLOG) && (srcSize > (2 << hashLog))) hashLog++;
+    return hashLog;
+}
+
+LZ4_FORCE_INLINE int
+LZ4_compress_fast_extState_generic(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration, const U32 hashLog)
 {
-    LZ4_stream_t_internal* const ctx = & LZ4_initStream(state, sizeof(LZ4_stream_t)) -> internal_donotuse;
+    LZ4_stream_t_internal* const ctx = LZ4_initStreamTable(state, hashLog);
     assert(ctx != NULL);
     if (acceleration < 1) acceleration = LZ4_ACCELERATION_DEFAULT;
     if (acceleration > LZ4_ACCELERATION_MAX) acceleration = LZ4_ACCELERATION_MAX;
     if (maxOutputSize >= LZ4_compressBound(inputSize)) {
         if (inputSize < LZ4_64Klimit) {
-            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, 0, notLimited, byU16, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, 0, notLimited, byU16, hashLog, noDict, noDictIssue, acceleration);
         } else {
             const tableType_t tableType = ((sizeof(void*)==4) && ((uptrval)source > LZ4_DISTANCE_MAX)) ? byPtr : byU32;
-            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, 0, notLimited, tableType, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, 0, notLimited, tableType, hashLog, noDict, noDictIssue, acceleration);
         }
     } else {
         if (inputSize < LZ4_64Klimit) {
-            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, byU16, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, byU16, hashLog, noDict, noDictIssue, acceleration);
         } else {
             const tableType_t tableType = ((sizeof(void*)==4) && ((uptrval)source > LZ4_DISTANCE_MAX)) ? byPtr : byU32;
-            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(ctx, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, noDict, noDictIssue, acceleration);
         }
     }
 }
 
+/* Full size tables keep a constant hashLog,
+ * so that the main loop of the most common case doesn't pay for variable shifts */
+LZ4_FORCE_INLINE int
+LZ4_compress_fast_extState_selectLog(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration, U32 hashLog)
+{
+    if (hashLog == LZ4_HASHLOG)
+        return LZ4_compress_fast_extState_generic(state, source, dest, inputSize, maxOutputSize, acceleration, LZ4_HASHLOG);
+    return LZ4_compress_fast_extState_generic(state, source, dest, inputSize, maxOutputSize, acceleration, hashLog);
+}
+
+#if LZ4_CPU_DISPATCH
+/* Same compressor, compiled for AVX2+BMI2 hosts :
+ * mostly benefits from tzcnt/shlx and wider moves in the match search loop. */
+LZ4_TARGET_AVX2
+static int LZ4_compress_fast_extState_avx2(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration, U32 hashLog)
+{
+    return LZ4_compress_fast_extState_selectLog(state, source, dest, inputSize, maxOutputSize, acceleration, hashLog);
+}
+#endif
+
+int LZ4_compress_fast_extState_hashLog(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration, int hashLog)
+{
+    U32 const log = LZ4_clampHashLog((hashLog == 0) ? LZ4_adaptiveHashLog(inputSize) : hashLog);
+#if LZ4_CPU_DISPATCH
+    if (LZ4_cpuLevel() == LZ4_cpu_avx2)
+        return LZ4_compress_fast_extState_avx2(state, source, dest, inputSize, maxOutputSize, acceleration, log);
+#endif
+    return LZ4_compress_fast_extState_selectLog(state, source, dest, inputSize, maxOutputSize, acceleration, log);
+}
+
+int LZ4_compress_fast_extState(void* state, const char* source, char* dest, int inputSize, int maxOutputSize, int acceleration)
+{
+    return LZ4_compress_fast_extState_hashLog(state, source, dest, inputSize, maxOutputSize, acceleration, 0);
+}
+
 /**
  * LZ4_compress_fast_extState_fastReset() :
  * A variant of LZ4_compress_fast_extState().
@@ -1413,7 +1760,8 @@ int LZ4_compress_fast_extState(void* state, const char* source, char* dest, int
  * (see comment in lz4.h on LZ4_resetStream_fast() for a definition of
  * "correctly initialized").
  */
-int LZ4_compress_fast_extState_fastReset(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration)
+LZ4_FORCE_INLINE int
+LZ4_compress_fast_extState_fastReset_generic(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration, const U32 hashLog)
 {
     LZ4_stream_t_internal* const ctx = &((LZ4_stream_t*)state)->internal_donotuse;
     if (acceleration < 1) acceleration = LZ4_ACCELERATION_DEFAULT;
@@ -1425,33 +1773,42 @@ int LZ4_compress_fast_extState_fastReset(void* state, const char* src, char* dst
             const tableType_t tableType = byU16;
             LZ4_prepareTable(ctx, srcSize, tableType);
             if (ctx->currentOffset) {
-                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, 0, notLimited, tableType, noDict, dictSmall, acceleration);
+                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, 0, notLimited, tableType, hashLog, noDict, dictSmall, acceleration);
             } else {
-                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, 0, notLimited, tableType, noDict, noDictIssue, acceleration);
+                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, 0, notLimited, tableType, hashLog, noDict, noDictIssue, acceleration);
             }
         } else {
             const tableType_t tableType = ((sizeof(void*)==4) && ((uptrval)src > LZ4_DISTANCE_MAX)) ? byPtr : byU32;
             LZ4_prepareTable(ctx, srcSize, tableType);
-            return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, 0, notLimited, tableType, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, 0, notLimited, tableType, hashLog, noDict, noDictIssue, acceleration);
         }
     } else {
         if (srcSize < LZ4_64Klimit) {
             const tableType_t tableType = byU16;
             LZ4_prepareTable(ctx, srcSize, tableType);
             if (ctx->currentOffset) {
-                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, dstCapacity, limitedOutput, tableType, noDict, dictSmall, acceleration);
+                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, dstCapacity, limitedOutput, tableType, hashLog, noDict, dictSmall, acceleration);
             } else {
-                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, dstCapacity, limitedOutput, tableType, noDict, noDictIssue, acceleration);
+                return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, dstCapacity, limitedOutput, tableType, hashLog, noDict, noDictIssue, acceleration);
             }
         } else {
             const tableType_t tableType = ((sizeof(void*)==4) && ((uptrval)src > LZ4_DISTANCE_MAX)) ? byPtr : byU32;
             LZ4_prepareTable(ctx, srcSize, tableType);
-            return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, dstCapacity, limitedOutput, tableType, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(ctx, src, dst, srcSize, NULL, dstCapacity, limitedOutput, tableType, hashLog, noDict, noDictIssue, acceleration);
         }
     }
 }
 
 
+int LZ4_compress_fast_extState_fastReset(void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration)
+{
+    U32 const hashLog = LZ4_streamHashLog(&((LZ4_stream_t*)state)->internal_donotuse);
+    if (hashLog == LZ4_HASHLOG)
+        return LZ4_compress_fast_extState_fastReset_generic(state, src, dst, srcSize, dstCapacity, acceleration, LZ4_HASHLOG);
+    return LZ4_compress_fast_extState_fastReset_generic(state, src, dst, srcSize, dstCapacity, acceleration, hashLog);
+}
+
+
 int LZ4_compress_fast(const char* src, char* dest, int srcSize, int dstCapacity, int acceleration)
 {
     int result;
@@ -1489,10 +1846,10 @@ static int LZ4_compress_destSize_extState_internal(LZ4_stream_t* state, const ch
         return LZ4_compress_fast_extState(state, src, dst, *srcSizePtr, targetDstSize, acceleration);
     } else {
         if (*srcSizePtr < LZ4_64Klimit) {
-            return LZ4_compress_generic(&state->internal_donotuse, src, dst, *srcSizePtr, srcSizePtr, targetDstSize, fillOutput, byU16, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(&state->internal_donotuse, src, dst, *srcSizePtr, srcSizePtr, targetDstSize, fillOutput, byU16, LZ4_HASHLOG, noDict, noDictIssue, acceleration);
         } else {
             tableType_t const addrMode = ((sizeof(void*)==4) && ((uptrval)src > LZ4_DISTANCE_MAX)) ? byPtr : byU32;
-            return LZ4_compress_generic(&state->internal_donotuse, src, dst, *srcSizePtr, srcSizePtr, targetDstSize, fillOutput, addrMode, noDict, noDictIssue, acceleration);
+            return LZ4_compress_generic(&state->internal_donotuse, src, dst, *srcSizePtr, srcSizePtr, targetDstSize, fillOutput, addrMode, LZ4_HASHLOG, noDict, noDictIssue, acceleration);
     }   }
 }
 
@@ -1573,6 +1930,14 @@ void LZ4_resetStream_fast(LZ4_stream_t* ctx) {
     LZ4_prepareTable(&(ctx->internal_donotuse), 0, byU32);
 }
 
+void LZ4_setStreamHashLog(LZ4_stream_t* stream, int hashLog)
+{
+    LZ4_stream_t_internal* const ctx = &stream->internal_donotuse;
+    DEBUGLOG(5, "LZ4_setStreamHashLog (ctx:%p, hashLog:%i)", (void*)stream, hashLog);
+    ctx->hashLog = (U16)((hashLog == 0) ? 0 : LZ4_clampHashLog(hashLog));
+    LZ4_prepareTable(ctx, 0, byU32);
+}
+
 #if !defined(LZ4_STATIC_LINKING_ONLY_DISABLE_MEMORY_ALLOCATION)
 int LZ4_freeStream (LZ4_stream_t* LZ4_stream)
 {
@@ -1592,6 +1957,7 @@ int LZ4_loadDict_internal(LZ4_stream_t* LZ4_dict,
 {
     LZ4_stream_t_internal* const dict = &LZ4_dict->internal_donotuse;
     const tableType_t tableType = byU32;
+    U32 const hashLog = LZ4_streamHashLog(dict);
     const BYTE* p = (const BYTE*)dictionary;
     const BYTE* const dictEnd = p + dictSize;
     U32 idx32;
@@ -1603,6 +1969,7 @@ int LZ4_loadDict_internal(LZ4_stream_t* LZ4_dict,
      * to avoid any risk of generating overflowing matchIndex
      * when compressing using this dictionary */
     LZ4_resetStream(LZ4_dict);
+    dict->hashLog = (U16)hashLog;   /* selected table size survives */
 
     /* We always increment the offset by 64 KB, since, if the dict is longer,
      * we truncate it to the last 64k, and if it's shorter, we still want to
@@ -1623,7 +1990,7 @@ int LZ4_loadDict_internal(LZ4_stream_t* LZ4_dict,
     idx32 = dict->currentOffset - dict->dictSize;
 
     while (p <= dictEnd-HASH_UNIT) {
-        U32 const h = LZ4_hashPosition(p, tableType);
+        U32 const h = LZ4_hashPosition(p, tableType, hashLog);
         /* Note: overwriting => favors positions end of dictionary */
         LZ4_putIndexOnHash(idx32, h, dict->hashTable, tableType);
         p+=3; idx32+=3;
@@ -1634,7 +2001,7 @@ int LZ4_loadDict_internal(LZ4_stream_t* LZ4_dict,
         p = dict->dictionary;
         idx32 = dict->currentOffset - dict->dictSize;
         while (p <= dictEnd-HASH_UNIT) {
-            U32 const h = LZ4_hashPosition(p, tableType);
+            U32 const h = LZ4_hashPosition(p, tableType, hashLog);
             U32 const limit = dict->currentOffset - 64 KB;
             if (LZ4_getIndexOnHash(h, dict->hashTable, tableType) <= limit) {
                 /* Note: not overwriting => favors positions beginning of dictionary */
@@ -1706,13 +2073,13 @@ static void LZ4_renormDictT(LZ4_stream_t_internal* LZ4_dict, int nextSize)
 }
 
 
-int LZ4_compress_fast_continue (LZ4_stream_t* LZ4_stream,
-                                const char* source, char* dest,
-                                int inputSize, int maxOutputSize,
-                                int acceleration)
+LZ4_FORCE_INLINE int
+LZ4_compress_fast_continue_generic(LZ4_stream_t_internal* const streamPtr,
+                                   const char* source, char* dest,
+                                   int inputSize, int maxOutputSize,
+                                   int acceleration, const U32 hashLog)
 {
     const tableType_t tableType = byU32;
-    LZ4_stream_t_internal* const streamPtr = &LZ4_stream->internal_donotuse;
     const char* dictEnd = streamPtr->dictSize ? (const char*)streamPtr->dictionary + streamPtr->dictSize : NULL;
 
     DEBUGLOG(5, "LZ4_compress_fast_continue (inputSize=%i, dictSize=%u)", inputSize, streamPtr->dictSize);
@@ -1747,9 +2114,9 @@ int LZ4_compress_fast_continue (LZ4_stream_t* LZ4_stream,
     /* prefix mode : source data follows dictionary */
     if (dictEnd == source) {
         if ((streamPtr->dictSize < 64 KB) && (streamPtr->dictSize < streamPtr->currentOffset))
-            return LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, withPrefix64k, dictSmall, acceleration);
+            return LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, withPrefix64k, dictSmall, acceleration);
         else
-            return LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, withPrefix64k, noDictIssue, acceleration);
+            return LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, withPrefix64k, noDictIssue, acceleration);
     }
 
     /* external dictionary mode */
@@ -1767,15 +2134,15 @@ int LZ4_compress_fast_continue (LZ4_stream_t* LZ4_stream,
                  * so that the compression loop is only looking into one table.
                  */
                 LZ4_memcpy(streamPtr, streamPtr->dictCtx, sizeof(*streamPtr));
-                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, usingExtDict, noDictIssue, acceleration);
+                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, usingExtDict, noDictIssue, acceleration);
             } else {
-                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, usingDictCtx, noDictIssue, acceleration);
+                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, usingDictCtx, noDictIssue, acceleration);
             }
         } else {  /* small data <= 4 KB */
             if ((streamPtr->dictSize < 64 KB) && (streamPtr->dictSize < streamPtr->currentOffset)) {
-                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, usingExtDict, dictSmall, acceleration);
+                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, usingExtDict, dictSmall, acceleration);
             } else {
-                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, usingExtDict, noDictIssue, acceleration);
+                result = LZ4_compress_generic(streamPtr, source, dest, inputSize, NULL, maxOutputSize, limitedOutput, tableType, hashLog, usingExtDict, noDictIssue, acceleration);
             }
         }
         streamPtr->dictionary = (const BYTE*)source;
@@ -1785,18 +2152,42 @@ int LZ4_compress_fast_continue (LZ4_stream_t* LZ4_stream,
 }
 
 
+int LZ4_compress_fast_continue (LZ4_stream_t* LZ4_stream,
+                                const char* source, char* dest,
+                                int inputSize, int maxOutputSize,
+                                int acceleration)
+{
+    LZ4_stream_t_internal* const streamPtr = &LZ4_stream->internal_donotuse;
+    U32 hashLog;
+
+    /* state left by a one-shot compression with a smaller table : start a new stream */
+    if (LZ4_streamTableLog(streamPtr) < LZ4_streamHashLog(streamPtr)) LZ4_prepareTable(streamPtr, 0, byU32);
+
+    /* Tables of different sizes can't be looked up together :
+     * the working context adopts the dictionary's table, like it does for large inputs */
+    if ((streamPtr->dictCtx != NULL) && (LZ4_streamHashLog(streamPtr->dictCtx) != LZ4_streamHashLog(streamPtr)))
+        LZ4_memcpy(streamPtr, streamPtr->dictCtx, sizeof(*streamPtr));
+
+    hashLog = LZ4_streamHashLog(streamPtr);
+    if (hashLog == LZ4_HASHLOG)
+        return LZ4_compress_fast_continue_generic(streamPtr, source, dest, inputSize, maxOutputSize, acceleration, LZ4_HASHLOG);
+    return LZ4_compress_fast_continue_generic(streamPtr, source, dest, inputSize, maxOutputSize, acceleration, hashLog);
+}
+
+
 /* Hidden debug function, to force-test external dictionary mode */
 int LZ4_compress_forceExtDict (LZ4_stream_t* LZ4_dict, const char* source, char* dest, int srcSize)
 {
     LZ4_stream_t_internal* const streamPtr = &LZ4_dict->internal_donotuse;
+    U32 const hashLog = LZ4_streamHashLog(streamPtr);
     int result;
 
     LZ4_renormDictT(streamPtr, srcSize);
 
     if ((streamPtr->dictSize < 64 KB) && (streamPtr->dictSize < streamPtr->currentOffset)) {
-        result = LZ4_compress_generic(streamPtr, source, dest, srcSize, NULL, 0, notLimited, byU32, usingExtDict, dictSmall, 1);
+        result = LZ4_compress_generic(streamPtr, source, dest, srcSize, NULL, 0, notLimited, byU32, hashLog, usingExtDict, dictSmall, 1);
     } else {
-        result = LZ4_compress_generic(streamPtr, source, dest, srcSize, NULL, 0, notLimited, byU32, usingExtDict, noDictIssue, 1);
+        result = LZ4_compress_generic(streamPtr, source, dest, srcSize, NULL, 0, notLimited, byU32, hashLog, usingExtDict, noDictIssue, 1);
     }
 
     streamPtr->dictionary = (const BYTE*)source;
@@ -2032,9 +2423,11 @@ LZ4_decompress_generic(
                  dict_directive dict,                 /* noDict, withPrefix64k, usingExtDict */
                  const BYTE* const lowPrefix,  /* always <= dst, == dst when no prefix */
                  const BYTE* const dictStart,  /* only if dict==usingExtDict */
-                 const size_t dictSize         /* note : = 0 if noDict */
+                 const size_t dictSize,        /* note : = 0 if noDict */
+                 decodeKernel_directive kernel /* copy kernels of the fast loop */
                  )
 {
+    (void)kernel;   /* unused when !LZ4_FAST_DEC_LOOP */
     if ((src == NULL) || (outputSize < 0)) { return -1; }
 
     {   const BYTE* ip = (const BYTE*) src;
@@ -2104,7 +2497,7 @@ LZ4_decompress_generic(
                 /* copy literals */
                 LZ4_STATIC_ASSERT(MFLIMIT >= WILDCOPYLENGTH);
                 if ((op+length>oend-32) || (ip+length>iend-32)) { goto safe_literal_copy; }
-                LZ4_wildCopy32(op, ip, op+length);
+                LZ4_dec_literalCopy32(op, ip, op+length, kernel);
                 ip += length; op += length;
             } else if (ip <= iend-(16 + 1/*max lit + offset + nextToken*/)) {
                 /* We don't need to check oend, since we check it once for each loop below */
@@ -2202,9 +2595,9 @@ LZ4_decompress_generic(
 
             assert((op <= oend) && (oend-op >= 32));
             if (unlikely(offset<16)) {
-                LZ4_memcpy_using_offset(op, match, cpy, offset);
+                LZ4_dec_shortOffsetCopy(op, match, cpy, offset, kernel);
             } else {
-                LZ4_wildCopy32(op, match, cpy);
+                LZ4_dec_matchCopy32(op, match, cpy, offset, kernel);
             }
 
             op = cpy;   /* wildcopy correction */
@@ -2449,21 +2842,113 @@ LZ4_decompress_generic(
 
 /*===== Instantiate the API decoding functions. =====*/
 
-LZ4_FORCE_O2
+/* LZ4_DEC_DISPATCH(name, earlyEnd, dict) :
+ * Defines name(), the decoder for one set of directives.
+ * With runtime dispatch, it is compiled once per x86 kernel (name_avx2(), name_ssse3(), name_portable()),
+ * and each invocation is bound to the best kernel supported by the host cpu.
+ * All safe decoders go through one of these, so streaming and dictionary decoding
+ * (used by lz4frame, lz4ring, lz4seek) run the same kernels as LZ4_decompress_safe(). */
+#if LZ4_CPU_DISPATCH && defined(LZ4_DEC_SIMD_X86)
+
+#define LZ4_DEC_INSTANCE(name, suffix, target, earlyEnd, dict, kernel)                                 \
+    LZ4_FORCE_O2 target                                                                                \
+    static int name##_##suffix(const char* src, char* dst, int srcSize, int outputSize,                \
+                               const BYTE* lowPrefix, const BYTE* dictStart, size_t dictSize)          \
+    {                                                                                                  \
+        return LZ4_decompress_generic(src, dst, srcSize, outputSize, earlyEnd, dict,                   \
+                                      lowPrefix, dictStart, dictSize, kernel);                         \
+    }
+
+/* The target attribute lets the kernels be inlined, whatever the compilation flags. */
+#define LZ4_DEC_DISPATCH(name, earlyEnd, dict)                                                         \
+    LZ4_DEC_INSTANCE(name, avx2, LZ4_TARGET_AVX2, earlyEnd, dict, decodeKernel_avx2)                   \
+    LZ4_DEC_INSTANCE(name, ssse3, LZ4_TARGET_SSSE3, earlyEnd, dict, decodeKernel_ssse3)                \
+    LZ4_DEC_INSTANCE(name, portable, , earlyEnd, dict, decodeKernel_portable)                          \
+    static int name(const char* src, char* dst, int srcSize, int outputSize,                           \
+                    const BYTE* lowPrefix, const BYTE* dictStart, size_t dictSize)                     \
+    {                                                                                                  \
+        switch (LZ4_cpuLevel()) {                                                                      \
+        case LZ4_cpu_avx2:                                                                             \
+            return name##_avx2(src, dst, srcSize, outputSize, lowPrefix, dictStart, dictSize);         \
+        case LZ4_cpu_ssse3:                                                                            \
+            return name##_ssse3(src, dst, srcSize, outputSize, lowPrefix, dictStart, dictSize);        \
+        default:                                                                                       \
+            return name##_portable(src, dst, srcSize, outputSize, lowPrefix, dictStart, dictSize);     \
+        }                                                                                              \
+    }
+
+#else
+
+#define LZ4_DEC_DISPATCH(name, earlyEnd, dict)                                                         \
+    LZ4_FORCE_O2                                                                                       \
+    static int name(const char* src, char* dst, int srcSize, int outputSize,                           \
+                    const BYTE* lowPrefix, const BYTE* dictStart, size_t dictSize)                     \
+    {                                                                                                  \
+        return LZ4_decompress_generic(src, dst, srcSize, outputSize, earlyEnd, dict,                   \
+                                      lowPrefix, dictStart, dictSize, LZ4_DEC_KERNEL_DEFAULT);         \
+    }
+
+#endif
+
+LZ4_DEC_DISPATCH(LZ4_decode_full_noDict, decode_full_block, noDict)
+LZ4_DEC_DISPATCH(LZ4_decode_partial_noDict, partial_decode, noDict)
+LZ4_DEC_DISPATCH(LZ4_decode_full_prefix64k, decode_full_block, withPrefix64k)
+LZ4_DEC_DISPATCH(LZ4_decode_partial_prefix64k, partial_decode, withPrefix64k)
+LZ4_DEC_DISPATCH(LZ4_decode_full_extDict, decode_full_block, usingExtDict)
+LZ4_DEC_DISPATCH(LZ4_decode_partial_extDict, partial_decode, usingExtDict)
+
 int LZ4_decompress_safe(const char* source, char* dest, int compressedSize, int maxDecompressedSize)
 {
-    return LZ4_decompress_generic(source, dest, compressedSize, maxDecompressedSize,
-                                  decode_full_block, noDict,
-                                  (BYTE*)dest, NULL, 0);
+    return LZ4_decode_full_noDict(source, dest, compressedSize, maxDecompressedSize, (BYTE*)dest, NULL, 0);
+}
+
+#if LZ4_CPU_DISPATCH && defined(LZ4_DEC_SIMD_X86)
+int LZ4_decodeKernelAvailable(LZ4_decodeKernel_e kernel)
+{
+    switch (kernel) {
+    case LZ4_decodeKernel_portable: return 1;
+    case LZ4_decodeKernel_ssse3: return LZ4_cpuLevel() >= LZ4_cpu_ssse3;
+    case LZ4_decodeKernel_avx2: return LZ4_cpuLevel() == LZ4_cpu_avx2;
+    default: return 0;
+    }
+}
+
+int LZ4_decompress_safe_withKernel(const char* src, char* dst, int compressedSize, int dstCapacity,
+                                   LZ4_decodeKernel_e kernel)
+{
+    if (!LZ4_decodeKernelAvailable(kernel)) return -1;
+    switch (kernel) {
+    case LZ4_decodeKernel_avx2:
+        return LZ4_decode_full_noDict_avx2(src, dst, compressedSize, dstCapacity, (BYTE*)dst, NULL, 0);
+    case LZ4_decodeKernel_ssse3:
+        return LZ4_decode_full_noDict_ssse3(src, dst, compressedSize, dstCapacity, (BYTE*)dst, NULL, 0);
+    default:
+        return LZ4_decode_full_noDict_portable(src, dst, compressedSize, dstCapacity, (BYTE*)dst, NULL, 0);
+    }
+}
+#else
+/* Without runtime selection, only the portable kernels and the compile-time default are built */
+int LZ4_decodeKernelAvailable(LZ4_decodeKernel_e kernel)
+{
+    return (kernel == LZ4_decodeKernel_portable) || ((int)kernel == (int)LZ4_DEC_KERNEL_DEFAULT);
 }
 
 LZ4_FORCE_O2
+int LZ4_decompress_safe_withKernel(const char* src, char* dst, int compressedSize, int dstCapacity,
+                                   LZ4_decodeKernel_e kernel)
+{
+    if (!LZ4_decodeKernelAvailable(kernel)) return -1;
+    if (kernel != LZ4_decodeKernel_portable) return LZ4_decompress_safe(src, dst, compressedSize, dstCapacity);
+    return LZ4_decompress_generic(src, dst, compressedSize, dstCapacity,
+                                  decode_full_block, noDict,
+                                  (BYTE*)dst, NULL, 0, decodeKernel_portable);
+}
+#endif
+
 int LZ4_decompress_safe_partial(const char* src, char* dst, int compressedSize, int targetOutputSize, int dstCapacity)
 {
     dstCapacity = MIN(targetOutputSize, dstCapacity);
-    return LZ4_decompress_generic(src, dst, compressedSize, dstCapacity,
-                                  partial_decode,
-                                  noDict, (BYTE*)dst, NULL, 0);
+    return LZ4_decode_partial_noDict(src, dst, compressedSize, dstCapacity, (BYTE*)dst, NULL, 0);
 }
 
 LZ4_FORCE_O2
@@ -2480,18 +2965,14 @@ int LZ4_decompress_fast(const char* source, char* dest, int originalSize)
 LZ4_FORCE_O2 /* Exported, an obsolete API function. */
 int LZ4_decompress_safe_withPrefix64k(const char* source, char* dest, int compressedSize, int maxOutputSize)
 {
-    return LZ4_decompress_generic(source, dest, compressedSize, maxOutputSize,
-                                  decode_full_block, withPrefix64k,
-                                  (BYTE*)dest - 64 KB, NULL, 0);
+    return LZ4_decode_full_prefix64k(source, dest, compressedSize, maxOutputSize, (BYTE*)dest - 64 KB, NULL, 0);
 }
 
 LZ4_FORCE_O2
 static int LZ4_decompress_safe_partial_withPrefix64k(const char* source, char* dest, int compressedSize, int targetOutputSize, int dstCapacity)
 {
     dstCapacity = MIN(targetOutputSize, dstCapacity);
-    return LZ4_decompress_generic(source, dest, compressedSize, dstCapacity,
-                                  partial_decode, withPrefix64k,
-                                  (BYTE*)dest - 64 KB, NULL, 0);
+    return LZ4_decode_partial_prefix64k(source, dest, compressedSize, dstCapacity, (BYTE*)dest - 64 KB, NULL, 0);
 }
 
 /* Another obsolete API function, paired with the previous one. */
@@ -2506,9 +2987,7 @@ LZ4_FORCE_O2
 static int LZ4_decompress_safe_withSmallPrefix(const char* source, char* dest, int compressedSize, int maxOutputSize,
                                                size_t prefixSize)
 {
-    return LZ4_decompress_generic(source, dest, compressedSize, maxOutputSize,
-                                  decode_full_block, noDict,
-                                  (BYTE*)dest-prefixSize, NULL, 0);
+    return LZ4_decode_full_noDict(source, dest, compressedSize, maxOutputSize, (BYTE*)dest-prefixSize, NULL, 0);
 }
 
 LZ4_FORCE_O2
@@ -2516,9 +2995,7 @@ static int LZ4_decompress_safe_partial_withSmallPrefix(const char* source, char*
                                                size_t prefixSize)
 {
     dstCapacity = MIN(targetOutputSize, dstCapacity);
-    return LZ4_decompress_generic(source, dest, compressedSize, dstCapacity,
-                                  partial_decode, noDict,
-                                  (BYTE*)dest-prefixSize, NULL, 0);
+    return LZ4_decode_partial_noDict(source, dest, compressedSize, dstCapacity, (BYTE*)dest-prefixSize, NULL, 0);
 }
 
 LZ4_FORCE_O2
@@ -2527,9 +3004,8 @@ int LZ4_decompress_safe_forceExtDict(const char* source, char* dest,
                                      const void* dictStart, size_t dictSize)
 {
     DEBUGLOG(5, "LZ4_decompress_safe_forceExtDict");
-    return LZ4_decompress_generic(source, dest, compressedSize, maxOutputSize,
-                                  decode_full_block, usingExtDict,
-                                  (BYTE*)dest, (const BYTE*)dictStart, dictSize);
+    return LZ4_decode_full_extDict(source, dest, compressedSize, maxOutputSize,
+                                   (BYTE*)dest, (const BYTE*)dictStart, dictSize);
 }
 
 LZ4_FORCE_O2
@@ -2538,9 +3014,8 @@ int LZ4_decompress_safe_partial_forceExtDict(const char* source, char* dest,
                                      const void* dictStart, size_t dictSize)
 {
     dstCapacity = MIN(targetOutputSize, dstCapacity);
-    return LZ4_decompress_generic(source, dest, compressedSize, dstCapacity,
-                                  partial_decode, usingExtDict,
-                                  (BYTE*)dest, (const BYTE*)dictStart, dictSize);
+    return LZ4_decode_partial_extDict(source, dest, compressedSize, dstCapacity,
+                                      (BYTE*)dest, (const BYTE*)dictStart, dictSize);
 }
 
 LZ4_FORCE_O2
@@ -2560,9 +3035,8 @@ LZ4_FORCE_INLINE
 int LZ4_decompress_safe_doubleDict(const char* source, char* dest, int compressedSize, int maxOutputSize,
                                    size_t prefixSize, const void* dictStart, size_t dictSize)
 {
-    return LZ4_decompress_generic(source, dest, compressedSize, maxOutputSize,
-                                  decode_full_block, usingExtDict,
-                                  (BYTE*)dest-prefixSize, (const BYTE*)dictStart, dictSize);
+    return LZ4_decode_full_extDict(source, dest, compressedSize, maxOutputSize,
+                                   (BYTE*)dest-prefixSize, (const BYTE*)dictStart, dictSize);
 }
 
 /*===== streaming decompression functions =====*/
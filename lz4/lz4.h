@@ -612,12 +612,77 @@ LZ4_decompress_safe_partial_usingDict(const char* src, char* dst,
  */
 LZ4LIB_STATIC_API int LZ4_compress_fast_extState_fastReset (void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration);
 
+/*! Hash table size selection
+ *
+ *  The fast compressor finds matches through a hash table of 2^hashLog cells of 4 bytes.
+ *  Its capacity is fixed at compile time by LZ4_MEMORY_USAGE (hashLog == LZ4_HASHLOG),
+ *  but any smaller power of 2 down to LZ4_HASHLOG_MIN can be used at runtime.
+ *  Small tables are cheap to clear and stay in L1 cache, which matters for small inputs,
+ *  while large tables find more matches within large inputs.
+ *  To have large tables available, compile with a larger LZ4_MEMORY_USAGE :
+ *  small inputs no longer pay for it.
+ */
+#define LZ4_HASHLOG_MIN 6
+
+/*! LZ4_adaptiveHashLog() :
+ *  hashLog selected by one-shot compression functions (LZ4_compress_default(), LZ4_compress_fast_extState(), ...)
+ *  for an input of @srcSize bytes : about one cell per 2 input bytes, at most LZ4_HASHLOG.
+ */
+LZ4LIB_STATIC_API int LZ4_adaptiveHashLog(int srcSize);
+
+/*! LZ4_compress_fast_extState_hashLog() :
+ *  Same as LZ4_compress_fast_extState(), using a hash table of 2^@hashLog cells.
+ *  @hashLog is clamped within [LZ4_HASHLOG_MIN, LZ4_HASHLOG].
+ *  @hashLog == 0 means LZ4_adaptiveHashLog(srcSize), which is what LZ4_compress_fast_extState() does.
+ *  Only the part of the table in use is cleared.
+ */
+LZ4LIB_STATIC_API int LZ4_compress_fast_extState_hashLog (void* state, const char* src, char* dst, int srcSize, int dstCapacity, int acceleration, int hashLog);
+
+/*! LZ4_setStreamHashLog() :
+ *  Selects the hash table size of @streamPtr, then starts a new stream, like LZ4_resetStream_fast().
+ *  The selection applies to LZ4_compress_fast_continue(), LZ4_compress_fast_extState_fastReset()
+ *  and LZ4_loadDict(), until the state is initialized again by LZ4_initStream().
+ *  @hashLog is clamped within [LZ4_HASHLOG_MIN, LZ4_HASHLOG], 0 restores the default (LZ4_HASHLOG).
+ *  Note : a stream attached to a dictionary (LZ4_attach_dictionary()) with a different table size
+ *         adopts the dictionary's table size.
+ */
+LZ4LIB_STATIC_API void LZ4_setStreamHashLog (LZ4_stream_t* streamPtr, int hashLog);
+
 /*! LZ4_compress_destSize_extState() : introduced in v1.10.0
  *  Same as LZ4_compress_destSize(), but using an externally allocated state.
  *  Also: exposes @acceleration
  */
 int LZ4_compress_destSize_extState(void* state, const char* src, char* dst, int* srcSizePtr, int targetDstSize, int acceleration);
 
+/*! Decoding kernels
+ *
+ *  LZ4_decompress_safe() and the other safe decoders (partial, streaming, dictionary)
+ *  copy literals and matches using kernels selected for the host cpu
+ *  (see LZ4_CPU_DISPATCH and LZ4_DEC_SIMD in lz4.c).
+ *  The functions below run one given flavor instead, whatever the host cpu would select,
+ *  so that each of them can be verified and benchmarked against the others (see tests/).
+ *  All flavors produce the same result, and return the same value, for any input.
+ */
+typedef enum {
+    LZ4_decodeKernel_portable = 0,
+    LZ4_decodeKernel_ssse3,
+    LZ4_decodeKernel_avx2,
+    LZ4_decodeKernel_neon
+} LZ4_decodeKernel_e;
+
+/*! LZ4_decodeKernelAvailable() :
+ * @return : 1 if @kernel is part of this build and supported by the host cpu, 0 otherwise.
+ *  LZ4_decodeKernel_portable is always available.
+ */
+LZ4LIB_STATIC_API int LZ4_decodeKernelAvailable(LZ4_decodeKernel_e kernel);
+
+/*! LZ4_decompress_safe_withKernel() :
+ *  Same as LZ4_decompress_safe(), using the copy kernels of @kernel.
+ * @return : same as LZ4_decompress_safe(), or -1 if @kernel isn't available.
+ */
+LZ4LIB_STATIC_API int LZ4_decompress_safe_withKernel(const char* src, char* dst, int compressedSize, int dstCapacity,
+                                                     LZ4_decodeKernel_e kernel);
+
 /*! In-place compression and decompression
  *
  * It's possible to have input and output sharing the same buffer,
@@ -725,6 +790,8 @@ struct LZ4_stream_t_internal {
     LZ4_u32 currentOffset;
     LZ4_u32 tableType;
     LZ4_u32 dictSize;
+    LZ4_u16 hashLog;    /* selected table size, 0 means LZ4_HASHLOG */
+    LZ4_u16 tableLog;   /* table cells known to be valid, 0 means all of them */
     /* Implicit padding to ensure structure is aligned */
 };
 
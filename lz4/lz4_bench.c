@@ -0,0 +1,395 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define LZ4_STATIC_LINKING_ONLY   // LZ4_compress_fast_extState_hashLog()
+#include "lz4.h"
+#include "lz4hc.h"
+
+// Benchmark of LZ4_compress_fast(), LZ4_compress_HC() and LZ4_decompress_safe()
+// across input sizes, data distributions and acceleration / compression levels.
+//
+// usage : lz4_bench [-csv | -json] [-min SIZE] [-max SIZE] [-a LEVEL,LEVEL,...] [-hlog LOG,LOG,...]
+//                   [-hc LEVEL,LEVEL,...] [-t MILLISECONDS]
+//   SIZE accepts K, M and G suffixes. Defaults : 64 bytes to 256M, levels 1,4,16, 200 ms per measurement.
+//   -hlog measures each listed hash table size (2^LOG cells, clamped to LZ4_HASHLOG_MIN..LZ4_HASHLOG)
+//   on top of the adaptive selection, to trace the speed / ratio curve : e.g. -hlog 6,8,10,12.
+//   -hc also measures LZ4_compress_HC() at each listed level, e.g. -hc 2,9,12 ; these rows are tagged "hc".
+//   Each measurement starts with a warmup, then repeats timed samples until the time budget is spent.
+//   A sample groups enough calls to last ~20 µs, so that latencies of tiny inputs remain measurable.
+
+#define BENCH_SIZE_MIN_DEFAULT   64
+#define BENCH_SIZE_MAX_DEFAULT   (256U << 20)
+#define BENCH_LEVELS_MAX         16
+#define BENCH_HC_LEVELS_MAX      LZ4HC_CLEVEL_MAX
+#define BENCH_HASHLOGS_MAX       16
+#define BENCH_TIME_DEFAULT_MS    200
+#define BENCH_WARMUP_MS          50
+#define BENCH_SAMPLE_MIN_NS      20000.0
+#define BENCH_NB_SAMPLES_MIN     5
+#define BENCH_NB_SAMPLES_MAX     100000
+
+typedef enum { output_text, output_csv, output_json } output_format;
+
+typedef enum { data_random, data_text, data_zeros, data_structured, data_count } data_distribution;
+
+static const char* const distribution_names[data_count] = { "random", "text", "zeros", "structured" };
+
+typedef struct {
+    double mb_per_s;     // total bytes / total time
+    double p50_us;       // per call latencies
+    double p90_us;
+    double p99_us;
+} bench_result;
+
+typedef int (*bench_function)(const void* ctx);
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+// --- Data generation ---
+
+static unsigned long long rng_state;
+
+static unsigned rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned)(rng_state >> 32);
+}
+
+static void fill_random(char* p, size_t n) {
+    size_t i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        unsigned const r = rng_next();
+        memcpy(p + i, &r, 4);
+    }
+    for (; i < n; i++) p[i] = (char)rng_next();
+}
+
+// words drawn with a skewed distribution, like natural language
+static void fill_text(char* p, size_t n) {
+    static const char* const words[] = {
+        "the ", "of ", "and ", "to ", "in ", "a ", "is ", "that ", "for ", "it ",
+        "as ", "was ", "with ", "be ", "by ", "on ", "not ", "he ", "this ", "are ",
+        "compression ", "algorithm ", "dictionary ", "performance ", "benchmark ",
+        "throughput ", "latency ", "memory ", "buffer ", "stream ", ".\n", ", "
+    };
+    size_t const nb_words = sizeof(words) / sizeof(words[0]);
+    size_t i = 0;
+    while (i < n) {
+        unsigned const r = rng_next();
+        const char* const w = words[((r & 0xFFFF) * (r >> 16 & 0xFFFF) >> 16) % nb_words];
+        size_t len = strlen(w);
+        if (len > n - i) len = n - i;
+        memcpy(p + i, w, len);
+        i += len;
+    }
+}
+
+// fixed-layout records, with a few varying fields
+static void fill_structured(char* p, size_t n) {
+    size_t i = 0;
+    unsigned id = 0;
+    while (i < n) {
+        char record[160];
+        unsigned const r = rng_next();
+        int len = snprintf(record, sizeof(record),
+                           "{\"id\":%u,\"type\":\"%s\",\"value\":%u,\"flags\":[%u,%u],\"ts\":16%08u}\n",
+                           id++, (r & 1) ? "event" : "metric", r % 10000, r >> 28, (r >> 24) & 7, r % 100000000);
+        if ((size_t)len > n - i) len = (int)(n - i);
+        memcpy(p + i, record, (size_t)len);
+        i += (size_t)len;
+    }
+}
+
+static void fill_data(char* p, size_t n, data_distribution dist) {
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    switch (dist) {
+    case data_random:     fill_random(p, n); break;
+    case data_text:       fill_text(p, n); break;
+    case data_zeros:      memset(p, 0, n); break;
+    case data_structured: fill_structured(p, n); break;
+    default: break;
+    }
+}
+
+
+// --- Measurement ---
+
+typedef struct {
+    const char* src;
+    char* dst;
+    int src_size;
+    int dst_capacity;
+    int level;
+    int hash_log;   // 0 : adaptive, through LZ4_compress_fast()
+    int hc;         // level is a LZ4_compress_HC() level
+} call_args;
+
+static LZ4_stream_t compress_state;
+static LZ4_streamHC_t compress_state_hc;
+
+static int call_compress(const void* ctx) {
+    const call_args* const a = (const call_args*)ctx;
+    if (a->hc)
+        return LZ4_compress_HC_extStateHC(&compress_state_hc, a->src, a->dst, a->src_size, a->dst_capacity, a->level);
+    if (a->hash_log == 0)
+        return LZ4_compress_fast(a->src, a->dst, a->src_size, a->dst_capacity, a->level);
+    return LZ4_compress_fast_extState_hashLog(&compress_state, a->src, a->dst, a->src_size, a->dst_capacity,
+                                              a->level, a->hash_log);
+}
+
+static int call_decompress(const void* ctx) {
+    const call_args* const a = (const call_args*)ctx;
+    return LZ4_decompress_safe(a->src, a->dst, a->src_size, a->dst_capacity);
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double const x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, int nb, double p) {
+    int idx = (int)(p * (nb - 1) + 0.5);
+    return sorted[idx];
+}
+
+// warmup, then timed samples of `calls` invocations each, until `budget_ns` is spent
+static bench_result measure(bench_function f, const void* ctx, size_t bytes_per_call, double budget_ns,
+                            double* latencies) {
+    bench_result res;
+    double start, elapsed, total_ns = 0;
+    int calls = 1, nb_samples = 0, i;
+
+    start = now_ns();
+    do {
+        f(ctx);
+    } while (now_ns() - start < BENCH_WARMUP_MS * 1e6);
+
+    start = now_ns();
+    f(ctx);
+    elapsed = now_ns() - start;
+    if (elapsed < BENCH_SAMPLE_MIN_NS)
+        calls = (int)(BENCH_SAMPLE_MIN_NS / (elapsed > 1 ? elapsed : 1)) + 1;
+
+    while (nb_samples < BENCH_NB_SAMPLES_MAX
+           && (nb_samples < BENCH_NB_SAMPLES_MIN || total_ns < budget_ns)) {
+        start = now_ns();
+        for (i = 0; i < calls; i++) f(ctx);
+        elapsed = now_ns() - start;
+        latencies[nb_samples++] = elapsed / calls / 1000.0;
+        total_ns += elapsed;
+    }
+
+    qsort(latencies, (size_t)nb_samples, sizeof(double), compare_doubles);
+    res.mb_per_s = (double)bytes_per_call * calls * nb_samples / total_ns * 1e3;
+    res.p50_us = percentile(latencies, nb_samples, 0.50);
+    res.p90_us = percentile(latencies, nb_samples, 0.90);
+    res.p99_us = percentile(latencies, nb_samples, 0.99);
+    return res;
+}
+
+
+// --- Output ---
+
+static int first_json_row = 1;
+
+static void print_header(output_format format) {
+    switch (format) {
+    case output_csv:
+        printf("distribution,size,compressor,level,hlog,ratio,"
+               "compress_mb_s,compress_p50_us,compress_p90_us,compress_p99_us,"
+               "decompress_mb_s,decompress_p50_us,decompress_p90_us,decompress_p99_us\n");
+        break;
+    case output_json:
+        printf("[\n");
+        break;
+    default:
+        printf("%-10s %10s %5s %4s %7s | %9s %10s %10s %10s | %9s %10s %10s %10s\n",
+               "data", "size", "level", "hlog", "ratio",
+               "comp MB/s", "p50 us", "p90 us", "p99 us",
+               "dec MB/s", "p50 us", "p90 us", "p99 us");
+        break;
+    }
+}
+
+// hash_log : effective table size, "*" in text output when selected by LZ4_adaptiveHashLog()
+// hc : LZ4_compress_HC() level, "hc" prefix in text output
+static void print_row(output_format format, data_distribution dist, size_t size, int hc, int level,
+                      int hash_log, int adaptive,
+                      double ratio, const bench_result* c, const bench_result* d) {
+    char level_name[16];
+    switch (format) {
+    case output_csv:
+        printf("%s,%zu,%s,%d,%d,%.4f,%.1f,%.3f,%.3f,%.3f,%.1f,%.3f,%.3f,%.3f\n",
+               distribution_names[dist], size, hc ? "hc" : "fast", level, hash_log, ratio,
+               c->mb_per_s, c->p50_us, c->p90_us, c->p99_us,
+               d->mb_per_s, d->p50_us, d->p90_us, d->p99_us);
+        break;
+    case output_json:
+        printf("%s  {\"distribution\": \"%s\", \"size\": %zu, \"compressor\": \"%s\", \"level\": %d, \"hash_log\": %d, \"adaptive\": %s, \"ratio\": %.4f,\n"
+               "   \"compress\": {\"mb_s\": %.1f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f},\n"
+               "   \"decompress\": {\"mb_s\": %.1f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f}}",
+               first_json_row ? "" : ",\n",
+               distribution_names[dist], size, hc ? "hc" : "fast", level, hash_log, adaptive ? "true" : "false", ratio,
+               c->mb_per_s, c->p50_us, c->p90_us, c->p99_us,
+               d->mb_per_s, d->p50_us, d->p90_us, d->p99_us);
+        first_json_row = 0;
+        break;
+    default:
+        snprintf(level_name, sizeof(level_name), "%s%d", hc ? "hc" : "", level);
+        printf("%-10s %10zu %5s %2d%-2s %7.3f | %9.1f %10.3f %10.3f %10.3f | %9.1f %10.3f %10.3f %10.3f\n",
+               distribution_names[dist], size, level_name, hash_log, adaptive ? "*" : "", ratio,
+               c->mb_per_s, c->p50_us, c->p90_us, c->p99_us,
+               d->mb_per_s, d->p50_us, d->p90_us, d->p99_us);
+        break;
+    }
+    fflush(stdout);
+}
+
+static void print_footer(output_format format) {
+    if (format == output_json) printf("\n]\n");
+}
+
+
+// --- Command line ---
+
+static size_t parse_size(const char* s) {
+    char* end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (*end == 'K' || *end == 'k') v <<= 10;
+    else if (*end == 'M' || *end == 'm') v <<= 20;
+    else if (*end == 'G' || *end == 'g') v <<= 30;
+    return (size_t)v;
+}
+
+static int parse_int_list(const char* s, int* values, int nb_max) {
+    int nb = 0;
+    while (*s && nb < nb_max) {
+        char* end;
+        long const v = strtol(s, &end, 10);
+        if (end == s || v < 1) return 0;
+        values[nb++] = (int)v;
+        s = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return 0;
+    }
+    return nb;
+}
+
+static int usage(const char* name) {
+    fprintf(stderr, "usage : %s [-csv | -json] [-min SIZE] [-max SIZE] [-a LEVEL,LEVEL,...] [-hlog LOG,LOG,...]"
+                    " [-hc LEVEL,LEVEL,...] [-t MILLISECONDS]\n", name);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    output_format format = output_text;
+    size_t min_size = BENCH_SIZE_MIN_DEFAULT, max_size = BENCH_SIZE_MAX_DEFAULT, size;
+    int levels[BENCH_LEVELS_MAX] = { 1, 4, 16 };
+    int nb_levels = 3;
+    int hash_logs[BENCH_HASHLOGS_MAX + 1] = { 0 };   // 0 : adaptive, always measured first
+    int nb_hash_logs = 1;
+    int hc_levels[BENCH_HC_LEVELS_MAX];
+    int nb_hc_levels = 0;
+    double budget_ns = BENCH_TIME_DEFAULT_MS * 1e6;
+    double* latencies;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-csv")) format = output_csv;
+        else if (!strcmp(argv[i], "-json")) format = output_json;
+        else if (!strcmp(argv[i], "-min") && i + 1 < argc) min_size = parse_size(argv[++i]);
+        else if (!strcmp(argv[i], "-max") && i + 1 < argc) max_size = parse_size(argv[++i]);
+        else if (!strcmp(argv[i], "-a") && i + 1 < argc) {
+            nb_levels = parse_int_list(argv[++i], levels, BENCH_LEVELS_MAX);
+            if (nb_levels == 0) return usage(argv[0]);
+        }
+        else if (!strcmp(argv[i], "-hlog") && i + 1 < argc) {
+            nb_hash_logs = parse_int_list(argv[++i], hash_logs + 1, BENCH_HASHLOGS_MAX) + 1;
+            if (nb_hash_logs == 1) return usage(argv[0]);
+        }
+        else if (!strcmp(argv[i], "-hc") && i + 1 < argc) {
+            nb_hc_levels = parse_int_list(argv[++i], hc_levels, BENCH_HC_LEVELS_MAX);
+            if (nb_hc_levels == 0) return usage(argv[0]);
+        }
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) budget_ns = atof(argv[++i]) * 1e6;
+        else return usage(argv[0]);
+    }
+    if (min_size < 1 || max_size < min_size || max_size > LZ4_MAX_INPUT_SIZE) return usage(argv[0]);
+
+    latencies = (double*)malloc(BENCH_NB_SAMPLES_MAX * sizeof(double));
+    if (latencies == NULL) return 1;
+
+    print_header(format);
+    for (size = min_size; size <= max_size; size *= 4) {
+        int const bound = LZ4_compressBound((int)size);
+        char* const src = (char*)malloc(size);
+        char* const compressed = (char*)malloc((size_t)bound);
+        char* const regenerated = (char*)malloc(size);
+        data_distribution dist;
+        if (src == NULL || compressed == NULL || regenerated == NULL) {
+            fprintf(stderr, "not enough memory for %zu bytes inputs\n", size);
+            free(src); free(compressed); free(regenerated);
+            break;
+        }
+
+        for (dist = data_random; dist < data_count; dist++) {
+            int run;
+            fill_data(src, size, dist);
+            // fast runs first, one per (level, hash log) pair, then one per HC level
+            for (run = 0; run < nb_levels * nb_hash_logs + nb_hc_levels; run++) {
+                int const hc = run >= nb_levels * nb_hash_logs;
+                int const level = hc ? hc_levels[run - nb_levels * nb_hash_logs] : levels[run / nb_hash_logs];
+                int const hash_log = hc ? 0 : hash_logs[run % nb_hash_logs];
+                int const effective_log = hc ? LZ4HC_HASH_LOG
+                                        : (hash_log == 0) ? LZ4_adaptiveHashLog((int)size)
+                                        : (hash_log < LZ4_HASHLOG_MIN) ? LZ4_HASHLOG_MIN
+                                        : (hash_log > LZ4_HASHLOG) ? LZ4_HASHLOG : hash_log;
+                call_args c_args, d_args;
+                bench_result c_res, d_res;
+                int compressed_size, regenerated_size;
+
+                c_args.src = src;
+                c_args.dst = compressed;
+                c_args.src_size = (int)size;
+                c_args.dst_capacity = bound;
+                c_args.level = level;
+                c_args.hash_log = hash_log;
+                c_args.hc = hc;
+                c_res = measure(call_compress, &c_args, size, budget_ns, latencies);
+
+                // measure() discards results : check the final round trip
+                compressed_size = call_compress(&c_args);
+                d_args.src = compressed;
+                d_args.dst = regenerated;
+                d_args.src_size = compressed_size;
+                d_args.dst_capacity = (int)size;
+                d_args.level = 0;
+                d_args.hash_log = 0;
+                d_args.hc = 0;
+                d_res = measure(call_decompress, &d_args, size, budget_ns, latencies);
+                regenerated_size = call_decompress(&d_args);
+                if (compressed_size <= 0 || regenerated_size != (int)size || memcmp(src, regenerated, size)) {
+                    fprintf(stderr, "round trip failed : %s, %zu bytes, %slevel %d, hash log %d\n",
+                            distribution_names[dist], size, hc ? "HC " : "", level, effective_log);
+                    return 1;
+                }
+
+                print_row(format, dist, size, hc, level, effective_log, !hc && hash_log == 0,
+                          (double)size / compressed_size, &c_res, &d_res);
+            }
+        }
+        free(src);
+        free(compressed);
+        free(regenerated);
+        if (size > max_size / 4) break;   // avoid overflow
+    }
+    print_footer(format);
+    free(latencies);
+    return 0;
+}
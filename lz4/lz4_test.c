@@ -1,12 +1,1103 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#define LZ4_STATIC_LINKING_ONLY   // hash table size selection
 #include "lz4.h"
+#include "lz4mt.h"
+#include "lz4hc.h"
+#include "lz4frame.h"
+#include "lz4batch.h"
+#include "lz4dict.h"
+#include "lz4ring.h"
+#include "lz4page.h"
+#include "lz4seek.h"
+#include "lz4arena.h"
+#include "xxhash.h"
 #include "random_data.h"  // Contains 1MB data array as in previous example
 
 #define COMPRESSED_BUFFER_SIZE (RANDOM_DATA_SIZE + (RANDOM_DATA_SIZE / 255) + 16)
+#define PARALLEL_BLOCK_SIZE (LZ4MT_BLOCKSIZE_MIN * 2)
+#define PARALLEL_NB_BLOCKS ((RANDOM_DATA_SIZE + PARALLEL_BLOCK_SIZE - 1) / PARALLEL_BLOCK_SIZE)
+#define PARALLEL_BUFFER_SIZE (COMPRESSED_BUFFER_SIZE + LZ4MT_HEADER_SIZE + PARALLEL_NB_BLOCKS * 20)
+#define FRAME_CHUNK_SIZE 100000
+#define BATCH_DICT_SIZE (64 * 1024)
+#define BATCH_NB_MESSAGES 200
+#define TRAIN_NB_PHRASES 512
+#define TRAIN_NB_SAMPLES 400
+#define TRAIN_NB_TESTS 100
+#define TRAIN_DICT_SIZE (16 * 1024)
+#define RING_BLOCK_SIZE (64 * 1024)
+#define PAGE_SIZE 4096
+#define PAGE_MAX_PAGES (PARALLEL_BUFFER_SIZE / PAGE_SIZE)
+#define SEEK_BLOCK_SIZE (64 * 1024)
+#define ARENA_BUFFER_SIZE (512 * 1024)
+#define ARENA_BLOCK_SIZE (16 * 1024)
+#define ARENA_NB_BLOCKS 8
+#define HASHLOG_BLOCK_SIZE 4096
+#define HASHLOG_NB_BLOCKS 16
+#ifndef MMAP_TOOL
+#  define MMAP_TOOL "./lz4mmap"   // built by the Makefile along with this test
+#endif
 
 static unsigned char compressed_data[COMPRESSED_BUFFER_SIZE];
 static unsigned char decompressed_data[RANDOM_DATA_SIZE];
+static unsigned char parallel_data[PARALLEL_BUFFER_SIZE];
+static unsigned char pattern_data[RANDOM_DATA_SIZE];
+static long long arena_buffer[ARENA_BUFFER_SIZE / sizeof(long long)];   // 8-byte aligned
+
+// Counting allocator : glibc lets a program replace malloc() and co., the originals remaining
+// reachable as __libc_*. Not possible under AddressSanitizer, which replaces them too.
+#if defined(__SANITIZE_ADDRESS__)
+#  define COUNT_ALLOCATIONS 0
+#elif defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#    define COUNT_ALLOCATIONS 0
+#  endif
+#endif
+#if !defined(COUNT_ALLOCATIONS) && defined(__GLIBC__)
+#  define COUNT_ALLOCATIONS 1
+#endif
+#if !defined(COUNT_ALLOCATIONS)
+#  define COUNT_ALLOCATIONS 0
+#endif
+
+static int allocation_count;
+
+#if COUNT_ALLOCATIONS
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+void* malloc(size_t size) { allocation_count++; return __libc_malloc(size); }
+void* calloc(size_t nmemb, size_t size) { allocation_count++; return __libc_calloc(nmemb, size); }
+void* realloc(void* ptr, size_t size) { allocation_count++; return __libc_realloc(ptr, size); }
+void free(void* ptr) { __libc_free(ptr); }
+#endif
+
+static unsigned read_le32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+// Low-entropy text : random_data may be incompressible, so ratios are compared on this input
+#define TEXT_DATA_SIZE (256 * 1024)
+static char text_data[TEXT_DATA_SIZE];
+
+static void generate_text(void) {
+    static const char* const words[] = { "alpha ", "beta ", "gamma ", "delta ", "epsilon ",
+                                         "zeta ", "eta ", "theta ", "iota ", "kappa " };
+    unsigned seed = 12345;
+    int pos = 0;
+    while (pos < TEXT_DATA_SIZE) {
+        seed = seed * 1103515245u + 12345u;
+        const char* w = words[(seed >> 16) % 10];
+        while (*w && pos < TEXT_DATA_SIZE) text_data[pos++] = *w++;
+    }
+}
+
+// Text over a vocabulary of 4096 words, closer to natural language than the 10 words above :
+// with so few distinct words, short hash chains saturate and level ordering depends on the strategy
+static char vocabulary_text[TEXT_DATA_SIZE];
+static void generate_vocabulary_text(void) {
+    static const char* const syllables[] = { "ka", "to", "ri", "ne", "su", "mo", "la", "pe",
+                                             "di", "vu", "sha", "ter", "on", "al", "ex", "qui" };
+    static char vocabulary[4096][16];
+    unsigned seed = 99;
+    int pos = 0;
+    for (int v = 0; v < 4096; v++) {
+        seed = seed * 1103515245u + 12345u;
+        int nb_syllables = 1 + (seed >> 16) % 3;
+        vocabulary[v][0] = 0;
+        for (int k = 0; k < nb_syllables; k++) {
+            seed = seed * 1103515245u + 12345u;
+            strcat(vocabulary[v], syllables[(seed >> 16) % 16]);
+        }
+        strcat(vocabulary[v], " ");
+    }
+    while (pos < TEXT_DATA_SIZE) {
+        seed = seed * 1103515245u + 12345u;
+        const char* w = vocabulary[((seed >> 8) & 0xFFFFFF) % 4096];
+        while (*w && pos < TEXT_DATA_SIZE) vocabulary_text[pos++] = *w++;
+        if (((seed >> 4) & 15) == 0 && pos < TEXT_DATA_SIZE) vocabulary_text[pos++] = '\n';
+    }
+}
+
+// Compress and decompress the container with the worker pool
+static int test_parallel(void) {
+    int parallel_size = LZ4_compress_parallel((const char*)random_data,
+                                              (char*)parallel_data,
+                                              RANDOM_DATA_SIZE,
+                                              PARALLEL_BUFFER_SIZE,
+                                              1, PARALLEL_BLOCK_SIZE, 0);
+    if (parallel_size <= 0) {
+        printf("Parallel compression failed\n");
+        return 1;
+    }
+    printf("Parallel compressed size: %d bytes (%d blocks)\n", parallel_size, PARALLEL_NB_BLOCKS);
+
+    // Decompress, blocks are spread across the worker pool
+    memset(decompressed_data, 0, RANDOM_DATA_SIZE);
+    int content_size = LZ4_decompress_parallel((const char*)parallel_data,
+                                               (char*)decompressed_data,
+                                               parallel_size, RANDOM_DATA_SIZE, 0);
+    if (content_size < 0) {
+        printf("Parallel decompression failed\n");
+        return 1;
+    }
+
+    if (content_size == RANDOM_DATA_SIZE &&
+        memcmp(random_data, decompressed_data, RANDOM_DATA_SIZE) == 0) {
+        printf("Parallel verification PASSED\n");
+    } else {
+        printf("Parallel verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Linked blocks are primed with the previous block's tail : on text, they must beat independent ones
+static int test_parallel_linked(void) {
+    generate_text();
+    int independent_size = LZ4_compress_parallel(text_data, (char*)parallel_data,
+                                                 TEXT_DATA_SIZE, PARALLEL_BUFFER_SIZE,
+                                                 1, PARALLEL_BLOCK_SIZE, 0);
+    int linked_size = LZ4_compress_parallel_linked(text_data, (char*)parallel_data,
+                                                   TEXT_DATA_SIZE, PARALLEL_BUFFER_SIZE,
+                                                   1, PARALLEL_BLOCK_SIZE, 0);
+    if (independent_size <= 0 || linked_size <= 0) {
+        printf("Linked parallel compression failed\n");
+        return 1;
+    }
+    printf("Linked parallel compressed size: %d bytes (independent blocks: %d bytes)\n",
+           linked_size, independent_size);
+
+    // blocks after the first reference the previous one, decoded as a dictionary
+    memset(decompressed_data, 0, TEXT_DATA_SIZE);
+    int content_size = LZ4_decompress_parallel((const char*)parallel_data, (char*)decompressed_data,
+                                               linked_size, RANDOM_DATA_SIZE, 0);
+    if (linked_size < independent_size && content_size == TEXT_DATA_SIZE &&
+        memcmp(text_data, decompressed_data, TEXT_DATA_SIZE) == 0) {
+        printf("Linked parallel verification PASSED\n");
+    } else {
+        printf("Linked parallel verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Compress at default HC level, the output is a regular LZ4 block
+static int test_hc(void) {
+    int hc_size = LZ4_compress_HC((const char*)random_data,
+                                  (char*)compressed_data,
+                                  RANDOM_DATA_SIZE,
+                                  COMPRESSED_BUFFER_SIZE,
+                                  LZ4HC_CLEVEL_DEFAULT);
+    if (hc_size <= 0) {
+        printf("HC compression failed\n");
+        return 1;
+    }
+    printf("HC compressed size: %d bytes (%.2f%%)\n", hc_size,
+           (hc_size * 100.0) / RANDOM_DATA_SIZE);
+
+    memset(decompressed_data, 0, RANDOM_DATA_SIZE);
+    int decompressed_size = LZ4_decompress_safe((const char*)compressed_data,
+                                                (char*)decompressed_data,
+                                                hc_size,
+                                                RANDOM_DATA_SIZE);
+    if (decompressed_size < 0) {
+        printf("HC decompression failed\n");
+        return 1;
+    }
+
+    if (decompressed_size == RANDOM_DATA_SIZE &&
+        memcmp(random_data, decompressed_data, RANDOM_DATA_SIZE) == 0) {
+        printf("HC verification PASSED\n");
+    } else {
+        printf("HC verification FAILED\n");
+        return 1;
+    }
+
+    // On compressible text, each level must round-trip and compress at least as well as the one below,
+    // and the optimal parser levels must beat the fast compressor
+    int errors = 0;
+    int previous_size = 0;
+    generate_vocabulary_text();
+    int fast_size = LZ4_compress_default(vocabulary_text, (char*)compressed_data,
+                                         TEXT_DATA_SIZE, COMPRESSED_BUFFER_SIZE);
+    printf("HC text sizes (fast: %d):", fast_size);
+    for (int level = LZ4HC_CLEVEL_MIN; level <= LZ4HC_CLEVEL_MAX; level++) {
+        int level_size = LZ4_compress_HC(vocabulary_text, (char*)compressed_data,
+                                         TEXT_DATA_SIZE, COMPRESSED_BUFFER_SIZE, level);
+        printf(" %d", level_size);
+        memset(decompressed_data, 0, TEXT_DATA_SIZE);
+        decompressed_size = LZ4_decompress_safe((const char*)compressed_data, (char*)decompressed_data,
+                                                level_size, TEXT_DATA_SIZE);
+        if (level_size <= 0 || decompressed_size != TEXT_DATA_SIZE ||
+            memcmp(vocabulary_text, decompressed_data, TEXT_DATA_SIZE) != 0)
+            errors++;
+        if (previous_size > 0 && level_size > previous_size)
+            errors++;
+        if (level >= LZ4HC_CLEVEL_OPT_MIN && (fast_size <= 0 || level_size >= fast_size))
+            errors++;
+        previous_size = level_size;
+    }
+    printf("\n");
+
+    if (errors == 0) {
+        printf("HC levels verification PASSED\n");
+    } else {
+        printf("HC levels verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Double fast level : between fast and hash chain ratios, and never beyond a short output buffer
+static int test_hc_double_fast(void) {
+    int errors = 0;
+    int mid_size = LZ4_compress_HC((const char*)random_data, (char*)compressed_data,
+                                   RANDOM_DATA_SIZE, COMPRESSED_BUFFER_SIZE, LZ4HC_CLEVEL_MIN);
+    printf("Double fast compressed size: %d bytes (%.2f%%)\n", mid_size,
+           (mid_size * 100.0) / RANDOM_DATA_SIZE);
+    int decompressed_size = LZ4_decompress_safe((const char*)compressed_data, (char*)decompressed_data,
+                                                mid_size, RANDOM_DATA_SIZE);
+    int short_size = LZ4_compress_HC((const char*)random_data, (char*)parallel_data,
+                                     RANDOM_DATA_SIZE, mid_size - 1, LZ4HC_CLEVEL_MIN);
+    if (mid_size <= 0 || mid_size > LZ4_compressBound(RANDOM_DATA_SIZE) || short_size != 0 ||
+        decompressed_size != RANDOM_DATA_SIZE ||
+        memcmp(random_data, decompressed_data, RANDOM_DATA_SIZE) != 0)
+        errors++;
+
+    generate_text();
+    int text_fast = LZ4_compress_default(text_data, (char*)compressed_data,
+                                         TEXT_DATA_SIZE, COMPRESSED_BUFFER_SIZE);
+    int text_mid = LZ4_compress_HC(text_data, (char*)compressed_data,
+                                   TEXT_DATA_SIZE, COMPRESSED_BUFFER_SIZE, LZ4HC_CLEVEL_MIN);
+    decompressed_size = LZ4_decompress_safe((const char*)compressed_data, (char*)decompressed_data,
+                                            text_mid, TEXT_DATA_SIZE);
+    printf("Double fast text size: %d bytes (fast: %d bytes)\n", text_mid, text_fast);
+    if (text_mid <= 0 || text_fast <= 0 || text_mid >= text_fast ||
+        decompressed_size != TEXT_DATA_SIZE ||
+        memcmp(text_data, decompressed_data, TEXT_DATA_SIZE) != 0)
+        errors++;
+
+    if (errors == 0) {
+        printf("Double fast verification PASSED\n");
+    } else {
+        printf("Double fast verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Stream a linked, checksummed frame in chunks, then decode it through a small output window
+static int test_frame(void) {
+    LZ4F_preferences_t prefs = LZ4F_INIT_PREFERENCES;
+    LZ4F_cctx* cctx;
+    LZ4F_dctx* dctx;
+    size_t frame_size, pos, in_pos, out_pos;
+    size_t ret = 1;
+
+    prefs.frameInfo.blockMode = LZ4F_blockLinked;
+    prefs.frameInfo.blockChecksumFlag = LZ4F_blockChecksumEnabled;
+    prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+    if (LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION))) {
+        printf("Frame context creation failed\n");
+        return 1;
+    }
+    frame_size = LZ4F_compressBegin(cctx, compressed_data, COMPRESSED_BUFFER_SIZE, &prefs);
+    for (pos = 0; !LZ4F_isError(frame_size) && pos < RANDOM_DATA_SIZE; pos += FRAME_CHUNK_SIZE) {
+        size_t chunk = RANDOM_DATA_SIZE - pos < FRAME_CHUNK_SIZE ? RANDOM_DATA_SIZE - pos : FRAME_CHUNK_SIZE;
+        ret = LZ4F_compressUpdate(cctx, compressed_data + frame_size, COMPRESSED_BUFFER_SIZE - frame_size,
+                                  random_data + pos, chunk, NULL);
+        frame_size = LZ4F_isError(ret) ? ret : frame_size + ret;
+    }
+    if (!LZ4F_isError(frame_size)) {
+        ret = LZ4F_compressEnd(cctx, compressed_data + frame_size, COMPRESSED_BUFFER_SIZE - frame_size, NULL);
+        frame_size = LZ4F_isError(ret) ? ret : frame_size + ret;
+    }
+    LZ4F_freeCompressionContext(cctx);
+    if (LZ4F_isError(frame_size)) {
+        printf("Frame compression failed: %s\n", LZ4F_getErrorName(frame_size));
+        return 1;
+    }
+    printf("Frame compressed size: %zu bytes (%.2f%%)\n", frame_size,
+           (frame_size * 100.0) / RANDOM_DATA_SIZE);
+
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) {
+        printf("Frame context creation failed\n");
+        return 1;
+    }
+    memset(decompressed_data, 0, RANDOM_DATA_SIZE);
+    in_pos = out_pos = 0;
+    while (ret != 0 && !LZ4F_isError(ret)) {
+        size_t src_size = frame_size - in_pos;
+        size_t dst_size = RANDOM_DATA_SIZE - out_pos < 4096 ? RANDOM_DATA_SIZE - out_pos : 4096;
+        ret = LZ4F_decompress(dctx, decompressed_data + out_pos, &dst_size,
+                              compressed_data + in_pos, &src_size, NULL);
+        if (src_size == 0 && dst_size == 0 && ret != 0) break;   // no progress : truncated frame
+        in_pos += src_size;
+        out_pos += dst_size;
+    }
+    LZ4F_freeDecompressionContext(dctx);
+    if (ret != 0) {
+        printf("Frame decompression failed: %s\n", LZ4F_getErrorName(ret));
+        return 1;
+    }
+
+    if (in_pos == frame_size && out_pos == RANDOM_DATA_SIZE &&
+        memcmp(random_data, decompressed_data, RANDOM_DATA_SIZE) == 0) {
+        printf("Frame verification PASSED\n");
+    } else {
+        printf("Frame verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Noise followed by regular data : noise blocks are stored after a probe, regular blocks compressed again
+static int test_frame_incompressible(void) {
+    LZ4F_preferences_t prefs = LZ4F_INIT_PREFERENCES;
+    LZ4F_dctx* dctx;
+    unsigned int state = 2463534242u;
+    size_t pos, src_size, dst_size, ret;
+
+    for (pos = 0; pos < RANDOM_DATA_SIZE / 2; pos++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        pattern_data[pos] = (unsigned char)(state >> 24);
+    }
+    memcpy(pattern_data + RANDOM_DATA_SIZE / 2, random_data, RANDOM_DATA_SIZE / 2);
+
+    prefs.frameInfo.blockMode = LZ4F_blockLinked;
+    prefs.frameInfo.blockSizeID = LZ4F_max64KB;
+    prefs.skipIncompressible = 1;
+    size_t frame_size = LZ4F_compressFrame(parallel_data, PARALLEL_BUFFER_SIZE,
+                                           pattern_data, RANDOM_DATA_SIZE, &prefs);
+    if (LZ4F_isError(frame_size)) {
+        printf("Incompressible frame compression failed: %s\n", LZ4F_getErrorName(frame_size));
+        return 1;
+    }
+
+    // Every block is noise : each must be stored (high bit of its size set),
+    // so the frame is the input plus the frame header, block headers and end mark
+    size_t const nb_blocks = (RANDOM_DATA_SIZE + (64 << 10) - 1) / (64 << 10);
+    size_t nb_found = 0, nb_stored = 0;
+    pos = LZ4F_headerSize(parallel_data, frame_size);
+    while (!LZ4F_isError(pos) && pos + LZ4F_BLOCK_HEADER_SIZE <= frame_size) {
+        unsigned const block_header = read_le32(parallel_data + pos);
+        pos += LZ4F_BLOCK_HEADER_SIZE;
+        if (block_header == 0) break;   // end mark
+        nb_found++;
+        nb_stored += block_header >> 31;
+        pos += block_header & 0x7FFFFFFFU;
+    }
+    printf("Incompressible frame size: %zu bytes (%.2f%%), %zu of %zu blocks stored\n", frame_size,
+           (frame_size * 100.0) / RANDOM_DATA_SIZE, nb_stored, nb_found);
+    if (LZ4F_isError(pos) || pos != frame_size || nb_found != nb_blocks || nb_stored != nb_blocks ||
+        frame_size > RANDOM_DATA_SIZE + LZ4F_HEADER_SIZE_MAX + (nb_blocks + 1) * LZ4F_BLOCK_HEADER_SIZE) {
+        printf("Incompressible frame verification FAILED\n");
+        return 1;
+    }
+
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) {
+        printf("Frame context creation failed\n");
+        return 1;
+    }
+    src_size = frame_size;
+    dst_size = RANDOM_DATA_SIZE;
+    ret = LZ4F_decompress(dctx, decompressed_data, &dst_size, parallel_data, &src_size, NULL);
+    LZ4F_freeDecompressionContext(dctx);
+
+    if (ret == 0 && src_size == frame_size && dst_size == RANDOM_DATA_SIZE &&
+        memcmp(pattern_data, decompressed_data, RANDOM_DATA_SIZE) == 0) {
+        printf("Incompressible frame verification PASSED\n");
+    } else {
+        printf("Incompressible frame verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Streaming hashes use the scalar stripe loop, so they also check the SIMD one when XXH_VECTOR selects it
+static int test_xxhash(void) {
+    XXH32_state_t state32;
+    XXH64_state_t state64;
+    size_t pos;
+
+    XXH32_reset(&state32, 0);
+    XXH64_reset(&state64, 0);
+    for (pos = 0; pos < RANDOM_DATA_SIZE; pos += 1000) {
+        size_t chunk = RANDOM_DATA_SIZE - pos < 1000 ? RANDOM_DATA_SIZE - pos : 1000;
+        XXH32_update(&state32, random_data + pos, chunk);
+        XXH64_update(&state64, random_data + pos, chunk);
+    }
+
+    if (XXH32_digest(&state32) == XXH32(random_data, RANDOM_DATA_SIZE, 0) &&
+        XXH64_digest(&state64) == XXH64(random_data, RANDOM_DATA_SIZE, 0)) {
+        printf("xxHash verification PASSED (%s)\n", XXH_vectorName());
+    } else {
+        printf("xxHash verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Repeated patterns of period 1..15 exercise the overlapping match copies of the decoder
+static int test_short_offsets(void) {
+    size_t pos = 0;
+    unsigned period = 1;
+    while (pos < RANDOM_DATA_SIZE) {
+        size_t run = 100 + (random_data[pos] % 200);
+        size_t i;
+        for (i = 0; i < run && pos < RANDOM_DATA_SIZE; i++, pos++)
+            pattern_data[pos] = (i < period) ? random_data[pos] : pattern_data[pos - period];
+        period = period % 15 + 1;
+    }
+
+    int compressed_size = LZ4_compress_default((const char*)pattern_data,
+                                               (char*)compressed_data,
+                                               RANDOM_DATA_SIZE,
+                                               COMPRESSED_BUFFER_SIZE);
+    int decompressed_size = LZ4_decompress_safe((const char*)compressed_data,
+                                                (char*)decompressed_data,
+                                                compressed_size,
+                                                RANDOM_DATA_SIZE);
+    if (decompressed_size == RANDOM_DATA_SIZE &&
+        memcmp(pattern_data, decompressed_data, RANDOM_DATA_SIZE) == 0) {
+        printf("Short offsets verification PASSED\n");
+    } else {
+        printf("Short offsets verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Small messages sharing content with a dictionary taken from the start of the data :
+// the dictionary must make the batch smaller than the same messages compressed without it
+static int test_batch(void) {
+    const char* srcs[BATCH_NB_MESSAGES];
+    int sizes[BATCH_NB_MESSAGES];
+    int offsets[BATCH_NB_MESSAGES + 1];
+    int dst_offsets[BATCH_NB_MESSAGES + 1];
+    const unsigned char* fresh = random_data + RANDOM_DATA_SIZE / 2;
+    int total = 0;
+    int n;
+
+    // Each message is made of 64-byte slices of the dictionary, separated by 8 bytes found nowhere else
+    for (n = 0; n < BATCH_NB_MESSAGES; n++) {
+        int const size = 200 + (random_data[n] * 8);   // 200 .. 2240 bytes
+        int pos = 0;
+        while (pos < size) {
+            int slice = 0;
+            memcpy(&slice, fresh, sizeof(slice));
+            slice = (int)((unsigned)slice % (BATCH_DICT_SIZE - 64));
+            int len = size - pos < 64 ? size - pos : 64;
+            memcpy(pattern_data + total + pos, random_data + slice, (size_t)len);
+            pos += len;
+            len = size - pos < 8 ? size - pos : 8;
+            memcpy(pattern_data + total + pos, fresh, (size_t)len);
+            pos += len;
+            fresh += 8;
+        }
+        srcs[n] = (const char*)pattern_data + total;
+        sizes[n] = size;
+        total += size;
+    }
+
+    LZ4_stream_t* dict_stream = LZ4_createStream();
+    LZ4_loadDict(dict_stream, (const char*)random_data, BATCH_DICT_SIZE);
+    int compressed_size = LZ4_compress_batch(dict_stream, srcs, sizes, BATCH_NB_MESSAGES,
+                                             (char*)compressed_data, COMPRESSED_BUFFER_SIZE,
+                                             offsets, 1);
+    LZ4_freeStream(dict_stream);
+    int nodict_size = LZ4_compress_batch(NULL, srcs, sizes, BATCH_NB_MESSAGES,
+                                         (char*)parallel_data, PARALLEL_BUFFER_SIZE,
+                                         dst_offsets, 1);
+    if (compressed_size <= 0 || nodict_size <= 0) {
+        printf("Batch compression failed\n");
+        return 1;
+    }
+    printf("Batch compressed size: %d bytes (%.2f%%), without dictionary: %d bytes\n", compressed_size,
+           (compressed_size * 100.0) / total, nodict_size);
+
+    int decompressed_size = LZ4_decompress_batch((const char*)compressed_data, offsets, BATCH_NB_MESSAGES,
+                                                 (char*)decompressed_data, RANDOM_DATA_SIZE, dst_offsets,
+                                                 (const char*)random_data, BATCH_DICT_SIZE);
+    if (decompressed_size == total && compressed_size < nodict_size &&
+        memcmp(pattern_data, decompressed_data, total) == 0) {
+        printf("Batch verification PASSED\n");
+    } else {
+        printf("Batch verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Records made of phrases drawn from a skewed vocabulary, each followed by a number :
+// frequent content is spread across all samples, more than any sample window holds
+static int generate_records(int* sizes, int nb_records) {
+    static char phrases[TRAIN_NB_PHRASES][48];
+    int lengths[TRAIN_NB_PHRASES];
+    unsigned seed = 2654435761u;
+    int pos = 0;
+    int n, k;
+
+    for (n = 0; n < TRAIN_NB_PHRASES; n++) {
+        seed = seed * 1103515245u + 12345u;
+        lengths[n] = 16 + (int)((seed >> 16) % 32);
+        for (k = 0; k < lengths[n]; k++) {
+            seed = seed * 1103515245u + 12345u;
+            phrases[n][k] = (char)('a' + (seed >> 16) % 26);
+        }
+    }
+    for (n = 0; n < nb_records; n++) {
+        int const start = pos;
+        seed = seed * 1103515245u + 12345u;
+        int const nb_fields = 8 + (int)((seed >> 16) % 8);
+        for (k = 0; k < nb_fields; k++) {
+            unsigned a, b;
+            seed = seed * 1103515245u + 12345u;
+            a = (seed >> 16) % TRAIN_NB_PHRASES;
+            seed = seed * 1103515245u + 12345u;
+            b = (seed >> 16) % TRAIN_NB_PHRASES;
+            int const phrase = (int)(a * b / TRAIN_NB_PHRASES);   // low indexes are the most frequent
+            memcpy(pattern_data + pos, phrases[phrase], (size_t)lengths[phrase]);
+            pos += lengths[phrase];
+            seed = seed * 1103515245u + 12345u;
+            pos += sprintf((char*)pattern_data + pos, "%u;", (seed >> 16) % 1000);
+        }
+        sizes[n] = pos - start;
+    }
+    return pos;
+}
+
+// Compresses each record independently, with `dict` (may be empty).
+// @return : total compressed size, or -1 if a record doesn't decode back
+static int compress_records(const char* records, const int* sizes, int nb_records,
+                            const char* dict, int dict_size) {
+    LZ4_stream_t* stream = LZ4_createStream();
+    int total = 0;
+    int n;
+
+    for (n = 0; n < nb_records; n++) {
+        LZ4_resetStream_fast(stream);
+        LZ4_loadDict(stream, dict, dict_size);
+        int c_size = LZ4_compress_fast_continue(stream, records, (char*)compressed_data,
+                                                sizes[n], COMPRESSED_BUFFER_SIZE, 1);
+        int d_size = LZ4_decompress_safe_usingDict((const char*)compressed_data, (char*)decompressed_data,
+                                                   c_size, RANDOM_DATA_SIZE, dict, dict_size);
+        if (c_size <= 0 || d_size != sizes[n] || memcmp(records, decompressed_data, sizes[n]) != 0) {
+            total = -1;
+            break;
+        }
+        total += c_size;
+        records += sizes[n];
+    }
+    LZ4_freeStream(stream);
+    return total;
+}
+
+// Trains on the first records, then compresses later ones : the trained dictionary must beat
+// no dictionary at all, and a dictionary made of the last bytes of the training records
+static int test_dict_trainer(void) {
+    static char dict[TRAIN_DICT_SIZE];
+    int sizes[TRAIN_NB_SAMPLES + TRAIN_NB_TESTS];
+    int n, train_size = 0;
+
+    generate_records(sizes, TRAIN_NB_SAMPLES + TRAIN_NB_TESTS);
+    for (n = 0; n < TRAIN_NB_SAMPLES; n++) train_size += sizes[n];
+    int dict_size = LZ4_trainDictionary(dict, TRAIN_DICT_SIZE,
+                                        (const char*)pattern_data, sizes, TRAIN_NB_SAMPLES);
+    if (dict_size <= 0) {
+        printf("Dictionary training failed\n");
+        return 1;
+    }
+
+    const char* tests = (const char*)pattern_data + train_size;
+    int no_dict = compress_records(tests, sizes + TRAIN_NB_SAMPLES, TRAIN_NB_TESTS, NULL, 0);
+    int tail_dict = compress_records(tests, sizes + TRAIN_NB_SAMPLES, TRAIN_NB_TESTS,
+                                     (const char*)pattern_data + train_size - dict_size, dict_size);
+    int trained = compress_records(tests, sizes + TRAIN_NB_SAMPLES, TRAIN_NB_TESTS, dict, dict_size);
+    printf("Trained dictionary: %d bytes, records compressed to %d bytes (raw tail: %d, no dictionary: %d)\n",
+           dict_size, trained, tail_dict, no_dict);
+
+    if (no_dict > 0 && tail_dict > 0 && trained > 0 && trained < tail_dict && trained < no_dict) {
+        printf("Dictionary verification PASSED\n");
+    } else {
+        printf("Dictionary verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Linked blocks of text, each behind its 4-byte size, fed to the ring decoder in chunks that ignore block boundaries :
+// single bytes and partial headers go through the staging area, large chunks decode whole blocks in place,
+// and the output is larger than the ring, so later blocks reference history across its wrap
+static int test_ring_decoder(void) {
+    static const int block_sizes[] = { RING_BLOCK_SIZE, 1000, 20000, 4096, 50000, 17 };
+    static const int chunk_sizes[] = { 1, 7, 1000, 3, 100000, 333, 40000, 2 };
+    LZ4_stream_t* stream = LZ4_createStream();
+    int compressed_size = 0;
+    int pos, n;
+
+    generate_text();
+    for (pos = 0, n = 0; pos < TEXT_DATA_SIZE; pos += block_sizes[n], n = (n + 1) % 6) {
+        int block_size = (TEXT_DATA_SIZE - pos < block_sizes[n]) ? TEXT_DATA_SIZE - pos : block_sizes[n];
+        int c_size = LZ4_compress_fast_continue(stream, text_data + pos,
+                                                (char*)parallel_data + compressed_size + LZ4RING_BLOCKHEADER_SIZE,
+                                                block_size,
+                                                PARALLEL_BUFFER_SIZE - compressed_size - LZ4RING_BLOCKHEADER_SIZE, 1);
+        if (c_size <= 0) {
+            LZ4_freeStream(stream);
+            printf("Ring block compression failed\n");
+            return 1;
+        }
+        parallel_data[compressed_size] = (unsigned char)c_size;
+        parallel_data[compressed_size + 1] = (unsigned char)(c_size >> 8);
+        parallel_data[compressed_size + 2] = (unsigned char)(c_size >> 16);
+        parallel_data[compressed_size + 3] = (unsigned char)(c_size >> 24);
+        compressed_size += LZ4RING_BLOCKHEADER_SIZE + c_size;
+    }
+    LZ4_freeStream(stream);
+    printf("Ring stream size: %d bytes (%.2f%%)\n", compressed_size,
+           (compressed_size * 100.0) / TEXT_DATA_SIZE);
+
+    LZ4_ringDecoder* decoder = LZ4_createRingDecoder(RING_BLOCK_SIZE);
+    int decompressed_size = 0;
+    int in_pos = 0;
+    for (n = 0; in_pos < compressed_size; n = (n + 1) % 8) {
+        int chunk_end = in_pos + chunk_sizes[n] < compressed_size ? in_pos + chunk_sizes[n] : compressed_size;
+        while (in_pos < chunk_end) {
+            const char* block;
+            int block_size;
+            int consumed = LZ4_ringDecoder_decode(decoder, (const char*)parallel_data + in_pos,
+                                                  chunk_end - in_pos, &block, &block_size);
+            if (consumed < 0 || decompressed_size + block_size > TEXT_DATA_SIZE) {
+                LZ4_freeRingDecoder(decoder);
+                printf("Ring decoding failed\n");
+                return 1;
+            }
+            if (block_size > 0) {
+                memcpy(decompressed_data + decompressed_size, block, block_size);
+                decompressed_size += block_size;
+            }
+            in_pos += consumed;
+        }
+    }
+    LZ4_freeRingDecoder(decoder);
+
+    if (decompressed_size == TEXT_DATA_SIZE &&
+        memcmp(text_data, decompressed_data, TEXT_DATA_SIZE) == 0) {
+        printf("Ring decoder verification PASSED\n");
+    } else {
+        printf("Ring decoder verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Packs `src` into 4 KB pages, then reads it back one page at a time through the index.
+// @return : nb of pages stored compressed, or -1 on error
+static int check_pages(const char* name, const unsigned char* src, int src_size) {
+    int page_offsets[PAGE_MAX_PAGES + 1];
+    int page_index[PAGE_MAX_PAGES + 1];
+    int nb_pages = LZ4_compress_pages((const char*)src, src_size, (char*)parallel_data,
+                                      PAGE_MAX_PAGES, PAGE_SIZE, page_offsets, 1);
+    int offset, page, nb_compressed = 0;
+
+    if (nb_pages <= 0) return -1;
+    for (page = 0; page < nb_pages; page++) {
+        if ((parallel_data[(size_t)page * PAGE_SIZE + 3] & 0x80) == 0) nb_compressed++;   // raw flag : header bit 31
+    }
+    printf("Packed %d bytes of %s into %d pages of %d bytes (%.2f%%), %d compressed\n", src_size, name,
+           nb_pages, PAGE_SIZE, (nb_pages * PAGE_SIZE * 100.0) / src_size, nb_compressed);
+
+    for (offset = 0; offset < src_size; offset += 7777) {
+        page = LZ4_findPage(page_offsets, nb_pages, offset);
+        if (page < 0) return -1;
+        int page_start = page_offsets[page];
+        int decoded = LZ4_decompress_page((const char*)parallel_data + (size_t)page * PAGE_SIZE, PAGE_SIZE,
+                                          (char*)decompressed_data, RANDOM_DATA_SIZE);
+        if (decoded != page_offsets[page + 1] - page_start || offset - page_start >= decoded ||
+            memcmp(src + page_start, decompressed_data, decoded) != 0) {
+            return -1;
+        }
+    }
+    if (page_offsets[nb_pages] != src_size || LZ4_findPage(page_offsets, nb_pages, src_size) != -1) return -1;
+
+    // the direct index must agree with the binary search, on both sides of every page boundary
+    if (LZ4_pageBound(src_size, PAGE_SIZE) > PAGE_MAX_PAGES + 1 ||
+        LZ4_buildPageIndex(page_offsets, nb_pages, PAGE_SIZE, page_index) != LZ4_pageBound(src_size, PAGE_SIZE))
+        return -1;
+    for (page = 0; page < nb_pages; page++) {
+        for (offset = page_offsets[page] - 1; offset <= page_offsets[page] + 1; offset++) {
+            if (LZ4_findPage_usingIndex(page_offsets, nb_pages, page_index, PAGE_SIZE, offset) !=
+                LZ4_findPage(page_offsets, nb_pages, offset))
+                return -1;
+        }
+    }
+    for (offset = 0; offset < src_size; offset += 777) {
+        if (LZ4_findPage_usingIndex(page_offsets, nb_pages, page_index, PAGE_SIZE, offset) !=
+            LZ4_findPage(page_offsets, nb_pages, offset))
+            return -1;
+    }
+    if (LZ4_findPage_usingIndex(page_offsets, nb_pages, page_index, PAGE_SIZE, src_size) != -1) return -1;
+    return nb_compressed;
+}
+
+// Half of the random data, stored in raw pages, then text, which must fill compressed pages
+static int test_pages(void) {
+    int raw = check_pages("random data", random_data, RANDOM_DATA_SIZE / 2);
+    generate_text();
+    int compressed = check_pages("text", (const unsigned char*)text_data, TEXT_DATA_SIZE);
+
+    if (raw >= 0 && compressed > 0) {
+        printf("Page verification PASSED\n");
+    } else {
+        printf("Page verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Ranges read back from a seekable container of text : the start of a block (partial decoding),
+// within a block (scratch buffer), whole blocks (straight into dst), across blocks, and past the end
+static int test_seekable(void) {
+    static const unsigned long long offsets[] = { 0, 100000, SEEK_BLOCK_SIZE - 10, SEEK_BLOCK_SIZE,
+                                                  2 * SEEK_BLOCK_SIZE + 12345, TEXT_DATA_SIZE - 1000 };
+    static const int lengths[] = { 4096, 4096, 20, 2 * SEEK_BLOCK_SIZE + 1, 777, 4096 };
+    generate_text();
+    size_t container_size = LZ4_compress_seekable(text_data, TEXT_DATA_SIZE, parallel_data,
+                                                  PARALLEL_BUFFER_SIZE, SEEK_BLOCK_SIZE, 1);
+    if (container_size == 0) {
+        printf("Seekable compression failed\n");
+        return 1;
+    }
+
+    // block table : stored sizes, the highest bit flagging raw blocks
+    const unsigned char* footer = parallel_data + container_size - LZ4SEEK_FOOTER_SIZE;
+    unsigned nb_blocks = read_le32(footer + 4);
+    unsigned nb_compressed = 0;
+    unsigned n;
+    for (n = 0; n < nb_blocks; n++) {
+        if ((read_le32(footer - 4 * (size_t)(nb_blocks - n)) & 0x80000000U) == 0) nb_compressed++;
+    }
+    printf("Seekable container size: %zu bytes (%.2f%%), %u of %u blocks compressed\n", container_size,
+           (container_size * 100.0) / TEXT_DATA_SIZE, nb_compressed, nb_blocks);
+
+    LZ4_seekReader* reader = LZ4_createSeekReader(parallel_data, container_size);
+    if (reader == NULL) {
+        printf("Seekable container rejected\n");
+        return 1;
+    }
+    int errors = nb_compressed == 0;
+    size_t i;
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        int expected = TEXT_DATA_SIZE - offsets[i] < (unsigned long long)lengths[i] ?
+                       (int)(TEXT_DATA_SIZE - offsets[i]) : lengths[i];
+        memset(decompressed_data, 0, (size_t)expected);
+        int decoded = LZ4_decompress_seekable_range(reader, decompressed_data, RANDOM_DATA_SIZE,
+                                                    offsets[i], lengths[i]);
+        if (decoded != expected || memcmp(text_data + offsets[i], decompressed_data, expected) != 0)
+            errors++;
+    }
+    if (LZ4_decompress_seekable_range(reader, decompressed_data, RANDOM_DATA_SIZE, TEXT_DATA_SIZE + 1, 1) >= 0)
+        errors++;
+    LZ4_freeSeekReader(reader);
+
+    if (errors == 0) {
+        printf("Seekable verification PASSED\n");
+    } else {
+        printf("Seekable verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Forged and corrupted footers must be rejected when the reader is created
+static void write_le32(unsigned char* p, unsigned v) {
+    p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); p[2] = (unsigned char)(v >> 16); p[3] = (unsigned char)(v >> 24);
+}
+
+static int test_seekable_footer(void) {
+    unsigned char forged[LZ4SEEK_FOOTER_SIZE];
+    int errors = 0;
+    // no blocks, but a content size that overflows (size + blockSize - 1)
+    write_le32(forged, SEEK_BLOCK_SIZE);
+    write_le32(forged + 4, 0);
+    write_le32(forged + 8, 0xFFFFFFFFU);
+    write_le32(forged + 12, 0xFFFFFFFFU);
+    write_le32(forged + 16, LZ4SEEK_MAGICNUMBER);
+    LZ4_seekReader* reader = LZ4_createSeekReader(forged, sizeof(forged));
+    if (reader != NULL) {
+        errors++;
+        LZ4_freeSeekReader(reader);
+    }
+
+    generate_text();
+    size_t container_size = LZ4_compress_seekable(text_data, TEXT_DATA_SIZE, parallel_data,
+                                                  PARALLEL_BUFFER_SIZE, SEEK_BLOCK_SIZE, 1);
+    if (container_size == 0) {
+        printf("Seekable compression failed\n");
+        return 1;
+    }
+    // the untouched container is accepted
+    reader = LZ4_createSeekReader(parallel_data, container_size);
+    if (reader == NULL) errors++;
+    LZ4_freeSeekReader(reader);
+    // each mutation changes the number of blocks implied by the footer, or the magic number
+    static const int fields[] = { 0, 4, 8, 12, 16 };
+    static const unsigned deltas[] = { SEEK_BLOCK_SIZE, 1, SEEK_BLOCK_SIZE, 1, 1 };
+    unsigned char* footer = (unsigned char*)parallel_data + container_size - LZ4SEEK_FOOTER_SIZE;
+    size_t i;
+    for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        unsigned char saved[4];
+        unsigned char* field = footer + fields[i];
+        memcpy(saved, field, 4);
+        write_le32(field, read_le32(field) + deltas[i]);
+        reader = LZ4_createSeekReader(parallel_data, container_size);
+        if (reader != NULL) {
+            errors++;
+            LZ4_freeSeekReader(reader);
+        }
+        memcpy(field, saved, 4);
+    }
+    reader = LZ4_createSeekReader(parallel_data, container_size - 1);
+    if (reader != NULL) {
+        errors++;
+        LZ4_freeSeekReader(reader);
+    }
+
+    if (errors == 0) {
+        printf("Seekable footer verification PASSED\n");
+    } else {
+        printf("Seekable footer verification FAILED\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Block round trips through arenas without and with dictionary, HC and streaming, without a single allocation ;
+// buffers smaller than LZ4_sizeofArena() are rejected
+static int test_arena(void) {
+    int compressed_sizes[ARENA_NB_BLOCKS];
+    const char* src = (const char*)random_data + RANDOM_DATA_SIZE / 2;
+    int errors = 0;
+    int pos = 0;
+    int n;
+
+    size_t const arena_size = LZ4_sizeofArena(BATCH_DICT_SIZE, 1);
+    if (arena_size > ARENA_BUFFER_SIZE) {
+        printf("Arena buffer too small\n");
+        return 1;
+    }
+    // a buffer one byte short of LZ4_sizeofArena() is rejected
+    if (LZ4_initArena(arena_buffer, arena_size - 1, BATCH_DICT_SIZE, 1) != NULL ||
+        LZ4_initArena(arena_buffer, LZ4_sizeofArena(0, 0) - 1, 0, 0) != NULL)
+        errors++;
+
+    allocation_count = 0;
+
+    // without dictionary : blocks are compressed from a fast reset state, and decoded on their own
+    LZ4_arena* arena = LZ4_initArena(arena_buffer, LZ4_sizeofArena(0, 0), 0, 0);
+    if (arena == NULL) {
+        printf("Arena initialization failed\n");
+        return 1;
+    }
+    if (LZ4_arena_loadDict(arena, (const char*)random_data, BATCH_DICT_SIZE) >= 0 ||
+        LZ4_arena_compressHC(arena, src, (char*)compressed_data, ARENA_BLOCK_SIZE,
+                             COMPRESSED_BUFFER_SIZE, LZ4HC_CLEVEL_DEFAULT) != 0)
+        errors++;
+    for (n = 0; n < 2; n++) {
+        int const block_size = LZ4_arena_compress(arena, src + n * ARENA_BLOCK_SIZE, (char*)compressed_data,
+                                                  ARENA_BLOCK_SIZE, COMPRESSED_BUFFER_SIZE, 1);
+        memset(decompressed_data, 0, ARENA_BLOCK_SIZE);
+        if (block_size <= 0 ||
+            LZ4_arena_decompress(arena, (const char*)compressed_data, (char*)decompressed_data,
+                                 block_size, RANDOM_DATA_SIZE) != ARENA_BLOCK_SIZE ||
+            memcmp(src + n * ARENA_BLOCK_SIZE, decompressed_data, ARENA_BLOCK_SIZE) != 0)
+            errors++;
+    }
+
+    // with dictionary and HC, in the same buffer
+    arena = LZ4_initArena(arena_buffer, ARENA_BUFFER_SIZE, BATCH_DICT_SIZE, 1);
+    if (arena == NULL) {
+        printf("Arena initialization failed\n");
+        return 1;
+    }
+    LZ4_arena_loadDict(arena, (const char*)random_data, BATCH_DICT_SIZE);
+    int compressed_size = LZ4_arena_compress(arena, src, (char*)compressed_data,
+                                             ARENA_BLOCK_SIZE, COMPRESSED_BUFFER_SIZE, 1);
+    if (LZ4_arena_decompress(arena, (const char*)compressed_data, (char*)decompressed_data,
+                             compressed_size, RANDOM_DATA_SIZE) != ARENA_BLOCK_SIZE ||
+        memcmp(src, decompressed_data, ARENA_BLOCK_SIZE) != 0)
+        errors++;
+    compressed_size = LZ4_arena_compressHC(arena, src, (char*)compressed_data,
+                                           ARENA_BLOCK_SIZE, COMPRESSED_BUFFER_SIZE, LZ4HC_CLEVEL_MAX);
+    if (LZ4_decompress_safe((const char*)compressed_data, (char*)decompressed_data,
+                            compressed_size, RANDOM_DATA_SIZE) != ARENA_BLOCK_SIZE ||
+        memcmp(src, decompressed_data, ARENA_BLOCK_SIZE) != 0)
+        errors++;
+
+    LZ4_stream_t* stream = LZ4_arena_startStream(arena);
+    for (n = 0; n < ARENA_NB_BLOCKS; n++) {
+        compressed_sizes[n] = LZ4_compress_fast_continue(stream, src + n * ARENA_BLOCK_SIZE,
+                                                         (char*)compressed_data + pos, ARENA_BLOCK_SIZE,
+                                                         COMPRESSED_BUFFER_SIZE - pos, 1);
+        pos += compressed_sizes[n];
+    }
+    LZ4_streamDecode_t* stream_decode = LZ4_arena_startStreamDecode(arena);
+    pos = 0;
+    for (n = 0; n < ARENA_NB_BLOCKS; n++) {
+        if (LZ4_decompress_safe_continue(stream_decode, (const char*)compressed_data + pos,
+                                         (char*)decompressed_data + n * ARENA_BLOCK_SIZE,
+                                         compressed_sizes[n], ARENA_BLOCK_SIZE) != ARENA_BLOCK_SIZE)
+            errors++;
+        pos += compressed_sizes[n];
+    }
+    if (memcmp(src, decompressed_data, ARENA_NB_BLOCKS * ARENA_BLOCK_SIZE) != 0) errors++;
+    int allocations = allocation_count;
+
+    if (errors == 0 && allocations == 0) {
+        printf("Arena verification PASSED (%s)\n", COUNT_ALLOCATIONS ? "no allocation" : "allocations not counted");
+    } else {
+        printf("Arena verification FAILED (%d errors, %d allocations)\n", errors, allocations);
+        return 1;
+    }
+    return 0;
+}
+
+// Every table size on tiny to large inputs, then streams using a small table, with and without dictionary
+static int test_hash_log(void) {
+    static const int sizes[] = { 20, 300, 5000, 100000 };
+    static LZ4_stream_t state, dict_stream;
+    const char* src = (const char*)random_data;
+    int compressed_sizes[HASHLOG_NB_BLOCKS];
+    int errors = 0;
+    int pos = 0;
+    size_t s;
+    int n;
+
+    if (LZ4_adaptiveHashLog(sizes[0]) >= LZ4_adaptiveHashLog(RANDOM_DATA_SIZE) ||
+        LZ4_adaptiveHashLog(RANDOM_DATA_SIZE) != LZ4_HASHLOG)
+        errors++;
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int hash_log;
+        for (hash_log = 0; hash_log <= LZ4_HASHLOG + 1; hash_log++) {   // 0 : adaptive ; out of range : clamped
+            int compressed_size = LZ4_compress_fast_extState_hashLog(&state, src, (char*)compressed_data, sizes[s],
+                                                                     COMPRESSED_BUFFER_SIZE, 1, hash_log);
+            if (LZ4_decompress_safe((const char*)compressed_data, (char*)decompressed_data,
+                                    compressed_size, RANDOM_DATA_SIZE) != sizes[s] ||
+                memcmp(src, decompressed_data, (size_t)sizes[s]) != 0)
+                errors++;
+        }
+    }
+
+    // Streams started right after a one-shot compression which only cleared a 2^LZ4_HASHLOG_MIN table :
+    // with a 2^8 table selected by LZ4_setStreamHashLog(), then with the default table,
+    // which LZ4_compress_fast_continue() must reset before using it
+    for (s = 0; s < 2; s++) {
+        int const stream_hash_log = (s == 0) ? 8 : 0;
+        LZ4_compress_fast_extState_hashLog(&state, src, (char*)compressed_data, sizes[0],
+                                           COMPRESSED_BUFFER_SIZE, 1, LZ4_HASHLOG_MIN);
+        if (stream_hash_log) LZ4_setStreamHashLog(&state, stream_hash_log);
+        pos = 0;
+        for (n = 0; n < HASHLOG_NB_BLOCKS; n++) {
+            compressed_sizes[n] = LZ4_compress_fast_continue(&state, src + n * HASHLOG_BLOCK_SIZE,
+                                                             (char*)compressed_data + pos, HASHLOG_BLOCK_SIZE,
+                                                             COMPRESSED_BUFFER_SIZE - pos, 1);
+            pos += compressed_sizes[n];
+        }
+        LZ4_streamDecode_t stream_decode;
+        LZ4_setStreamDecode(&stream_decode, NULL, 0);
+        memset(decompressed_data, 0, HASHLOG_NB_BLOCKS * HASHLOG_BLOCK_SIZE);
+        pos = 0;
+        for (n = 0; n < HASHLOG_NB_BLOCKS; n++) {
+            if (compressed_sizes[n] <= 0 ||
+                LZ4_decompress_safe_continue(&stream_decode, (const char*)compressed_data + pos,
+                                             (char*)decompressed_data + n * HASHLOG_BLOCK_SIZE,
+                                             compressed_sizes[n], HASHLOG_BLOCK_SIZE) != HASHLOG_BLOCK_SIZE)
+                errors++;
+            pos += compressed_sizes[n];
+        }
+        if (memcmp(src, decompressed_data, HASHLOG_NB_BLOCKS * HASHLOG_BLOCK_SIZE) != 0) errors++;
+    }
+
+    // a full size dictionary attached to a small table stream
+    LZ4_initStream(&dict_stream, sizeof(dict_stream));
+    LZ4_loadDict(&dict_stream, src, BATCH_DICT_SIZE);
+    LZ4_setStreamHashLog(&state, 8);
+    LZ4_attach_dictionary(&state, &dict_stream);
+    int compressed_size = LZ4_compress_fast_continue(&state, src + BATCH_DICT_SIZE, (char*)compressed_data,
+                                                     HASHLOG_BLOCK_SIZE, COMPRESSED_BUFFER_SIZE, 1);
+    if (LZ4_decompress_safe_usingDict((const char*)compressed_data, (char*)decompressed_data, compressed_size,
+                                      RANDOM_DATA_SIZE, src, BATCH_DICT_SIZE) != HASHLOG_BLOCK_SIZE ||
+        memcmp(src + BATCH_DICT_SIZE, decompressed_data, HASHLOG_BLOCK_SIZE) != 0)
+        errors++;
+
+    if (errors == 0) {
+        printf("Hash table sizes verification PASSED\n");
+    } else {
+        printf("Hash table sizes verification FAILED (%d errors)\n", errors);
+        return 1;
+    }
+    return 0;
+}
+
+// Files compressed and decompressed by the lz4mmap tool, through mapped input and output :
+// an empty file, a size which isn't a multiple of the page size, and a size which is
+static int test_mmap(void) {
+    static const size_t sizes[] = { 0, 3 * PAGE_SIZE + 123, RANDOM_DATA_SIZE };
+    char dir[] = "/tmp/lz4_test_XXXXXX";
+    char original[64], compressed[64], regenerated[64], command[512];
+    int errors = 0;
+    size_t s;
+
+    if (mkdtemp(dir) == NULL) {
+        printf("Memory-mapped files verification FAILED (no temporary directory)\n");
+        return 1;
+    }
+    snprintf(original, sizeof(original), "%s/original", dir);
+    snprintf(compressed, sizeof(compressed), "%s/original.lz4", dir);
+    snprintf(regenerated, sizeof(regenerated), "%s/regenerated", dir);
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        FILE* f = fopen(original, "wb");
+        size_t read_size = 0;
+        if (f == NULL || fwrite(random_data, 1, sizes[s], f) != sizes[s]) errors++;
+        if (f != NULL && fclose(f) != 0) errors++;
+
+        // 64 KB linked blocks, so that the larger files span several blocks
+        snprintf(command, sizeof(command), "%s -B 4 %s %s && %s -d %s %s",
+                 MMAP_TOOL, original, compressed, MMAP_TOOL, compressed, regenerated);
+        if (system(command) != 0) errors++;
+
+        f = fopen(regenerated, "rb");
+        if (f != NULL) {
+            memset(decompressed_data, 0, RANDOM_DATA_SIZE);
+            read_size = fread(decompressed_data, 1, RANDOM_DATA_SIZE, f);
+            fclose(f);
+        }
+        if (f == NULL || read_size != sizes[s] || memcmp(random_data, decompressed_data, sizes[s]) != 0)
+            errors++;
+        unlink(original);
+        unlink(compressed);
+        unlink(regenerated);
+    }
+    rmdir(dir);
+
+    if (errors == 0) {
+        printf("Memory-mapped files verification PASSED\n");
+    } else {
+        printf("Memory-mapped files verification FAILED (%d errors, tool: %s)\n", errors, MMAP_TOOL);
+        return 1;
+    }
+    return 0;
+}
 
 int main(void) {
     printf("Original size: %d bytes\n", RANDOM_DATA_SIZE);
@@ -46,6 +1137,22 @@ int main(void) {
         printf("Verification FAILED\n");
     }
 
-    return 0;
+    if (test_parallel() != 0) return 1;
+    if (test_parallel_linked() != 0) return 1;
+    if (test_hc() != 0) return 1;
+    if (test_hc_double_fast() != 0) return 1;
+    if (test_frame() != 0) return 1;
+    if (test_frame_incompressible() != 0) return 1;
+    if (test_short_offsets() != 0) return 1;
+    if (test_batch() != 0) return 1;
+    if (test_dict_trainer() != 0) return 1;
+    if (test_ring_decoder() != 0) return 1;
+    if (test_pages() != 0) return 1;
+    if (test_seekable() != 0) return 1;
+    if (test_seekable_footer() != 0) return 1;
+    if (test_arena() != 0) return 1;
+    if (test_hash_log() != 0) return 1;
+    if (test_mmap() != 0) return 1;
+    return test_xxhash();
 }
 
@@ -0,0 +1,175 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Caller-provided state arena
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <string.h>     /* memcpy */
+#define LZ4_STATIC_LINKING_ONLY   /* LZ4_compress_fast_extState_fastReset */
+#include "lz4arena.h"
+#include "lz4hc.h"
+
+
+/*-************************************
+*  Arena layout
+**************************************/
+/* Each part starts on its own cache line, so that states don't share lines with each other. */
+#define LZ4ARENA_PART_ALIGN 64
+#define LZ4ARENA_ROUND(s)   (((s) + LZ4ARENA_PART_ALIGN - 1) & ~(size_t)(LZ4ARENA_PART_ALIGN - 1))
+#define LZ4ARENA_DICT_MAX   (64 << 10)
+
+struct LZ4_arena_s {
+    LZ4_stream_t* stream;               /* working compression state */
+    LZ4_stream_t* dictStream;           /* hashed dictionary, referenced by `stream` ; NULL without dictionary capacity */
+    LZ4_streamDecode_t* streamDecode;
+    LZ4_streamHC_t* streamHC;           /* NULL without HC */
+    void* workspaceHC;                  /* optimal parser table, NULL without HC */
+    char* dict;                         /* dictionary content */
+    int dictCapacity;
+    int dictSize;
+};
+
+size_t LZ4_sizeofArena(int dictCapacity, int withHC)
+{
+    size_t size;
+    if (dictCapacity < 0 || dictCapacity > LZ4ARENA_DICT_MAX) return 0;
+    size = LZ4ARENA_ROUND(sizeof(struct LZ4_arena_s))
+         + LZ4ARENA_ROUND(sizeof(LZ4_stream_t))
+         + LZ4ARENA_ROUND(sizeof(LZ4_streamDecode_t));
+    if (dictCapacity > 0)
+        size += LZ4ARENA_ROUND(sizeof(LZ4_stream_t)) + LZ4ARENA_ROUND((size_t)dictCapacity);
+    if (withHC)
+        size += LZ4ARENA_ROUND(sizeof(LZ4_streamHC_t)) + LZ4ARENA_ROUND((size_t)LZ4_sizeofWorkspaceHC());
+    return size;
+}
+
+/* LZ4ARENA_carve() :
+ * @return : the next `size` bytes of the arena, keeping the cache line alignment relative to its start */
+static void* LZ4ARENA_carve(char** ptr, size_t size)
+{
+    void* const part = *ptr;
+    *ptr += LZ4ARENA_ROUND(size);
+    return part;
+}
+
+LZ4_arena* LZ4_initArena(void* buffer, size_t size, int dictCapacity, int withHC)
+{
+    size_t const required = LZ4_sizeofArena(dictCapacity, withHC);
+    char* ptr = (char*)buffer;
+    LZ4_arena* arena;
+
+    if (buffer == NULL || required == 0 || size < required) return NULL;
+    if (((size_t)buffer & (LZ4ARENA_ALIGNMENT - 1)) != 0) return NULL;
+
+    arena = (LZ4_arena*)LZ4ARENA_carve(&ptr, sizeof(*arena));
+    arena->stream = LZ4_initStream(LZ4ARENA_carve(&ptr, sizeof(LZ4_stream_t)), sizeof(LZ4_stream_t));
+    arena->streamDecode = (LZ4_streamDecode_t*)LZ4ARENA_carve(&ptr, sizeof(LZ4_streamDecode_t));
+    LZ4_setStreamDecode(arena->streamDecode, NULL, 0);
+    arena->dictStream = NULL;
+    arena->dict = NULL;
+    arena->dictCapacity = dictCapacity;
+    arena->dictSize = 0;
+    if (dictCapacity > 0) {
+        arena->dictStream = LZ4_initStream(LZ4ARENA_carve(&ptr, sizeof(LZ4_stream_t)), sizeof(LZ4_stream_t));
+        arena->dict = (char*)LZ4ARENA_carve(&ptr, (size_t)dictCapacity);
+    }
+    arena->streamHC = NULL;
+    arena->workspaceHC = NULL;
+    if (withHC) {
+        arena->streamHC = LZ4_initStreamHC(LZ4ARENA_carve(&ptr, sizeof(LZ4_streamHC_t)), sizeof(LZ4_streamHC_t));
+        arena->workspaceHC = LZ4ARENA_carve(&ptr, (size_t)LZ4_sizeofWorkspaceHC());
+    }
+    if (arena->stream == NULL || (dictCapacity > 0 && arena->dictStream == NULL)
+      || (withHC && arena->streamHC == NULL)) return NULL;
+    return arena;
+}
+
+
+/*-************************************
+*  Dictionary
+**************************************/
+int LZ4_arena_loadDict(LZ4_arena* arena, const char* dict, int dictSize)
+{
+    if (arena->dictStream == NULL || dictSize < 0 || (dict == NULL && dictSize > 0)) return -1;
+    if (dictSize > arena->dictCapacity) {
+        dict += dictSize - arena->dictCapacity;
+        dictSize = arena->dictCapacity;
+    }
+    if (dictSize > 0) memcpy(arena->dict, dict, (size_t)dictSize);
+    arena->dictSize = dictSize;
+    LZ4_initStream(arena->dictStream, sizeof(LZ4_stream_t));
+    LZ4_loadDict(arena->dictStream, arena->dict, dictSize);
+    return dictSize;
+}
+
+
+/*-************************************
+*  Compression
+**************************************/
+LZ4_stream_t* LZ4_arena_startStream(LZ4_arena* arena)
+{
+    LZ4_resetStream_fast(arena->stream);
+    if (arena->dictSize > 0) LZ4_attach_dictionary(arena->stream, arena->dictStream);
+    return arena->stream;
+}
+
+int LZ4_arena_compress(LZ4_arena* arena, const char* src, char* dst,
+                       int srcSize, int dstCapacity, int acceleration)
+{
+    if (arena->dictSize == 0)
+        return LZ4_compress_fast_extState_fastReset(arena->stream, src, dst, srcSize, dstCapacity, acceleration);
+    return LZ4_compress_fast_continue(LZ4_arena_startStream(arena), src, dst, srcSize, dstCapacity, acceleration);
+}
+
+int LZ4_arena_compressHC(LZ4_arena* arena, const char* src, char* dst,
+                         int srcSize, int dstCapacity, int compressionLevel)
+{
+    if (arena->streamHC == NULL) return 0;
+    return LZ4_compress_HC_extStateHC_workspace(arena->streamHC, arena->workspaceHC,
+                                                src, dst, srcSize, dstCapacity, compressionLevel);
+}
+
+
+/*-************************************
+*  Decompression
+**************************************/
+LZ4_streamDecode_t* LZ4_arena_startStreamDecode(LZ4_arena* arena)
+{
+    LZ4_setStreamDecode(arena->streamDecode, arena->dict, arena->dictSize);
+    return arena->streamDecode;
+}
+
+int LZ4_arena_decompress(LZ4_arena* arena, const char* src, char* dst,
+                         int compressedSize, int dstCapacity)
+{
+    if (arena->dictSize == 0)
+        return LZ4_decompress_safe(src, dst, compressedSize, dstCapacity);
+    return LZ4_decompress_safe_usingDict(src, dst, compressedSize, dstCapacity, arena->dict, arena->dictSize);
+}
@@ -0,0 +1,124 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Caller-provided state arena
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4ARENA_H_70318264
+#define LZ4ARENA_H_70318264
+
+/* --- Dependency --- */
+#include <stddef.h>   /* size_t */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  lz4arena.h gathers all the state needed by compression, HC compression, decompression
+  and dictionaries into a single memory area, provided by the caller.
+  Once the arena is initialized, none of the functions below allocate memory,
+  and their stack usage doesn't depend on input size : states don't live on the stack,
+  unlike within LZ4_compress_default() or LZ4_compress_HC().
+
+  Sequence : LZ4_sizeofArena() tells how much memory is needed, for a given dictionary capacity
+  and with or without HC, then LZ4_initArena() carves the states from the caller's buffer.
+  The buffer can be static, on the stack, or within any other structure ;
+  it must be aligned on LZ4ARENA_ALIGNMENT bytes, and must outlive the arena.
+
+  An arena is meant to be used by one thread at a time.
+  HC compression in this version doesn't use the dictionary.
+*/
+
+#define LZ4ARENA_ALIGNMENT 8
+
+typedef struct LZ4_arena_s LZ4_arena;   /* incomplete type */
+
+/*! LZ4_sizeofArena() :
+ *  dictCapacity : largest dictionary the arena can hold, from 0 (no dictionary) to 64 KB.
+ *  withHC : 1 to also host the state of LZ4_arena_compressHC() (about 320 KB), 0 otherwise.
+ * @return : size of the arena, or 0 if parameters are invalid.
+ */
+LZ4LIB_API size_t LZ4_sizeofArena(int dictCapacity, int withHC);
+
+/*! LZ4_initArena() :
+ *  Prepares `buffer`, of `size` bytes, to host an arena with parameters `dictCapacity` and `withHC`.
+ *  Nothing is allocated : the arena, and everything it contains, live within `buffer`.
+ * @return : the arena, or NULL if `buffer` is NULL, misaligned or too small.
+ */
+LZ4LIB_API LZ4_arena* LZ4_initArena(void* buffer, size_t size, int dictCapacity, int withHC);
+
+/*! LZ4_arena_loadDict() :
+ *  Copies the dictionary into the arena, and hashes it once for all future compressions.
+ *  Only the last `dictCapacity` bytes are kept. `dictSize == 0` removes the dictionary.
+ *  The caller's buffer can be released or modified afterwards.
+ * @return : size of the dictionary kept, or a negative value if the arena can't hold a dictionary.
+ */
+LZ4LIB_API int LZ4_arena_loadDict(LZ4_arena* arena, const char* dict, int dictSize);
+
+/*! LZ4_arena_compress() :
+ *  Same as LZ4_compress_fast(), using the arena's dictionary if one is loaded.
+ *  Each call produces an independent block.
+ */
+LZ4LIB_API int LZ4_arena_compress(LZ4_arena* arena, const char* src, char* dst,
+                                  int srcSize, int dstCapacity, int acceleration);
+
+/*! LZ4_arena_compressHC() :
+ *  Same as LZ4_compress_HC(). The dictionary is not used.
+ * @return : compressed size, or 0 if compression fails or the arena was created without HC.
+ */
+LZ4LIB_API int LZ4_arena_compressHC(LZ4_arena* arena, const char* src, char* dst,
+                                    int srcSize, int dstCapacity, int compressionLevel);
+
+/*! LZ4_arena_decompress() :
+ *  Same as LZ4_decompress_safe(), using the arena's dictionary if one is loaded.
+ */
+LZ4LIB_API int LZ4_arena_decompress(LZ4_arena* arena, const char* src, char* dst,
+                                    int compressedSize, int dstCapacity);
+
+/*! LZ4_arena_startStream() :
+ *  Resets the arena's compression stream, starting from the dictionary if one is loaded,
+ * @return : the stream, to be used with LZ4_compress_fast_continue().
+ *  Note : LZ4_arena_compress() uses the same state, so it ends the stream.
+ */
+LZ4LIB_API LZ4_stream_t* LZ4_arena_startStream(LZ4_arena* arena);
+
+/*! LZ4_arena_startStreamDecode() :
+ *  Resets the arena's decompression stream, starting from the dictionary if one is loaded.
+ * @return : the stream, to be used with LZ4_decompress_safe_continue().
+ */
+LZ4LIB_API LZ4_streamDecode_t* LZ4_arena_startStreamDecode(LZ4_arena* arena);
+
+#endif /* LZ4ARENA_H_70318264 */
+
+#if defined (__cplusplus)
+}
+#endif
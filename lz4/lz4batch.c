@@ -0,0 +1,128 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Batched small-message API
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <limits.h>     /* INT_MAX */
+#define LZ4_STATIC_LINKING_ONLY   /* LZ4_compress_fast_extState_fastReset */
+#include "lz4batch.h"
+
+
+/*-************************************
+*  Compression
+**************************************/
+int LZ4_compressBound_batch(const int* srcSizes, int nbMessages)
+{
+    long long bound = 0;
+    int n;
+    if (nbMessages < 0) return 0;
+    if (nbMessages > 0 && srcSizes == NULL) return 0;
+    for (n = 0; n < nbMessages; n++) {
+        int const b = LZ4_compressBound(srcSizes[n]);
+        if (b == 0) return 0;   /* invalid size */
+        bound += b;
+        if (bound > INT_MAX) return 0;
+    }
+    return (int)bound;
+}
+
+/* LZ4BATCH_compressMessage() :
+ * `ctx` must have been initialized once with LZ4_initStream().
+ * Same sequence as a LZ4F frame compressing independent blocks with a dictionary :
+ * the working state is cheaply reset, then references the pre-hashed dictionary,
+ * which is detached again at the end of the call. */
+static int LZ4BATCH_compressMessage(LZ4_stream_t* ctx, const LZ4_stream_t* dictStream,
+                                    const char* src, char* dst, int srcSize, int dstCapacity,
+                                    int acceleration)
+{
+    if (dictStream == NULL)
+        return LZ4_compress_fast_extState_fastReset(ctx, src, dst, srcSize, dstCapacity, acceleration);
+    LZ4_resetStream_fast(ctx);
+    LZ4_attach_dictionary(ctx, dictStream);
+    return LZ4_compress_fast_continue(ctx, src, dst, srcSize, dstCapacity, acceleration);
+}
+
+int LZ4_compress_batch(const LZ4_stream_t* dictStream,
+                       const char* const* srcs, const int* srcSizes, int nbMessages,
+                       char* dst, int dstCapacity, int* offsets,
+                       int acceleration)
+{
+    LZ4_stream_t ctx;
+    int pos = 0;
+    int n;
+
+    if (offsets == NULL || nbMessages < 0 || dstCapacity < 0) return 0;
+    if (nbMessages > 0 && (srcs == NULL || srcSizes == NULL || dst == NULL)) return 0;
+    if (LZ4_initStream(&ctx, sizeof(ctx)) == NULL) return 0;
+
+    for (n = 0; n < nbMessages; n++) {
+        int cSize;
+        offsets[n] = pos;
+        if (srcSizes[n] < 0) return 0;
+        cSize = LZ4BATCH_compressMessage(&ctx, dictStream,
+                                         srcs[n], dst + pos, srcSizes[n], dstCapacity - pos,
+                                         acceleration);
+        if (cSize <= 0) return 0;   /* note : even an empty message produces 1 byte */
+        pos += cSize;
+    }
+    offsets[nbMessages] = pos;
+    return pos;
+}
+
+
+/*-************************************
+*  Decompression
+**************************************/
+int LZ4_decompress_batch(const char* src, const int* srcOffsets, int nbMessages,
+                         char* dst, int dstCapacity, int* dstOffsets,
+                         const char* dict, int dictSize)
+{
+    int pos = 0;
+    int n;
+
+    if (srcOffsets == NULL || dstOffsets == NULL || nbMessages < 0 || dstCapacity < 0) return -1;
+    if (dictSize < 0 || (dict == NULL && dictSize > 0)) return -1;
+
+    for (n = 0; n < nbMessages; n++) {
+        int const start = srcOffsets[n];
+        int const end = srcOffsets[n+1];
+        int dSize;
+        dstOffsets[n] = pos;
+        if (src == NULL || dst == NULL) return -(n+1);
+        if (start < srcOffsets[0] || end < start || end > srcOffsets[nbMessages]) return -(n+1);
+        dSize = LZ4_decompress_safe_usingDict(src + start, dst + pos, end - start,
+                                              dstCapacity - pos, dict, dictSize);
+        if (dSize < 0) return -(n+1);
+        pos += dSize;
+    }
+    dstOffsets[nbMessages] = pos;
+    return pos;
+}
@@ -0,0 +1,112 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Batched small-message API
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4BATCH_H_83746251
+#define LZ4BATCH_H_83746251
+
+/* --- Dependency --- */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  lz4batch.h compresses many small messages (typically a few hundred bytes to a few KB)
+  in a single call, against a shared dictionary.
+
+  At such sizes, the cost of preparing a compression state for each message,
+  and the lack of history to find matches into, dominate both speed and ratio.
+  Here, the dictionary is loaded and hashed once, with LZ4_loadDict(),
+  into a LZ4_stream_t which is then referenced by every message of every batch
+  (see LZ4_attach_dictionary()). The working state is initialized once per batch.
+
+  Each message becomes an independent LZ4 block, which only references the dictionary.
+  Blocks are written back to back into a single output "arena",
+  and their positions are reported into an array of offsets :
+  block n occupies arena[offsets[n] .. offsets[n+1]-1].
+  A block can be decoded on its own with LZ4_decompress_safe_usingDict(),
+  or a whole batch can be decoded with LZ4_decompress_batch().
+*/
+
+/*! LZ4_compressBound_batch() :
+ *  Provides the arena size which guarantees that LZ4_compress_batch() succeeds,
+ *  for messages of sizes `srcSizes[0 .. nbMessages-1]`.
+ * @return : maximum output size, or 0 if parameters are invalid or the bound exceeds INT_MAX.
+ */
+LZ4LIB_API int LZ4_compressBound_batch(const int* srcSizes, int nbMessages);
+
+/*! LZ4_compress_batch() :
+ *  Compresses `nbMessages` messages, message n being `srcSizes[n]` bytes at `srcs[n]`,
+ *  into the contiguous arena `dst`, of capacity `dstCapacity`.
+ *  `offsets` must provide room for `nbMessages+1` values :
+ *  on success, offsets[0] == 0, and block n occupies dst[offsets[n] .. offsets[n+1]-1].
+ *
+ *  dictStream : a state prepared with LZ4_loadDict() (or LZ4_loadDictSlow()),
+ *               it is only read, so it can be shared by concurrent batches.
+ *               The dictionary buffer must remain accessible and unmodified.
+ *               NULL means "no dictionary".
+ *  acceleration : same meaning as in LZ4_compress_fast().
+ *
+ * @return : total number of bytes written into `dst` (== offsets[nbMessages]),
+ *           or 0 if compression fails (typically, `dst` too small).
+ *  Note : an empty batch (nbMessages == 0) is valid, and returns 0 too, with offsets[0] == 0.
+ */
+LZ4LIB_API int LZ4_compress_batch(const LZ4_stream_t* dictStream,
+                                  const char* const* srcs, const int* srcSizes, int nbMessages,
+                                  char* dst, int dstCapacity, int* offsets,
+                                  int acceleration);
+
+/*! LZ4_decompress_batch() :
+ *  Decodes the `nbMessages` blocks of an arena produced by LZ4_compress_batch(),
+ *  `srcOffsets` being the offsets array it produced (`nbMessages+1` values).
+ *  Messages are regenerated back to back into `dst`, of capacity `dstCapacity`,
+ *  and their positions are written into `dstOffsets` (`nbMessages+1` values),
+ *  message n occupying dst[dstOffsets[n] .. dstOffsets[n+1]-1].
+ *  `dict` and `dictSize` must be the same dictionary content as the one used for compression
+ *  (NULL and 0 if none).
+ *
+ * @return : total number of bytes decoded into `dst` (== dstOffsets[nbMessages]),
+ *           or -(n+1) if block n is malformed, or doesn't fit into the remaining space of `dst`.
+ *  Note : like LZ4_decompress_safe(), it never writes outside of `dst`,
+ *         nor reads outside of `src[srcOffsets[0] .. srcOffsets[nbMessages]-1]`.
+ */
+LZ4LIB_API int LZ4_decompress_batch(const char* src, const int* srcOffsets, int nbMessages,
+                                    char* dst, int dstCapacity, int* dstOffsets,
+                                    const char* dict, int dictSize);
+
+#endif /* LZ4BATCH_H_83746251 */
+
+#if defined (__cplusplus)
+}
+#endif
@@ -0,0 +1,354 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Dictionary trainer
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <stdlib.h>     /* malloc, calloc, free */
+#include <string.h>     /* memcpy, memmove, memset */
+#include "lz4dict.h"
+
+
+/*-************************************
+*  Basic Types
+**************************************/
+#if defined(__cplusplus) || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */)
+# include <stdint.h>
+  typedef uint8_t  BYTE;
+  typedef uint32_t U32;
+  typedef uint64_t U64;
+#else
+  typedef unsigned char       BYTE;
+  typedef unsigned int        U32;
+  typedef unsigned long long  U64;
+#endif
+
+#define LZ4DICT_HASHLOG_MIN   12
+#define LZ4DICT_HASHLOG_MAX   20
+#define LZ4DICT_SAMPLES_MIN   8      /* below that, there is nothing to learn */
+
+/* candidates tried by LZ4_trainDictionary() */
+static const int LZ4DICT_segmentSizes[] = { 64, 128, 256, 512, 1024 };
+static const int LZ4DICT_dmerSizes[] = { 6, 8 };
+
+
+/*-************************************
+*  Dmer hashing
+**************************************/
+static U64 LZ4DICT_readLE64(const BYTE* p)
+{
+    return (U64)p[0] | ((U64)p[1] << 8) | ((U64)p[2] << 16) | ((U64)p[3] << 24)
+         | ((U64)p[4] << 32) | ((U64)p[5] << 40) | ((U64)p[6] << 48) | ((U64)p[7] << 56);
+}
+
+/* LZ4DICT_hash() :
+ * hashes the `d` bytes at `p`, but reads 8 bytes : callers only hash positions
+ * with at least 8 bytes remaining in the sample set. */
+static size_t LZ4DICT_hash(const BYTE* p, int d, U32 hashLog)
+{
+    U64 const prime8bytes = 0xCF1BBCDCB7A56463ULL;
+    U64 const v = LZ4DICT_readLE64(p) << (64 - 8 * d);
+    return (size_t)((v * prime8bytes) >> (64 - hashLog));
+}
+
+
+/*-************************************
+*  Cover algorithm
+**************************************/
+typedef struct {
+    const BYTE* samples;
+    size_t nbDmers;      /* positions which can be hashed */
+    U32* freqs;          /* nb of samples containing each dmer hash, 0 once selected */
+    U32* windowFreqs;    /* occurrences of each dmer hash within the current window,
+                          * which can hold more than 65535 dmers : segment sizes aren't bounded */
+    int d;
+    U32 hashLog;
+} LZ4DICT_ctx;
+
+typedef struct {
+    size_t begin;        /* first dmer position */
+    size_t end;          /* last dmer position + 1 */
+    U64 score;
+} LZ4DICT_segment;
+
+/* LZ4DICT_countDmers() :
+ * each dmer counts at most once per sample :
+ * repetitions within a sample are already found by LZ4 itself. */
+static void LZ4DICT_countDmers(LZ4DICT_ctx* ctx, const int* sampleSizes, int nbSamples, U32* lastSample)
+{
+    size_t start = 0;
+    int n;
+    for (n = 0; n < nbSamples; n++) {
+        size_t const end = start + (size_t)sampleSizes[n];
+        size_t pos;
+        for (pos = start; pos + (size_t)ctx->d <= end && pos < ctx->nbDmers; pos++) {
+            size_t const h = LZ4DICT_hash(ctx->samples + pos, ctx->d, ctx->hashLog);
+            if (lastSample[h] != (U32)n + 1) {
+                lastSample[h] = (U32)n + 1;
+                ctx->freqs[h]++;
+            }
+        }
+        start = end;
+    }
+}
+
+/* LZ4DICT_selectSegment() :
+ * finds, within dmer positions [begin, end), the window of `k` bytes
+ * whose distinct dmers have the highest total frequency,
+ * then trims dmers which no longer score from both ends,
+ * and zeroes the frequencies of the selected dmers. */
+static LZ4DICT_segment LZ4DICT_selectSegment(LZ4DICT_ctx* ctx, size_t begin, size_t end, int k)
+{
+    size_t const windowDmers = (size_t)(k - ctx->d + 1);
+    LZ4DICT_segment best = { 0, 0, 0 };
+    LZ4DICT_segment window;
+    best.begin = best.end = begin;
+    window = best;
+
+    while (window.end < end) {
+        size_t const h = LZ4DICT_hash(ctx->samples + window.end, ctx->d, ctx->hashLog);
+        if (ctx->windowFreqs[h] == 0) window.score += ctx->freqs[h];
+        ctx->windowFreqs[h]++;
+        window.end++;
+        if (window.end - window.begin == windowDmers) {
+            size_t const delH = LZ4DICT_hash(ctx->samples + window.begin, ctx->d, ctx->hashLog);
+            if (window.score > best.score) best = window;
+            ctx->windowFreqs[delH]--;
+            if (ctx->windowFreqs[delH] == 0) window.score -= ctx->freqs[delH];
+            window.begin++;
+        }
+    }
+    /* a short epoch never fills the window : consider it as a whole */
+    if (best.score == 0 && window.score > 0 && window.begin == begin) best = window;
+
+    /* reset windowFreqs for next call */
+    while (window.begin < window.end) {
+        ctx->windowFreqs[LZ4DICT_hash(ctx->samples + window.begin, ctx->d, ctx->hashLog)] = 0;
+        window.begin++;
+    }
+
+    if (best.score == 0) return best;
+    {   size_t pos;
+        while (ctx->freqs[LZ4DICT_hash(ctx->samples + best.begin, ctx->d, ctx->hashLog)] == 0) best.begin++;
+        while (ctx->freqs[LZ4DICT_hash(ctx->samples + best.end - 1, ctx->d, ctx->hashLog)] == 0) best.end--;
+        for (pos = best.begin; pos < best.end; pos++)
+            ctx->freqs[LZ4DICT_hash(ctx->samples + pos, ctx->d, ctx->hashLog)] = 0;
+    }
+    return best;
+}
+
+static U32 LZ4DICT_hashLog(size_t nbDmers)
+{
+    U32 hashLog = LZ4DICT_HASHLOG_MIN;
+    while (hashLog < LZ4DICT_HASHLOG_MAX && ((size_t)1 << hashLog) < nbDmers) hashLog++;
+    return hashLog;
+}
+
+/* LZ4DICT_cover() :
+ * `tables` must provide room for (1 << LZ4DICT_hashLog(nbDmers)) U32 frequencies,
+ * as many U32 for LZ4DICT_countDmers(), and as many U32 window counters. */
+static int LZ4DICT_cover(BYTE* dict, int dictCapacity,
+                         const BYTE* samples, size_t totalSize, const int* sampleSizes, int nbSamples,
+                         int k, int d, void* tables)
+{
+    LZ4DICT_ctx ctx;
+    size_t nbEpochs, epochSize, epoch;
+    size_t tail = (size_t)dictCapacity;
+    size_t zeroScoreRun = 0, maxZeroScoreRun;
+
+    ctx.samples = samples;
+    ctx.nbDmers = totalSize - 8 + 1;
+    ctx.d = d;
+    ctx.hashLog = LZ4DICT_hashLog(ctx.nbDmers);
+    {   size_t const tableSize = (size_t)1 << ctx.hashLog;
+        U32* const lastSample = (U32*)tables + tableSize;
+        ctx.freqs = (U32*)tables;
+        ctx.windowFreqs = lastSample + tableSize;
+        memset(tables, 0, tableSize * 3 * sizeof(U32));
+        LZ4DICT_countDmers(&ctx, sampleSizes, nbSamples, lastSample);
+    }
+
+    /* one segment per epoch and per pass, epochs being large enough to choose from */
+    nbEpochs = (size_t)(dictCapacity / k);
+    if (nbEpochs == 0) nbEpochs = 1;
+    epochSize = ctx.nbDmers / nbEpochs;
+    if (epochSize < 10 * (size_t)k) {
+        nbEpochs = ctx.nbDmers / (10 * (size_t)k);
+        if (nbEpochs == 0) nbEpochs = 1;
+        epochSize = ctx.nbDmers / nbEpochs;
+    }
+    maxZeroScoreRun = nbEpochs < 10 ? nbEpochs : (nbEpochs > 100 ? 100 : nbEpochs);
+
+    for (epoch = 0; tail > 0; epoch = (epoch + 1) % nbEpochs) {
+        size_t const epochBegin = epoch * epochSize;
+        size_t const epochEnd = (epoch == nbEpochs - 1) ? ctx.nbDmers : epochBegin + epochSize;
+        LZ4DICT_segment const segment = LZ4DICT_selectSegment(&ctx, epochBegin, epochEnd, k);
+        size_t segmentSize;
+        if (segment.score == 0) {
+            if (++zeroScoreRun >= maxZeroScoreRun) break;
+            continue;
+        }
+        zeroScoreRun = 0;
+        segmentSize = segment.end - segment.begin + (size_t)d - 1;
+        if (segmentSize > tail) segmentSize = tail;
+        if (segmentSize < (size_t)d) break;
+        tail -= segmentSize;
+        memcpy(dict + tail, samples + segment.begin, segmentSize);
+    }
+
+    memmove(dict, dict + tail, (size_t)dictCapacity - tail);
+    return dictCapacity - (int)tail;
+}
+
+/* LZ4DICT_evaluate() :
+ * total compressed size of all samples, each one compressed independently with `dict`,
+ * or 0 if compression fails */
+static U64 LZ4DICT_evaluate(const char* dict, int dictSize,
+                            const char* samples, const int* sampleSizes, int nbSamples,
+                            LZ4_stream_t* dictStream, LZ4_stream_t* cctx, char* dst, int dstCapacity)
+{
+    const char* src = samples;
+    U64 total = 0;
+    int n;
+    LZ4_loadDict(dictStream, dict, dictSize);
+    for (n = 0; n < nbSamples; n++) {
+        int cSize;
+        LZ4_resetStream_fast(cctx);
+        LZ4_attach_dictionary(cctx, dictStream);
+        cSize = LZ4_compress_fast_continue(cctx, src, dst, sampleSizes[n], dstCapacity, 1);
+        if (cSize <= 0) return 0;
+        total += (U64)cSize;
+        src += sampleSizes[n];
+    }
+    return total;
+}
+
+
+/*-************************************
+*  Public functions
+**************************************/
+/* LZ4DICT_checkSamples() :
+ * @return : total size of samples, or 0 if they are unusable */
+static size_t LZ4DICT_checkSamples(const char* samples, const int* sampleSizes, int nbSamples, int* maxSampleSize)
+{
+    size_t total = 0;
+    int n;
+    *maxSampleSize = 0;
+    if (samples == NULL || sampleSizes == NULL || nbSamples < LZ4DICT_SAMPLES_MIN) return 0;
+    for (n = 0; n < nbSamples; n++) {
+        if (sampleSizes[n] < 0 || sampleSizes[n] > LZ4_MAX_INPUT_SIZE) return 0;
+        if (sampleSizes[n] > *maxSampleSize) *maxSampleSize = sampleSizes[n];
+        total += (size_t)sampleSizes[n];
+    }
+    if (total < 8) return 0;
+    return total;
+}
+
+static void* LZ4DICT_allocTables(size_t totalSize)
+{
+    size_t const tableSize = (size_t)1 << LZ4DICT_hashLog(totalSize - 8 + 1);
+    return malloc(tableSize * 3 * sizeof(U32));
+}
+
+int LZ4_trainDictionary_cover(char* dictBuffer, int dictCapacity,
+                              const char* samples, const int* sampleSizes, int nbSamples,
+                              int segmentSize, int dmerSize)
+{
+    int maxSampleSize;
+    size_t const totalSize = LZ4DICT_checkSamples(samples, sampleSizes, nbSamples, &maxSampleSize);
+    void* tables;
+    int dictSize;
+
+    if (totalSize == 0 || dictBuffer == NULL || dictCapacity <= 0) return 0;
+    if (dmerSize < LZ4DICT_DMER_MIN || dmerSize > LZ4DICT_DMER_MAX) return 0;
+    if (segmentSize < LZ4DICT_SEGMENT_MIN || segmentSize < dmerSize) return 0;
+    if (dictCapacity > LZ4DICT_SIZE_MAX) dictCapacity = LZ4DICT_SIZE_MAX;
+
+    tables = LZ4DICT_allocTables(totalSize);
+    if (tables == NULL) return 0;
+    dictSize = LZ4DICT_cover((BYTE*)dictBuffer, dictCapacity,
+                             (const BYTE*)samples, totalSize, sampleSizes, nbSamples,
+                             segmentSize, dmerSize, tables);
+    free(tables);
+    return dictSize;
+}
+
+int LZ4_trainDictionary(char* dictBuffer, int dictCapacity,
+                        const char* samples, const int* sampleSizes, int nbSamples)
+{
+    int maxSampleSize;
+    size_t const totalSize = LZ4DICT_checkSamples(samples, sampleSizes, nbSamples, &maxSampleSize);
+    int const nbSegmentSizes = (int)(sizeof(LZ4DICT_segmentSizes) / sizeof(LZ4DICT_segmentSizes[0]));
+    int const nbDmerSizes = (int)(sizeof(LZ4DICT_dmerSizes) / sizeof(LZ4DICT_dmerSizes[0]));
+    int const dstCapacity = LZ4_compressBound(maxSampleSize);
+    void* tables = NULL;
+    char* candidate = NULL;
+    char* dst = NULL;
+    LZ4_stream_t* dictStream = NULL;
+    LZ4_stream_t* cctx = NULL;
+    U64 bestCost = 0;
+    int bestSize = 0;
+    int i, j;
+
+    if (totalSize == 0 || dictBuffer == NULL || dictCapacity <= 0) return 0;
+    if (dictCapacity > LZ4DICT_SIZE_MAX) dictCapacity = LZ4DICT_SIZE_MAX;
+
+    tables = LZ4DICT_allocTables(totalSize);
+    candidate = (char*)malloc((size_t)dictCapacity);
+    dst = (char*)malloc((size_t)dstCapacity);
+    dictStream = LZ4_createStream();
+    cctx = LZ4_createStream();
+    if (tables == NULL || candidate == NULL || dst == NULL || dictStream == NULL || cctx == NULL) goto _cleanup;
+
+    for (i = 0; i < nbSegmentSizes; i++) {
+        for (j = 0; j < nbDmerSizes; j++) {
+            int const size = LZ4DICT_cover((BYTE*)candidate, dictCapacity,
+                                           (const BYTE*)samples, totalSize, sampleSizes, nbSamples,
+                                           LZ4DICT_segmentSizes[i], LZ4DICT_dmerSizes[j], tables);
+            U64 cost;
+            if (size == 0) continue;
+            cost = LZ4DICT_evaluate(candidate, size, samples, sampleSizes, nbSamples,
+                                    dictStream, cctx, dst, dstCapacity);
+            if (cost == 0) continue;
+            if (bestSize == 0 || cost < bestCost) {
+                memcpy(dictBuffer, candidate, (size_t)size);
+                bestCost = cost;
+                bestSize = size;
+            }
+    }   }
+
+_cleanup:
+    free(tables);
+    free(candidate);
+    free(dst);
+    LZ4_freeStream(dictStream);
+    LZ4_freeStream(cctx);
+    return bestSize;
+}
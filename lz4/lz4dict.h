@@ -0,0 +1,97 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Dictionary trainer
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4DICT_H_61527384
+#define LZ4DICT_H_61527384
+
+/* --- Dependency --- */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  LZ4 can only reference data it has seen before. Small messages, compressed independently,
+  have no history, so they barely compress. A dictionary fixes that : it is a blob of
+  content that every message can reference, loaded once with LZ4_loadDict() for compression,
+  and passed to LZ4_decompress_safe_usingDict() for decompression.
+
+  lz4dict.h builds such a dictionary from a set of samples representative of the traffic.
+  It uses a "cover" algorithm : the samples are cut into epochs, and each epoch contributes
+  the segment whose d-byte substrings ("dmers") are the most frequent across all samples.
+  Once a segment is selected, its dmers no longer count, so the dictionary isn't filled
+  with copies of the same content. Segments are stored from the end of the dictionary,
+  best ones last, where they are the cheapest to reference.
+
+  The result is raw content : it can be passed straight to LZ4_loadDict().
+  LZ4 only uses the last 64 KB of a dictionary, so that's also the maximum size produced.
+*/
+
+#define LZ4DICT_SIZE_MAX      (64 * 1024)
+#define LZ4DICT_SEGMENT_MIN   16
+#define LZ4DICT_DMER_MIN      4      /* LZ4 minimum match length */
+#define LZ4DICT_DMER_MAX      8
+
+/*! LZ4_trainDictionary() :
+ *  Trains a dictionary from samples, stored back to back into `samples`,
+ *  sample n being `sampleSizes[n]` bytes long.
+ *  The dictionary is written into `dictBuffer`, of capacity `dictCapacity`
+ *  (values beyond LZ4DICT_SIZE_MAX are useless, and capped).
+ *  Several segment and dmer sizes are tried, and the dictionary compressing
+ *  the samples best with LZ4_compress_fast() is kept, which costs
+ *  about a dozen trainings and compressions of the whole sample set.
+ *  A few hundred samples, totaling ~100x the dictionary size, are a good start.
+ * @return : size of the dictionary (<= dictCapacity),
+ *           or 0 if training fails (invalid parameters, not enough samples, not enough memory).
+ */
+LZ4LIB_API int LZ4_trainDictionary(char* dictBuffer, int dictCapacity,
+                                   const char* samples, const int* sampleSizes, int nbSamples);
+
+/*! LZ4_trainDictionary_cover() :
+ *  Same as LZ4_trainDictionary(), with an explicit segment size (in bytes,
+ *  >= LZ4DICT_SEGMENT_MIN) and dmer size (within [LZ4DICT_DMER_MIN, LZ4DICT_DMER_MAX]).
+ *  A single training is performed : it's much faster, but the best parameters depend on the data.
+ *  Larger segments suit samples sharing long runs of content,
+ *  shorter ones suit samples sharing many small fields.
+ * @return : size of the dictionary, or 0 if training fails.
+ */
+LZ4LIB_API int LZ4_trainDictionary_cover(char* dictBuffer, int dictCapacity,
+                                         const char* samples, const int* sampleSizes, int nbSamples,
+                                         int segmentSize, int dmerSize);
+
+#endif /* LZ4DICT_H_61527384 */
+
+#if defined (__cplusplus)
+}
+#endif
@@ -0,0 +1,864 @@
+/*
+    LZ4 HC - High Compression Mode of LZ4
+
+    BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions are
+    met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following disclaimer
+    in the documentation and/or other materials provided with the
+    distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+    A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+    OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+    SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+    LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+    DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+    THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+    OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/* note : lz4hc is not an independent module, it requires lz4.h/lz4.c for proper compilation */
+
+
+/* *************************************
+*  Tuning Parameter
+***************************************/
+
+/*! HEAPMODE :
+ *  Select how stateless HC compression functions like `LZ4_compress_HC()`
+ *  allocate memory for their workspace:
+ *  in stack (0), or in heap (1:default).
+ *  Since workspace is rather large, heap mode is recommended.
+**/
+#ifndef LZ4HC_HEAPMODE
+#  define LZ4HC_HEAPMODE 1
+#endif
+
+
+/*===    Dependency    ===*/
+#include "lz4hc.h"
+#include <limits.h>
+
+
+/*===   Shared lz4.c code   ===*/
+#ifndef LZ4_SRC_INCLUDED
+# if defined(__GNUC__)
+#  pragma GCC diagnostic ignored "-Wunused-function"
+# endif
+# if defined (__clang__)
+#  pragma clang diagnostic ignored "-Wunused-function"
+# endif
+# define LZ4_COMMONDEFS_ONLY
+# include "lz4.c"   /* LZ4_count, constants, mem */
+#endif
+
+
+/*===   Enums   ===*/
+typedef enum { lz4mid, lz4hc, lz4opt } lz4hc_strat_e;
+
+
+/*===   Constants   ===*/
+#define LZ4_OPT_NUM   (1<<12)
+#define TRAILING_LITERALS 3
+#define LZ4HC_START_INDEX  (64 KB)   /* indexes below this value are never valid */
+
+
+/*===   Macros   ===*/
+#define MIN(a,b)   ( (a) < (b) ? (a) : (b) )
+#define HASH_FUNCTION(i)      (((i) * 2654435761U) >> ((MINMATCH*8)-LZ4HC_HASH_LOG))
+#define DELTANEXTU16(table, pos) table[(U16)(pos)]   /* faster */
+/* Make fields passed to, and updated by LZ4HC_encodeSequence explicit */
+#define UPDATABLE(ip, op, anchor) &ip, &op, &anchor
+
+
+/*-************************************
+*  Compression levels
+**************************************/
+typedef struct {
+    lz4hc_strat_e strat;
+    int nbSearches;      /* max number of candidates visited along the hash chain (unused by lz4mid) */
+    U32 targetLength;    /* a match this long is accepted right away, without further evaluation (unused by lz4mid) */
+} cParams_t;
+
+static const cParams_t k_clTable[LZ4HC_CLEVEL_MAX+1] = {
+    { lz4mid,    2, 16 },  /* 0, unused */
+    { lz4mid,    2, 16 },  /* 1, same as 2 */
+    { lz4mid,    2, 16 },  /* 2 */
+    { lz4hc,     4, 16 },  /* 3 */
+    { lz4hc,     8, 16 },  /* 4 */
+    { lz4hc,    16, 32 },  /* 5 */
+    { lz4hc,    32, 32 },  /* 6 */
+    { lz4hc,    64, 32 },  /* 7 */
+    { lz4hc,   128, 64 },  /* 8 */
+    { lz4hc,   256, 64 },  /* 9 */
+    { lz4opt,   96, 64 },  /*10==LZ4HC_CLEVEL_OPT_MIN*/
+    { lz4opt,  512,128 },  /*11 */
+    { lz4opt,16384,LZ4_OPT_NUM },  /* 12==LZ4HC_CLEVEL_MAX */
+};
+
+static cParams_t LZ4HC_getCLevelParams(int cLevel)
+{
+    /* note : clevel convention is a bit different from lz4frame,
+     * possibly something worth revisiting for consistency */
+    if (cLevel < 1)
+        cLevel = LZ4HC_CLEVEL_DEFAULT;
+    cLevel = MIN(LZ4HC_CLEVEL_MAX, cLevel);
+    return k_clTable[cLevel];
+}
+
+
+/**************************************
+*  HC Compression - Hash Chain
+**************************************/
+typedef struct {
+    int off;
+    int len;
+} LZ4HC_match_t;
+
+static U32 LZ4HC_hashPtr(const void* ptr) { return HASH_FUNCTION(LZ4_read32(ptr)); }
+
+/* LZ4HC_init() :
+ * Prepares the context to compress the block starting at `start`.
+ * Indexes start at LZ4HC_START_INDEX, so that 0 (the content of a cleared hash table)
+ * is always below lowLimit, hence never mistaken for a valid position. */
+static void LZ4HC_init(LZ4HC_CCtx_internal* hc4, const BYTE* start)
+{
+    MEM_INIT(hc4->hashTable, 0, sizeof(hc4->hashTable));
+    /* chainTable doesn't need to be cleared :
+     * it is only read at positions already inserted during the current block */
+    hc4->base = start - LZ4HC_START_INDEX;
+    hc4->lowLimit = LZ4HC_START_INDEX;
+    hc4->nextToUpdate = LZ4HC_START_INDEX;
+}
+
+/* LZ4HC_Insert() :
+ * Update chains up to ip (excluded) */
+LZ4_FORCE_INLINE void LZ4HC_Insert (LZ4HC_CCtx_internal* hc4, const BYTE* ip)
+{
+    U16* const chainTable = hc4->chainTable;
+    U32* const hashTable  = hc4->hashTable;
+    const BYTE* const base = hc4->base;
+    U32 const target = (U32)(ip - base);
+    U32 idx = hc4->nextToUpdate;
+
+    while (idx < target) {
+        U32 const h = LZ4HC_hashPtr(base+idx);
+        size_t delta = idx - hashTable[h];
+        if (delta>LZ4_DISTANCE_MAX) delta = LZ4_DISTANCE_MAX;
+        DELTANEXTU16(chainTable, idx) = (U16)delta;
+        hashTable[h] = idx;
+        idx++;
+    }
+
+    hc4->nextToUpdate = target;
+}
+
+/* LZ4HC_InsertAndFindLongerMatch() :
+ * Inserts all positions up to `ip`,
+ * then walks the hash chain of `ip`, visiting at most `maxNbAttempts` candidates.
+ * Note that all offsets cost the same in the LZ4 format,
+ * so the longest match is also the cheapest way to cover any length up to its own.
+ * @return : longest match found, provided it is strictly longer than `longest`,
+ *           or a match of length 0 otherwise.
+ *           Match length never extends beyond `iHighLimit`. */
+LZ4_FORCE_INLINE LZ4HC_match_t
+LZ4HC_InsertAndFindLongerMatch(LZ4HC_CCtx_internal* const hc4,
+                               const BYTE* const ip, const BYTE* const iHighLimit,
+                               int longest, int maxNbAttempts)
+{
+    U16* const chainTable = hc4->chainTable;
+    U32* const hashTable = hc4->hashTable;
+    const BYTE* const base = hc4->base;
+    U32 const ipIndex = (U32)(ip - base);
+    U32 const lowestMatchIndex = (hc4->lowLimit + LZ4_DISTANCE_MAX > ipIndex) ? hc4->lowLimit : ipIndex - LZ4_DISTANCE_MAX;
+    int nbAttempts = maxNbAttempts;
+    LZ4HC_match_t match = { 0, 0 };
+    U32 matchIndex;
+
+    assert(longest >= MINMATCH-1);
+    LZ4HC_Insert(hc4, ip);   /* Update chains up to ip (excluded) */
+    matchIndex = hashTable[LZ4HC_hashPtr(ip)];
+
+    while ((matchIndex >= lowestMatchIndex) && (nbAttempts > 0)) {
+        const BYTE* const matchPtr = base + matchIndex;
+        assert(matchIndex < ipIndex);
+        nbAttempts--;
+        /* quick reject : candidate must at least match the byte right after current best */
+        if (matchPtr[longest] == ip[longest]) {
+            if (LZ4_read32(matchPtr) == LZ4_read32(ip)) {
+                int const mlt = MINMATCH + (int)LZ4_count(ip+MINMATCH, matchPtr+MINMATCH, iHighLimit);
+                if (mlt > longest) {
+                    longest = mlt;
+                    match.len = mlt;
+                    match.off = (int)(ipIndex - matchIndex);
+                    if (ip + mlt >= iHighLimit) break;   /* can't do better */
+        }   }   }
+        {   U32 const nextOffset = DELTANEXTU16(chainTable, matchIndex);
+            if (matchIndex < lowestMatchIndex + nextOffset) break;   /* beyond window, or end of chain */
+            matchIndex -= nextOffset;
+    }   }
+
+    return match;
+}
+
+
+/* LZ4HC_encodeSequence() :
+ * @return : 0 if ok,
+ *           1 if buffer issue detected */
+LZ4_FORCE_INLINE int LZ4HC_encodeSequence (
+    const BYTE** _ip,
+    BYTE** _op,
+    const BYTE** _anchor,
+    int matchLength,
+    int offset,
+    limitedOutput_directive limit,
+    BYTE* oend)
+{
+#define ip      (*_ip)
+#define op      (*_op)
+#define anchor  (*_anchor)
+
+    size_t length;
+    BYTE* const token = op++;
+
+    /* Encode Literal length */
+    length = (size_t)(ip - anchor);
+    if (limit && ((op + (length / 255) + length + (2 + 1 + LASTLITERALS)) > oend)) return 1;   /* Check output limit */
+    if (length >= RUN_MASK) {
+        size_t len = length - RUN_MASK;
+        *token = (RUN_MASK << ML_BITS);
+        for(; len >= 255 ; len -= 255) *op++ = 255;
+        *op++ = (BYTE)len;
+    } else {
+        *token = (BYTE)(length << ML_BITS);
+    }
+
+    /* Copy Literals */
+    LZ4_wildCopy8(op, anchor, op + length);
+    op += length;
+
+    /* Encode Offset */
+    assert(offset <= LZ4_DISTANCE_MAX );
+    assert(offset > 0);
+    LZ4_writeLE16(op, (U16)(offset)); op += 2;
+
+    /* Encode MatchLength */
+    assert(matchLength >= MINMATCH);
+    length = (size_t)matchLength - MINMATCH;
+    if (limit && (op + (length / 255) + (1 + LASTLITERALS) > oend)) return 1;   /* Check output limit */
+    if (length >= ML_MASK) {
+        *token += ML_MASK;
+        length -= ML_MASK;
+        for(; length >= 510 ; length -= 510) { *op++ = 255; *op++ = 255; }
+        if (length >= 255) { length -= 255; *op++ = 255; }
+        *op++ = (BYTE)length;
+    } else {
+        *token += (BYTE)(length);
+    }
+
+    /* Prepare next loop */
+    ip += matchLength;
+    anchor = ip;
+
+    return 0;
+
+#undef ip
+#undef op
+#undef anchor
+}
+
+/* LZ4HC_encodeLastLiterals() :
+ * @return : 0 if ok,
+ *           1 if output buffer is too small */
+LZ4_FORCE_INLINE int LZ4HC_encodeLastLiterals(const BYTE* anchor, const BYTE* iend,
+                                              BYTE** _op, limitedOutput_directive limit, BYTE* oend)
+{
+    BYTE* op = *_op;
+    size_t const lastRunSize = (size_t)(iend - anchor);
+    size_t const llAdd = (lastRunSize + 255 - RUN_MASK) / 255;
+    size_t const totalSize = 1 + llAdd + lastRunSize;
+    if (limit && (op + totalSize > oend)) return 1;
+    if (lastRunSize >= RUN_MASK) {
+        size_t accumulator = lastRunSize - RUN_MASK;
+        *op++ = (RUN_MASK << ML_BITS);
+        for(; accumulator >= 255 ; accumulator -= 255) *op++ = 255;
+        *op++ = (BYTE) accumulator;
+    } else {
+        *op++ = (BYTE)(lastRunSize << ML_BITS);
+    }
+    LZ4_memcpy(op, anchor, lastRunSize);
+    op += lastRunSize;
+    *_op = op;
+    return 0;
+}
+
+
+/* LZ4HC_compress_hashChain() :
+ * Lazy parser : before emitting a match, check if a match starting one byte later
+ * would be longer by at least 2 bytes, which pays for the extra literal.
+ * Repeat as long as it's the case. */
+LZ4_FORCE_INLINE int LZ4HC_compress_hashChain (
+    LZ4HC_CCtx_internal* const ctx,
+    const char* const source,
+    char* const dest,
+    int const inputSize,
+    int const maxOutputSize,
+    int maxNbAttempts,
+    int const targetLength,
+    const limitedOutput_directive limit
+    )
+{
+    const BYTE* ip = (const BYTE*) source;
+    const BYTE* anchor = ip;
+    const BYTE* const iend = ip + inputSize;
+    const BYTE* const mflimit = iend - MFLIMIT;
+    const BYTE* const matchlimit = (iend - LASTLITERALS);
+    const BYTE* const lowPrefixPtr = (const BYTE*) source;
+
+    BYTE* op = (BYTE*) dest;
+    BYTE* oend = op + maxOutputSize;
+
+    /* init */
+    if (inputSize < LZ4_minLength) goto _last_literals;   /* Input too small, no compression (all literals) */
+
+    /* Main Loop */
+    while (ip <= mflimit) {
+        LZ4HC_match_t m = LZ4HC_InsertAndFindLongerMatch(ctx, ip, matchlimit, MINMATCH-1, maxNbAttempts);
+        if (m.len == 0) { ip++; continue; }
+
+        /* lazy evaluation */
+        while ((m.len < targetLength) && (ip+1 <= mflimit)) {
+            LZ4HC_match_t const m2 = LZ4HC_InsertAndFindLongerMatch(ctx, ip+1, matchlimit, m.len+1, maxNbAttempts);
+            if (m2.len == 0) break;
+            ip++;
+            m = m2;
+        }
+
+        /* catch up : extend match backward, into pending literals */
+        {   const BYTE* match = ip - m.off;
+            while ((ip > anchor) && (match > lowPrefixPtr) && (ip[-1] == match[-1])) {
+                ip--; match--; m.len++;
+        }   }
+
+        if (LZ4HC_encodeSequence(UPDATABLE(ip, op, anchor), m.len, m.off, limit, oend)) return 0;
+    }
+
+_last_literals:
+    if (LZ4HC_encodeLastLiterals(anchor, iend, &op, limit, oend)) return 0;
+
+    /* End */
+    return (int) (((char*)op)-dest);
+}
+
+
+/**************************************
+*  HC Compression - Double fast
+**************************************/
+/* The hash table of the HC state is split in two halves :
+ * one indexed on 4-byte sequences, like the fast compressor,
+ * one indexed on 8-byte sequences, which only collide for long matches.
+ * The chain table is not used. */
+#define LZ4MID_HASHLOG (LZ4HC_HASH_LOG-1)
+#define LZ4MID_HASHTABLESIZE (1 << LZ4MID_HASHLOG)
+#define LZ4MID_SKIPTRIGGER 9   /* skip faster over areas without any match */
+
+static U32 LZ4MID_hash4Ptr(const void* ptr)
+{
+    return (LZ4_read32(ptr) * 2654435761U) >> (32-LZ4MID_HASHLOG);
+}
+
+static U32 LZ4MID_hash8Ptr(const void* ptr)
+{
+    if (sizeof(reg_t) == 8) {
+        U64 const v = (U64)LZ4_read_ARCH(ptr);
+        return (U32)((v * 11400714785074694791ULL) >> (64-LZ4MID_HASHLOG));
+    } else {
+        U32 const v = (LZ4_read32(ptr) * 2654435761U) ^ (LZ4_read32((const BYTE*)ptr + 4) * 2246822519U);
+        return v >> (32-LZ4MID_HASHLOG);
+    }
+}
+
+/* LZ4MID_compress() :
+ * Greedy parser, one probe per table and position :
+ * the long match candidate is checked first, then the short one,
+ * in which case the long match candidate at ip+1 gets a chance to replace it.
+ * Both ends of each match are inserted, so that matches are found again later on. */
+static int LZ4MID_compress (
+    LZ4HC_CCtx_internal* const ctx,
+    const char* const source,
+    char* const dest,
+    int const inputSize,
+    int const maxOutputSize,
+    const limitedOutput_directive limit
+    )
+{
+    U32* const hash4Table = ctx->hashTable;
+    U32* const hash8Table = hash4Table + LZ4MID_HASHTABLESIZE;
+    const BYTE* const base = ctx->base;
+    const BYTE* ip = (const BYTE*) source;
+    const BYTE* anchor = ip;
+    const BYTE* const iend = ip + inputSize;
+    const BYTE* const mflimit = iend - MFLIMIT;
+    const BYTE* const matchlimit = iend - LASTLITERALS;
+    const BYTE* const lowPrefixPtr = (const BYTE*) source;
+    U32 const lowLimit = ctx->lowLimit;
+
+    BYTE* op = (BYTE*) dest;
+    BYTE* oend = op + maxOutputSize;
+
+    LZ4_STATIC_ASSERT(2 * LZ4MID_HASHTABLESIZE <= LZ4HC_HASHTABLESIZE);
+    if (inputSize < LZ4_minLength) goto _last_literals;   /* Input too small, no compression (all literals) */
+
+    while (ip <= mflimit) {
+        U32 const ipIndex = (U32)(ip - base);
+        U32 const lowestMatchIndex = (lowLimit + LZ4_DISTANCE_MAX > ipIndex) ? lowLimit : ipIndex - LZ4_DISTANCE_MAX;
+        int matchLength;
+        U32 matchDistance;
+
+        /* long match first */
+        {   U32 const h8 = LZ4MID_hash8Ptr(ip);
+            U32 const pos8 = hash8Table[h8];
+            hash8Table[h8] = ipIndex;
+            if (pos8 >= lowestMatchIndex) {
+                const BYTE* const matchPtr = base + pos8;
+                assert(pos8 < ipIndex);
+                if (LZ4_read32(matchPtr) == LZ4_read32(ip)) {
+                    matchLength = MINMATCH + (int)LZ4_count(ip+MINMATCH, matchPtr+MINMATCH, matchlimit);
+                    matchDistance = ipIndex - pos8;
+                    hash4Table[LZ4MID_hash4Ptr(ip)] = ipIndex;
+                    goto _encode_sequence;
+        }   }   }
+
+        /* then short match */
+        {   U32 const h4 = LZ4MID_hash4Ptr(ip);
+            U32 const pos4 = hash4Table[h4];
+            hash4Table[h4] = ipIndex;
+            if (pos4 >= lowestMatchIndex) {
+                const BYTE* const matchPtr = base + pos4;
+                assert(pos4 < ipIndex);
+                if (LZ4_read32(matchPtr) == LZ4_read32(ip)) {
+                    matchLength = MINMATCH + (int)LZ4_count(ip+MINMATCH, matchPtr+MINMATCH, matchlimit);
+                    matchDistance = ipIndex - pos4;
+                    /* a long match starting at ip+1 may still be better */
+                    {   U32 const h8 = LZ4MID_hash8Ptr(ip+1);
+                        U32 const pos8 = hash8Table[h8];
+                        if ((ip+1 <= mflimit) && (pos8 >= lowestMatchIndex) && (ipIndex + 1 - pos8 <= LZ4_DISTANCE_MAX)) {
+                            const BYTE* const m2Ptr = base + pos8;
+                            if (LZ4_read32(m2Ptr) == LZ4_read32(ip+1)) {
+                                int const ml2 = MINMATCH + (int)LZ4_count(ip+1+MINMATCH, m2Ptr+MINMATCH, matchlimit);
+                                if (ml2 > matchLength) {
+                                    hash8Table[h8] = ipIndex + 1;
+                                    ip++;
+                                    matchLength = ml2;
+                                    matchDistance = ipIndex + 1 - pos8;
+                    }   }   }   }
+                    goto _encode_sequence;
+        }   }   }
+
+        /* no match : step grows with the number of pending literals */
+        ip += 1 + ((ip - anchor) >> LZ4MID_SKIPTRIGGER);
+        continue;
+
+_encode_sequence:
+        /* catch up : extend match backward, into pending literals */
+        while ((ip > anchor) && ((U32)(ip - lowPrefixPtr) > matchDistance) && (ip[-1] == ip[-(int)matchDistance-1])) {
+            ip--; matchLength++;
+        }
+
+        /* positions right after the match start */
+        {   U32 const startIndex = (U32)(ip - base);
+            hash8Table[LZ4MID_hash8Ptr(ip+1)] = startIndex + 1;
+            hash8Table[LZ4MID_hash8Ptr(ip+2)] = startIndex + 2;
+            hash4Table[LZ4MID_hash4Ptr(ip+1)] = startIndex + 1;
+        }
+
+        if (LZ4HC_encodeSequence(UPDATABLE(ip, op, anchor), matchLength, (int)matchDistance, limit, oend)) return 0;
+
+        /* positions right before the match end */
+        {   U32 const endIndex = (U32)(ip - base);
+            hash8Table[LZ4MID_hash8Ptr(ip-5)] = endIndex - 5;
+            hash8Table[LZ4MID_hash8Ptr(ip-3)] = endIndex - 3;
+            hash4Table[LZ4MID_hash4Ptr(ip-2)] = endIndex - 2;
+            hash4Table[LZ4MID_hash4Ptr(ip-1)] = endIndex - 1;
+        }
+    }
+
+_last_literals:
+    if (LZ4HC_encodeLastLiterals(anchor, iend, &op, limit, oend)) return 0;
+
+    /* End */
+    return (int) (((char*)op)-dest);
+}
+
+
+/**************************************
+*  HC Compression - Optimal parser
+**************************************/
+typedef struct {
+    int price;
+    int off;
+    int mlen;
+    int litlen;
+} LZ4HC_optimal_t;
+
+/* price in bytes */
+LZ4_FORCE_INLINE int LZ4HC_literalsPrice(int const litlen)
+{
+    int price = litlen;
+    assert(litlen >= 0);
+    if (litlen >= (int)RUN_MASK)
+        price += 1 + ((litlen-(int)RUN_MASK) / 255);
+    return price;
+}
+
+/* requires mlen >= MINMATCH */
+LZ4_FORCE_INLINE int LZ4HC_sequencePrice(int litlen, int mlen)
+{
+    int price = 1 + 2 ; /* token + 16-bit offset */
+    assert(litlen >= 0);
+    assert(mlen >= MINMATCH);
+
+    price += LZ4HC_literalsPrice(litlen);
+
+    if (mlen >= (int)(ML_MASK+MINMATCH))
+        price+= 1 + ((mlen-(int)(ML_MASK+MINMATCH)) / 255);
+
+    return price;
+}
+
+/* LZ4HC_compress_optimal() :
+ * Shortest path search over a window of up to LZ4_OPT_NUM positions.
+ * opt[n] stores the cheapest known way to reach position ip+n,
+ * either ending with a match (mlen >= MINMATCH), or with a run of litlen literals (mlen == 1).
+ * Since all offsets cost the same, only the longest match is searched at each position,
+ * and every length between MINMATCH and its size is considered.
+ * `workspace` hosts opt[] when provided (see LZ4_sizeofWorkspaceHC()), otherwise it's allocated. */
+static int LZ4HC_compress_optimal (
+    LZ4HC_CCtx_internal* ctx,
+    const char* const source,
+    char* dst,
+    int const inputSize,
+    int const dstCapacity,
+    int const nbSearches,
+    size_t sufficient_len,
+    const limitedOutput_directive limit,
+    int const fullUpdate,
+    LZ4HC_optimal_t* const workspace
+    )
+{
+    int retval = 0;
+#if defined(LZ4HC_HEAPMODE) && LZ4HC_HEAPMODE==1
+    LZ4HC_optimal_t* const opt = (workspace != NULL) ? workspace :
+                                 (LZ4HC_optimal_t*)ALLOC(sizeof(LZ4HC_optimal_t) * (LZ4_OPT_NUM + TRAILING_LITERALS));
+#else
+    LZ4HC_optimal_t optOnStack[LZ4_OPT_NUM + TRAILING_LITERALS];   /* ~64 KB, which can be a bit large for some stacks... */
+    LZ4HC_optimal_t* const opt = (workspace != NULL) ? workspace : optOnStack;
+#endif
+
+    const BYTE* ip = (const BYTE*) source;
+    const BYTE* anchor = ip;
+    const BYTE* const iend = ip + inputSize;
+    const BYTE* const mflimit = iend - MFLIMIT;
+    const BYTE* const matchlimit = iend - LASTLITERALS;
+    BYTE* op = (BYTE*) dst;
+    BYTE* const oend = op + dstCapacity;
+
+#if defined(LZ4HC_HEAPMODE) && LZ4HC_HEAPMODE==1
+    if (opt == NULL) goto _return_label;
+#endif
+
+    if (sufficient_len >= LZ4_OPT_NUM) sufficient_len = LZ4_OPT_NUM-1;
+    if (inputSize < LZ4_minLength) goto _last_literals;   /* Input too small, no compression (all literals) */
+
+    /* Main Loop */
+    while (ip <= mflimit) {
+         int const llen = (int)(ip - anchor);
+         int best_mlen, best_off;
+         int cur, last_match_pos = 0;
+
+         LZ4HC_match_t const firstMatch = LZ4HC_InsertAndFindLongerMatch(ctx, ip, matchlimit, MINMATCH-1, nbSearches);
+         if (firstMatch.len==0) { ip++; continue; }
+
+         if ((size_t)firstMatch.len > sufficient_len) {
+             /* good enough solution : immediate encoding */
+             if (LZ4HC_encodeSequence(UPDATABLE(ip, op, anchor), firstMatch.len, firstMatch.off, limit, oend))
+                 goto _return_label;   /* output too small */
+             continue;
+         }
+
+         /* set prices for first positions (literals) */
+         {   int rPos;
+             for (rPos = 0 ; rPos < MINMATCH ; rPos++) {
+                 int const cost = LZ4HC_literalsPrice(llen + rPos);
+                 opt[rPos].mlen = 1;
+                 opt[rPos].off = 0;
+                 opt[rPos].litlen = llen + rPos;
+                 opt[rPos].price = cost;
+         }   }
+         /* set prices using initial match */
+         {   int const matchML = firstMatch.len;   /* necessarily < sufficient_len < LZ4_OPT_NUM */
+             int const offset = firstMatch.off;
+             int mlen;
+             assert(matchML < LZ4_OPT_NUM);
+             for (mlen = MINMATCH ; mlen <= matchML ; mlen++) {
+                 int const cost = LZ4HC_sequencePrice(llen, mlen);
+                 opt[mlen].mlen = mlen;
+                 opt[mlen].off = offset;
+                 opt[mlen].litlen = llen;
+                 opt[mlen].price = cost;
+         }   }
+         last_match_pos = firstMatch.len;
+         {   int addLit;
+             for (addLit = 1; addLit <= TRAILING_LITERALS; addLit ++) {
+                 opt[last_match_pos+addLit].mlen = 1; /* literal */
+                 opt[last_match_pos+addLit].off = 0;
+                 opt[last_match_pos+addLit].litlen = addLit;
+                 opt[last_match_pos+addLit].price = opt[last_match_pos].price + LZ4HC_literalsPrice(addLit);
+         }   }
+
+         /* check further positions */
+         for (cur = 1; cur < last_match_pos; cur++) {
+             const BYTE* const curPtr = ip + cur;
+             LZ4HC_match_t newMatch;
+
+             if (curPtr > mflimit) break;
+             if (fullUpdate) {
+                 /* not useful to search here if next position has same (or lower) cost */
+                 if ( (opt[cur+1].price <= opt[cur].price)
+                   /* in some cases, next position has same cost, but cost rises sharply after, so a small match would still be beneficial */
+                   && (opt[cur+MINMATCH].price < opt[cur].price + 3/*min seq price*/) )
+                     continue;
+             } else {
+                 /* not useful to search here if next position has same (or lower) cost */
+                 if (opt[cur+1].price <= opt[cur].price) continue;
+             }
+
+             if (fullUpdate)
+                 newMatch = LZ4HC_InsertAndFindLongerMatch(ctx, curPtr, matchlimit, MINMATCH-1, nbSearches);
+             else
+                 /* only test matches of minimum length; slightly faster, but misses a few bytes */
+                 newMatch = LZ4HC_InsertAndFindLongerMatch(ctx, curPtr, matchlimit, last_match_pos - cur, nbSearches);
+             if (!newMatch.len) continue;
+
+             if ( ((size_t)newMatch.len > sufficient_len)
+               || (newMatch.len + cur >= LZ4_OPT_NUM) ) {
+                 /* immediate encoding */
+                 best_mlen = newMatch.len;
+                 best_off = newMatch.off;
+                 last_match_pos = cur + 1;
+                 goto encode;
+             }
+
+             /* before match : set price with literals at beginning */
+             {   int const baseLitlen = opt[cur].litlen;
+                 int litlen;
+                 for (litlen = 1; litlen < MINMATCH; litlen++) {
+                     int const price = opt[cur].price - LZ4HC_literalsPrice(baseLitlen) + LZ4HC_literalsPrice(baseLitlen+litlen);
+                     int const pos = cur + litlen;
+                     if (price < opt[pos].price) {
+                         opt[pos].mlen = 1; /* literal */
+                         opt[pos].off = 0;
+                         opt[pos].litlen = baseLitlen+litlen;
+                         opt[pos].price = price;
+             }   }   }
+
+             /* set prices using match at position = cur */
+             {   int const matchML = newMatch.len;
+                 int ml = MINMATCH;
+
+                 assert(cur + newMatch.len < LZ4_OPT_NUM);
+                 for ( ; ml <= matchML ; ml++) {
+                     int const pos = cur + ml;
+                     int const offset = newMatch.off;
+                     int price;
+                     int ll;
+                     if (opt[cur].mlen == 1) {
+                         ll = opt[cur].litlen;
+                         price = ((cur > ll) ? opt[cur - ll].price : 0)
+                               + LZ4HC_sequencePrice(ll, ml);
+                     } else {
+                         ll = 0;
+                         price = opt[cur].price + LZ4HC_sequencePrice(0, ml);
+                     }
+
+                    assert((U32)price < (U32)INT_MAX);
+                    if ( pos > last_match_pos+TRAILING_LITERALS
+                      || price <= opt[pos].price ) {
+                         assert(pos < LZ4_OPT_NUM);
+                         if ( (ml == matchML)  /* last pos of last match */
+                           && (last_match_pos < pos) )
+                             last_match_pos = pos;
+                         opt[pos].mlen = ml;
+                         opt[pos].off = offset;
+                         opt[pos].litlen = ll;
+                         opt[pos].price = price;
+             }   }   }
+             /* complete following positions with literals */
+             {   int addLit;
+                 for (addLit = 1; addLit <= TRAILING_LITERALS; addLit ++) {
+                     opt[last_match_pos+addLit].mlen = 1; /* literal */
+                     opt[last_match_pos+addLit].off = 0;
+                     opt[last_match_pos+addLit].litlen = addLit;
+                     opt[last_match_pos+addLit].price = opt[last_match_pos].price + LZ4HC_literalsPrice(addLit);
+             }   }
+         }  /* for (cur = 1; cur < last_match_pos; cur++) */
+
+         assert(last_match_pos < LZ4_OPT_NUM + TRAILING_LITERALS);
+         best_mlen = opt[last_match_pos].mlen;
+         best_off = opt[last_match_pos].off;
+         cur = last_match_pos - best_mlen;
+
+encode: /* cur, last_match_pos, best_mlen, best_off must be set */
+         assert(cur < LZ4_OPT_NUM);
+         assert(last_match_pos >= 1);  /* == 1 when only one candidate */
+         {   int candidate_pos = cur;
+             int selected_matchLength = best_mlen;
+             int selected_offset = best_off;
+             while (1) {  /* from end to beginning */
+                 int const next_matchLength = opt[candidate_pos].mlen;  /* can be 1, means literal */
+                 int const next_offset = opt[candidate_pos].off;
+                 opt[candidate_pos].mlen = selected_matchLength;
+                 opt[candidate_pos].off = selected_offset;
+                 selected_matchLength = next_matchLength;
+                 selected_offset = next_offset;
+                 if (next_matchLength > candidate_pos) break; /* last match elected, first match to encode */
+                 assert(next_matchLength > 0);  /* can be 1, means literal */
+                 candidate_pos -= next_matchLength;
+         }   }
+
+         /* encode all recorded sequences in order */
+         {   int rPos = 0;  /* relative position (to ip) */
+             while (rPos < last_match_pos) {
+                 int const ml = opt[rPos].mlen;
+                 int const offset = opt[rPos].off;
+                 if (ml == 1) { ip++; rPos++; continue; }  /* literal; note: can end up with several literals, in which case, skip them */
+                 rPos += ml;
+                 assert(ml >= MINMATCH);
+                 assert((offset >= 1) && (offset <= LZ4_DISTANCE_MAX));
+                 if (LZ4HC_encodeSequence(UPDATABLE(ip, op, anchor), ml, offset, limit, oend))
+                     goto _return_label;   /* output too small */
+         }   }
+     }  /* while (ip <= mflimit) */
+
+_last_literals:
+     if (LZ4HC_encodeLastLiterals(anchor, iend, &op, limit, oend)) goto _return_label;
+
+     /* End */
+     retval = (int) ((char*)op-dst);
+
+_return_label:
+#if defined(LZ4HC_HEAPMODE) && LZ4HC_HEAPMODE==1
+     if (opt != workspace) FREEMEM(opt);
+#endif
+     return retval;
+}
+
+
+/**************************************
+*  HC Compression - entry points
+**************************************/
+static int LZ4HC_compress_generic (
+    LZ4HC_CCtx_internal* const ctx,
+    const char* const src,
+    char* const dst,
+    int const srcSize,
+    int const dstCapacity,
+    int cLevel,
+    limitedOutput_directive limit,
+    LZ4HC_optimal_t* const workspace
+    )
+{
+    cParams_t const cParam = LZ4HC_getCLevelParams(cLevel);
+
+    if ((U32)srcSize > (U32)LZ4_MAX_INPUT_SIZE) return 0;  /* Unsupported input size (too large or negative) */
+    if (dstCapacity < 1) return 0;   /* even an empty input needs one token */
+
+    LZ4HC_init(ctx, (const BYTE*)src);
+    ctx->compressionLevel = (short)cLevel;
+
+    if (cParam.strat == lz4mid) {
+        return LZ4MID_compress(ctx, src, dst, srcSize, dstCapacity, limit);
+    } else if (cParam.strat == lz4hc) {
+        return LZ4HC_compress_hashChain(ctx, src, dst, srcSize, dstCapacity,
+                                        cParam.nbSearches, (int)cParam.targetLength, limit);
+    } else {
+        assert(cParam.strat == lz4opt);
+        return LZ4HC_compress_optimal(ctx, src, dst, srcSize, dstCapacity,
+                                      cParam.nbSearches, cParam.targetLength, limit,
+                                      cLevel == LZ4HC_CLEVEL_MAX,   /* ultra mode */
+                                      workspace);
+    }
+}
+
+
+int LZ4_sizeofStateHC(void) { return (int)sizeof(LZ4_streamHC_t); }
+
+static size_t LZ4_streamHC_t_alignment(void)
+{
+#if LZ4_ALIGN_TEST
+    typedef struct { char c; LZ4_streamHC_t t; } t_a;
+    return sizeof(t_a) - sizeof(LZ4_streamHC_t);
+#else
+    return 1;  /* effectively disabled */
+#endif
+}
+
+LZ4_streamHC_t* LZ4_initStreamHC (void* buffer, size_t size)
+{
+    LZ4_streamHC_t* const LZ4_streamHCPtr = (LZ4_streamHC_t*)buffer;
+    DEBUGLOG(4, "LZ4_initStreamHC(%p, %u)", buffer, (unsigned)size);
+    /* check conditions */
+    if (buffer == NULL) return NULL;
+    if (size < sizeof(LZ4_streamHC_t)) return NULL;
+    if (!LZ4_isAligned(buffer, LZ4_streamHC_t_alignment())) return NULL;
+    /* init */
+    {   LZ4HC_CCtx_internal* const hcstate = &(LZ4_streamHCPtr->internal_donotuse);
+        MEM_INIT(hcstate, 0, sizeof(*hcstate)); }
+    LZ4_streamHCPtr->internal_donotuse.compressionLevel = LZ4HC_CLEVEL_DEFAULT;
+    return LZ4_streamHCPtr;
+}
+
+int LZ4_sizeofWorkspaceHC(void) { return (int)(sizeof(LZ4HC_optimal_t) * (LZ4_OPT_NUM + TRAILING_LITERALS)); }
+
+int LZ4_compress_HC_extStateHC_workspace (void* state, void* workspace, const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
+{
+    LZ4HC_CCtx_internal* const ctx = &((LZ4_streamHC_t*)state)->internal_donotuse;
+    if (((size_t)(state)&(sizeof(void*)-1)) != 0) return 0;   /* Error : state is not aligned for pointers (32 or 64 bits) */
+    if (((size_t)(workspace)&(sizeof(int)-1)) != 0) return 0;   /* Error : workspace is not aligned for int */
+    if (dstCapacity < LZ4_compressBound(srcSize))
+        return LZ4HC_compress_generic (ctx, src, dst, srcSize, dstCapacity, compressionLevel, limitedOutput, (LZ4HC_optimal_t*)workspace);
+    else
+        return LZ4HC_compress_generic (ctx, src, dst, srcSize, dstCapacity, compressionLevel, notLimited, (LZ4HC_optimal_t*)workspace);
+}
+
+int LZ4_compress_HC_extStateHC (void* state, const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
+{
+    return LZ4_compress_HC_extStateHC_workspace(state, NULL, src, dst, srcSize, dstCapacity, compressionLevel);
+}
+
+int LZ4_compress_HC(const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel)
+{
+    int cSize;
+#if defined(LZ4HC_HEAPMODE) && LZ4HC_HEAPMODE==1
+    LZ4_streamHC_t* const statePtr = (LZ4_streamHC_t*)ALLOC(sizeof(LZ4_streamHC_t));
+    if (statePtr==NULL) return 0;
+#else
+    LZ4_streamHC_t state;
+    LZ4_streamHC_t* const statePtr = &state;
+#endif
+    DEBUGLOG(5, "LZ4_compress_HC")
+    cSize = LZ4_compress_HC_extStateHC(statePtr, src, dst, srcSize, dstCapacity, compressionLevel);
+#if defined(LZ4HC_HEAPMODE) && LZ4HC_HEAPMODE==1
+    FREEMEM(statePtr);
+#endif
+    return cSize;
+}
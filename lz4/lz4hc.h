@@ -0,0 +1,152 @@
+/*
+   LZ4 HC - High Compression Mode of LZ4
+   Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef LZ4_HC_H_19834876238432
+#define LZ4_HC_H_19834876238432
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* --- Dependency --- */
+/* note : lz4hc requires lz4.h/lz4.c for compilation */
+#include "lz4.h"   /* stddef, LZ4LIB_API, LZ4_DEPRECATED */
+
+
+/* --- Useful constants --- */
+#define LZ4HC_CLEVEL_MIN         2
+#define LZ4HC_CLEVEL_DEFAULT     9
+#define LZ4HC_CLEVEL_OPT_MIN    10
+#define LZ4HC_CLEVEL_MAX        12
+
+
+/*-************************************
+ *  Block Compression
+ **************************************/
+/*! LZ4_compress_HC() :
+ *  Compress data from `src` into `dst`, using the powerful but slower "HC" algorithm.
+ * `dst` must be already allocated.
+ *  Compression is guaranteed to succeed if `dstCapacity >= LZ4_compressBound(srcSize)` (see "lz4.h")
+ *  Max supported `srcSize` value is LZ4_MAX_INPUT_SIZE (see "lz4.h")
+ * `compressionLevel` : levels range from LZ4HC_CLEVEL_MIN to LZ4HC_CLEVEL_MAX.
+ *                      Level 1 behaves the same as LZ4HC_CLEVEL_MIN, values < 1 select LZ4HC_CLEVEL_DEFAULT,
+ *                      and values > LZ4HC_CLEVEL_MAX behave the same as LZ4HC_CLEVEL_MAX.
+ *                      Level LZ4HC_CLEVEL_MIN uses a "double fast" strategy : one probe into a table
+ *                      of 8-byte sequences (long matches), then into a table of 4-byte sequences (short matches).
+ *                      On the 1 MB text and structured inputs of `lz4_bench -a 1 -hc 2` (one x86 machine),
+ *                      it ran at 53-59% of LZ4_compress_fast() speed, for a 10-18% better ratio.
+ *                      Levels (LZ4HC_CLEVEL_MIN, LZ4HC_CLEVEL_OPT_MIN) use a hash chain with lazy matching,
+ *                      searching more candidates as level increases.
+ *                      Levels [LZ4HC_CLEVEL_OPT_MIN, LZ4HC_CLEVEL_MAX] use an optimal parser.
+ * @return : the number of bytes written into 'dst'
+ *           or 0 if compression fails.
+ *  Note : the generated blocks follow the regular LZ4 block format.
+ *         They are decoded by LZ4_decompress_safe(), at the same speed as blocks produced by LZ4_compress_fast().
+ */
+LZ4LIB_API int LZ4_compress_HC (const char* src, char* dst, int srcSize, int dstCapacity, int compressionLevel);
+
+
+/*! LZ4_compress_HC_extStateHC() :
+ *  Same as LZ4_compress_HC(), but using an externally allocated memory segment for `state`.
+ * `state` size is provided by LZ4_sizeofStateHC().
+ *  Memory segment must be aligned on 8-bytes boundaries (which a normal malloc() should do properly).
+ */
+LZ4LIB_API int LZ4_sizeofStateHC(void);
+LZ4LIB_API int LZ4_compress_HC_extStateHC(void* stateHC, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel);
+
+/*! LZ4_compress_HC_extStateHC_workspace() :
+ *  Same as LZ4_compress_HC_extStateHC(), but levels >= LZ4HC_CLEVEL_OPT_MIN also take
+ *  the optimal parser's table from `workspace`, instead of allocating it (see LZ4HC_HEAPMODE),
+ *  so that compression doesn't allocate anything.
+ * `workspace` size is provided by LZ4_sizeofWorkspaceHC(), and it must be aligned on 4-bytes boundaries.
+ *  It can be NULL, in which case this function is LZ4_compress_HC_extStateHC().
+ */
+LZ4LIB_API int LZ4_sizeofWorkspaceHC(void);
+LZ4LIB_API int LZ4_compress_HC_extStateHC_workspace(void* stateHC, void* workspace, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel);
+
+
+/*^**********************************************
+ * !!!!!!   STATIC LINKING ONLY   !!!!!!
+ ***********************************************/
+
+/*-******************************************************************
+ * PRIVATE DEFINITIONS :
+ * Do not use these definitions directly.
+ * They are merely exposed to allow static allocation of `LZ4_streamHC_t`.
+ * Declare an `LZ4_streamHC_t` directly, rather than any type below.
+ * Even then, only do so in the context of static linking, as definitions may change between versions.
+ ********************************************************************/
+
+#define LZ4HC_DICTIONARY_LOGSIZE 16
+#define LZ4HC_MAXD (1<<LZ4HC_DICTIONARY_LOGSIZE)
+#define LZ4HC_MAXD_MASK (LZ4HC_MAXD - 1)
+
+#define LZ4HC_HASH_LOG 15
+#define LZ4HC_HASHTABLESIZE (1 << LZ4HC_HASH_LOG)
+#define LZ4HC_HASH_MASK (LZ4HC_HASHTABLESIZE - 1)
+
+
+/* Never ever use these definitions directly !
+ * Declare or allocate an LZ4_streamHC_t instead.
+**/
+typedef struct LZ4HC_CCtx_internal LZ4HC_CCtx_internal;
+struct LZ4HC_CCtx_internal
+{
+    LZ4_u32   hashTable[LZ4HC_HASHTABLESIZE];
+    LZ4_u16   chainTable[LZ4HC_MAXD];
+    const LZ4_byte* base;       /* index 0 position; all indexes are relative to base */
+    LZ4_u32   lowLimit;         /* smallest valid index : start of the block being compressed */
+    LZ4_u32   nextToUpdate;     /* index from which to continue hash chain updates */
+    short     compressionLevel;
+};
+
+#define LZ4_STREAMHC_MINSIZE  262200  /* static size, for inter-version compatibility */
+union LZ4_streamHC_u {
+    char minStateSize[LZ4_STREAMHC_MINSIZE];
+    LZ4HC_CCtx_internal internal_donotuse;
+}; /* previously typedef'd to LZ4_streamHC_t */
+
+typedef union LZ4_streamHC_u LZ4_streamHC_t;
+
+/*! LZ4_initStreamHC() :
+ *  Prepares an allocated memory segment of sufficient size and alignment
+ *  to be used as state by LZ4_compress_HC_extStateHC().
+ *  Requires size >= sizeof(LZ4_streamHC_t) and 8-bytes alignment.
+ * @return : pointer of proper type upon initialization, or NULL if conditions are not respected.
+ *  Note : LZ4_compress_HC_extStateHC() initializes its state by itself,
+ *         so this is only useful to validate a statically allocated buffer.
+ */
+LZ4LIB_API LZ4_streamHC_t* LZ4_initStreamHC(void* buffer, size_t size);
+
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* LZ4_HC_H_19834876238432 */
@@ -0,0 +1,356 @@
+#define _FILE_OFFSET_BITS 64
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lz4frame.h"
+
+// File compressor / decompressor working on memory-mapped files, producing LZ4 frames.
+//
+// usage : lz4mmap [-d] [-l LEVEL] [-B 4..7] INPUT OUTPUT     (OUTPUT can be '-' for stdout)
+//
+// The input is mapped read-only, and handed to LZ4F with stableSrc :
+// blocks are compressed straight from the mapping, and linked blocks reference
+// their history within it (LZ4_compress_fast_continue()), so source data is never copied.
+// When the output is a regular file, it is mapped too, and frames are written straight into it.
+// Otherwise, output goes through one page-aligned buffer, flushed with large write() calls.
+// Decompression into a regular file maps the output when the frame header declares its content size,
+// and decodes into it with stableDst ; other frames go through the aligned buffer.
+
+#define CHUNK_SIZE        (64U << 20)   // input fed per LZ4F call, a multiple of every block size
+#define WRITE_BUFFER_SIZE (16U << 20)  // fits the compressed bound of two 4 MB blocks
+#define PAGE_ALIGNMENT    4096
+#define LZ4F_SKIPPABLE_MAGIC_MASK 0xFFFFFFF0U
+
+typedef struct {
+    int fd;
+    int regular;          // output is a regular file : written at tracked offsets
+    int mappable;         // regular file which can be mapped (some filesystems refuse)
+    char* buffer;         // aligned buffer, for non-mapped output
+    size_t buffered;
+    unsigned long long size;   // bytes written so far
+} output_file;
+
+static int fail(const char* what) {
+    fprintf(stderr, "lz4mmap : %s%s%s\n", what, errno ? " : " : "", errno ? strerror(errno) : "");
+    return 1;
+}
+
+static unsigned read_le32(const void* p) {
+    const unsigned char* const b = (const unsigned char*)p;
+    return (unsigned)b[0] | ((unsigned)b[1] << 8) | ((unsigned)b[2] << 16) | ((unsigned)b[3] << 24);
+}
+
+static int write_all(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t const w = write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+
+// --- Output ---
+
+static int output_open(output_file* out, const char* name) {
+    struct stat st;
+    memset(out, 0, sizeof(*out));
+    out->fd = strcmp(name, "-") ? open(name, O_RDWR | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (out->fd < 0) return -1;
+    if (fstat(out->fd, &st) < 0) return -1;
+    out->regular = out->mappable = S_ISREG(st.st_mode);
+    if (out->regular && out->fd == STDOUT_FILENO) {
+        // a redirected stdout may already hold data : continue from its current offset
+        off_t const pos = lseek(out->fd, 0, SEEK_CUR);
+        if (pos < 0) return -1;
+        out->size = (unsigned long long)pos;
+    }
+    if (posix_memalign((void**)&out->buffer, PAGE_ALIGNMENT, WRITE_BUFFER_SIZE) != 0) return -1;
+    return 0;
+}
+
+// a regular output is also written through mappings, which don't move the file offset :
+// write at the tracked end
+static int output_flush(output_file* out) {
+    if (out->buffered == 0) return 0;
+    if (out->regular) {
+        size_t done = 0;
+        while (done < out->buffered) {
+            ssize_t const w = pwrite(out->fd, out->buffer + done, out->buffered - done, (off_t)(out->size + done));
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0) return -1;
+            done += (size_t)w;
+        }
+    } else if (write_all(out->fd, out->buffer, out->buffered) < 0) {
+        return -1;
+    }
+    out->size += out->buffered;
+    out->buffered = 0;
+    return 0;
+}
+
+// mapping of `capacity` bytes, starting at the current end of a regular output.
+// `*base` and `*baseSize` receive what to unmap later : mappings must start on a page boundary.
+// @return : NULL if the output can't be mapped, in which case it's no longer tried.
+static char* output_map(output_file* out, size_t capacity, char** base, size_t* baseSize) {
+    long const page = sysconf(_SC_PAGESIZE);
+    unsigned long long const start = out->size - out->size % (unsigned long long)page;
+    size_t const lead = (size_t)(out->size - start);
+    void* p;
+    if (!out->mappable) return NULL;
+    if (output_flush(out) < 0) return NULL;
+    p = MAP_FAILED;
+    if (ftruncate(out->fd, (off_t)(out->size + capacity)) == 0)
+        p = mmap(NULL, lead + capacity, PROT_READ | PROT_WRITE, MAP_SHARED, out->fd, (off_t)start);
+    if (p == MAP_FAILED) {
+        out->mappable = 0;
+        if (ftruncate(out->fd, (off_t)out->size) < 0) { /* reported by the next write */ }
+        return NULL;
+    }
+    *base = (char*)p;
+    *baseSize = lead + capacity;
+    return (char*)p + lead;
+}
+
+// ends a mapping obtained from output_map(), `used` bytes having been written
+static int output_unmap(output_file* out, char* base, size_t baseSize, size_t used) {
+    out->size += used;
+    if (munmap(base, baseSize) < 0) return -1;
+    return ftruncate(out->fd, (off_t)out->size);
+}
+
+static int output_close(output_file* out) {
+    int r = output_flush(out);
+    free(out->buffer);
+    // writes at tracked offsets left the file offset alone : move it past what was written
+    if (out->regular && out->fd == STDOUT_FILENO && lseek(out->fd, (off_t)out->size, SEEK_SET) < 0) r = -1;
+    if (out->fd != STDOUT_FILENO && close(out->fd) < 0) r = -1;
+    return r;
+}
+
+
+// --- Compression ---
+
+static int compress_file(const char* src, size_t srcSize, output_file* out, int level, int blockSizeID) {
+    LZ4F_preferences_t prefs;
+    LZ4F_compressOptions_t options;
+    LZ4F_cctx* cctx;
+    size_t pos = 0;
+    int result = 1;
+
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.frameInfo.blockSizeID = (LZ4F_blockSizeID_t)blockSizeID;
+    prefs.frameInfo.blockMode = LZ4F_blockLinked;
+    prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+    prefs.frameInfo.contentSize = srcSize;
+    prefs.compressionLevel = level;
+    prefs.autoFlush = 1;
+    memset(&options, 0, sizeof(options));
+    options.stableSrc = 1;
+
+    if (LZ4F_isError(LZ4F_createCompressionContext(&cctx, LZ4F_VERSION))) return fail("cannot create compression context");
+
+    if (out->mappable) {
+        // the whole frame is written into one mapping, trimmed at the end
+        size_t const bound = LZ4F_compressFrameBound(srcSize, &prefs);
+        char* base;
+        size_t baseSize;
+        char* const dst = output_map(out, bound, &base, &baseSize);
+        size_t dstPos, r;
+        if (dst == NULL) goto _buffered;
+        madvise(base, baseSize, MADV_SEQUENTIAL);
+        r = LZ4F_compressBegin(cctx, dst, bound, &prefs);
+        if (LZ4F_isError(r)) { result = fail(LZ4F_getErrorName(r)); goto _end; }
+        dstPos = r;
+        while (pos < srcSize) {
+            size_t const chunk = (srcSize - pos < CHUNK_SIZE) ? srcSize - pos : CHUNK_SIZE;
+            r = LZ4F_compressUpdate(cctx, dst + dstPos, bound - dstPos, src + pos, chunk, &options);
+            if (LZ4F_isError(r)) { result = fail(LZ4F_getErrorName(r)); goto _end; }
+            dstPos += r;
+            pos += chunk;
+        }
+        r = LZ4F_compressEnd(cctx, dst + dstPos, bound - dstPos, &options);
+        if (LZ4F_isError(r)) { result = fail(LZ4F_getErrorName(r)); goto _end; }
+        dstPos += r;
+        if (output_unmap(out, base, baseSize, dstPos) < 0) { result = fail("cannot write output"); goto _end; }
+        result = 0;
+        goto _end;
+    }
+
+_buffered:
+    {   // chunks are sized so that their compressed bound fits into the write buffer
+        size_t chunkSize = CHUNK_SIZE;
+        size_t r;
+        while (LZ4F_compressBound(chunkSize, &prefs) > WRITE_BUFFER_SIZE) chunkSize /= 2;
+        r = LZ4F_compressBegin(cctx, out->buffer, WRITE_BUFFER_SIZE, &prefs);
+        if (LZ4F_isError(r)) { result = fail(LZ4F_getErrorName(r)); goto _end; }
+        out->buffered = r;
+        while (pos < srcSize) {
+            size_t const chunk = (srcSize - pos < chunkSize) ? srcSize - pos : chunkSize;
+            if (out->buffered + LZ4F_compressBound(chunk, &prefs) > WRITE_BUFFER_SIZE
+              && output_flush(out) < 0) { result = fail("cannot write output"); goto _end; }
+            r = LZ4F_compressUpdate(cctx, out->buffer + out->buffered, WRITE_BUFFER_SIZE - out->buffered,
+                                    src + pos, chunk, &options);
+            if (LZ4F_isError(r)) { result = fail(LZ4F_getErrorName(r)); goto _end; }
+            out->buffered += r;
+            pos += chunk;
+        }
+        if (output_flush(out) < 0) { result = fail("cannot write output"); goto _end; }
+        r = LZ4F_compressEnd(cctx, out->buffer, WRITE_BUFFER_SIZE, &options);
+        if (LZ4F_isError(r)) { result = fail(LZ4F_getErrorName(r)); goto _end; }
+        out->buffered = r;
+    }
+    result = 0;
+
+_end:
+    LZ4F_freeCompressionContext(cctx);
+    return result;
+}
+
+
+// --- Decompression ---
+
+// decodes one frame, whose header has already been consumed by LZ4F_getFrameInfo().
+// @return : nb of source bytes consumed, or (size_t)-1 on error
+static size_t decompress_frame(LZ4F_dctx* dctx, const LZ4F_frameInfo_t* info,
+                               const char* src, size_t srcSize, output_file* out) {
+    LZ4F_decompressOptions_t options;
+    size_t srcPos = 0;
+    size_t hint = 1;
+    memset(&options, 0, sizeof(options));
+
+    // LZ4 can't expand data more than 255x : a larger content size is corrupted,
+    // and is left to the decoder to reject, rather than mapped
+    if (out->mappable && info->contentSize > 0
+      && info->contentSize / 255 <= (unsigned long long)srcSize + 1) {
+        // decode straight into the output file, which keeps the history of linked blocks
+        size_t const contentSize = (size_t)info->contentSize;
+        size_t dstPos = 0;
+        char* base;
+        size_t baseSize;
+        char* const dst = output_map(out, contentSize, &base, &baseSize);
+        if (dst == NULL) goto _buffered;
+        madvise(base, baseSize, MADV_SEQUENTIAL);
+        options.stableDst = 1;
+        while (hint != 0 && srcPos < srcSize) {
+            size_t dstAvail = contentSize - dstPos;
+            size_t srcAvail = srcSize - srcPos;
+            hint = LZ4F_decompress(dctx, dst + dstPos, &dstAvail, src + srcPos, &srcAvail, &options);
+            if (LZ4F_isError(hint)) { fprintf(stderr, "lz4mmap : %s\n", LZ4F_getErrorName(hint)); break; }
+            if (dstAvail == 0 && srcAvail == 0) {
+                // output full before the end of the frame : its content size is wrong
+                fprintf(stderr, "lz4mmap : frame content size too small\n");
+                break;
+            }
+            dstPos += dstAvail;
+            srcPos += srcAvail;
+        }
+        if (output_unmap(out, base, baseSize, dstPos) < 0 || hint != 0) return (size_t)-1;
+        return srcPos;
+    }
+
+_buffered:
+    while (hint != 0 && srcPos < srcSize) {
+        size_t dstAvail = WRITE_BUFFER_SIZE - out->buffered;
+        size_t srcAvail = srcSize - srcPos;
+        hint = LZ4F_decompress(dctx, out->buffer + out->buffered, &dstAvail, src + srcPos, &srcAvail, &options);
+        if (LZ4F_isError(hint)) { fprintf(stderr, "lz4mmap : %s\n", LZ4F_getErrorName(hint)); return (size_t)-1; }
+        out->buffered += dstAvail;
+        srcPos += srcAvail;
+        if (out->buffered == WRITE_BUFFER_SIZE || hint == 0) {
+            if (output_flush(out) < 0) return (size_t)-1;
+        }
+    }
+    if (hint != 0) return (size_t)-1;
+    return srcPos;
+}
+
+static int decompress_file(const char* src, size_t srcSize, output_file* out) {
+    LZ4F_dctx* dctx;
+    size_t pos = 0;
+    int result = 1;
+
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) return fail("cannot create decompression context");
+    while (pos < srcSize) {
+        LZ4F_frameInfo_t info;
+        size_t headerSize = srcSize - pos;
+        size_t r;
+        if (srcSize - pos >= 8 && (read_le32(src + pos) & LZ4F_SKIPPABLE_MAGIC_MASK) == LZ4F_MAGIC_SKIPPABLE_START) {
+            size_t const skip = 8 + (size_t)read_le32(src + pos + 4);
+            if (skip > srcSize - pos) { fprintf(stderr, "lz4mmap : truncated skippable frame\n"); goto _end; }
+            pos += skip;
+            continue;
+        }
+        r = LZ4F_getFrameInfo(dctx, &info, src + pos, &headerSize);
+        if (LZ4F_isError(r)) { fprintf(stderr, "lz4mmap : %s\n", LZ4F_getErrorName(r)); goto _end; }
+        pos += headerSize;
+        r = decompress_frame(dctx, &info, src + pos, srcSize - pos, out);
+        if (r == (size_t)-1) { fprintf(stderr, "lz4mmap : corrupted or truncated frame\n"); goto _end; }
+        pos += r;
+    }
+    result = 0;
+
+_end:
+    LZ4F_freeDecompressionContext(dctx);
+    return result;
+}
+
+
+// --- Command line ---
+
+static int usage(const char* name) {
+    fprintf(stderr, "usage : %s [-d] [-l LEVEL] [-B 4..7] INPUT OUTPUT\n", name);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    int decompress = 0, level = 0, blockSizeID = LZ4F_max4MB;
+    const char* inName = NULL;
+    const char* outName = NULL;
+    output_file out;
+    struct stat st;
+    const char* src = NULL;
+    size_t srcSize;
+    int fd, i, result;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-d")) decompress = 1;
+        else if (!strcmp(argv[i], "-l") && i + 1 < argc) level = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-B") && i + 1 < argc) {
+            blockSizeID = atoi(argv[++i]);
+            if (blockSizeID < LZ4F_max64KB || blockSizeID > LZ4F_max4MB) return usage(argv[0]);
+        }
+        else if (inName == NULL) inName = argv[i];
+        else if (outName == NULL) outName = argv[i];
+        else return usage(argv[0]);
+    }
+    if (inName == NULL || outName == NULL) return usage(argv[0]);
+
+    fd = open(inName, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) return fail(inName);
+    srcSize = (size_t)st.st_size;
+    if (srcSize > 0) {
+        void* const p = mmap(NULL, srcSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return fail("cannot map input");
+        madvise(p, srcSize, MADV_SEQUENTIAL);
+        src = (const char*)p;
+    }
+    if (output_open(&out, outName) < 0) return fail(outName);
+
+    result = decompress ? decompress_file(src, srcSize, &out)
+                        : compress_file(src, srcSize, &out, level, blockSizeID);
+
+    if (output_close(&out) < 0 && result == 0) result = fail("cannot write output");
+    if (srcSize > 0) munmap((void*)(size_t)src, srcSize);
+    close(fd);
+    return result;
+}
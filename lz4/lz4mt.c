@@ -0,0 +1,458 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Multi-threaded block-parallel API
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <stdlib.h>     /* malloc, free */
+#include <string.h>     /* memcpy */
+#include <pthread.h>
+#include <unistd.h>     /* sysconf */
+#include "lz4mt.h"
+
+
+/*-************************************
+*  Basic Types
+**************************************/
+#if defined(__cplusplus) || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */)
+# include <stdint.h>
+  typedef uint8_t  BYTE;
+  typedef uint32_t U32;
+  typedef uint64_t U64;
+#else
+  typedef unsigned char       BYTE;
+  typedef unsigned int        U32;
+  typedef unsigned long long  U64;
+#endif
+
+
+/*-************************************
+*  Memory routines
+**************************************/
+static U32 LZ4MT_readLE32(const void* src)
+{
+    const BYTE* const p = (const BYTE*)src;
+    return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+}
+
+static void LZ4MT_writeLE32(void* dst, U32 value32)
+{
+    BYTE* const p = (BYTE*)dst;
+    p[0] = (BYTE)value32;
+    p[1] = (BYTE)(value32 >> 8);
+    p[2] = (BYTE)(value32 >> 16);
+    p[3] = (BYTE)(value32 >> 24);
+}
+
+
+/*-************************************
+*  Worker pool
+**************************************/
+typedef void* (*LZ4MT_worker_f)(void* arg);
+
+static int LZ4MT_nbCores(void)
+{
+    long const n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    if (n > LZ4MT_NBWORKERS_MAX) return LZ4MT_NBWORKERS_MAX;
+    return (int)n;
+}
+
+static int LZ4MT_selectNbWorkers(int nbWorkers, int nbJobs)
+{
+    if (nbWorkers <= 0) nbWorkers = LZ4MT_nbCores();
+    if (nbWorkers > LZ4MT_NBWORKERS_MAX) nbWorkers = LZ4MT_NBWORKERS_MAX;
+    if (nbWorkers > nbJobs) nbWorkers = nbJobs;
+    if (nbWorkers < 1) nbWorkers = 1;
+    return nbWorkers;
+}
+
+/* LZ4MT_runWorkers() :
+ * starts nbWorkers-1 threads, and runs one more worker within the calling thread.
+ * Workers are expected to fetch their jobs from the shared context,
+ * so a failure to start some threads only reduces parallelism : all jobs still get done. */
+static void LZ4MT_runWorkers(LZ4MT_worker_f worker, void* ctx, int nbWorkers)
+{
+    pthread_t threads[LZ4MT_NBWORKERS_MAX];
+    int nbStarted = 0;
+    int n;
+
+    for (n = 1; n < nbWorkers; n++) {
+        if (pthread_create(&threads[nbStarted], NULL, worker, ctx) != 0) break;
+        nbStarted++;
+    }
+    worker(ctx);
+    for (n = 0; n < nbStarted; n++) pthread_join(threads[n], NULL);
+}
+
+
+/*-************************************
+*  Compression
+**************************************/
+#define LZ4MT_LINK_SIZE (64 << 10)   /* history a linked block may reference : LZ4's whole window */
+
+static int LZ4MT_clampBlockSize(int blockSize)
+{
+    if (blockSize <= 0) return LZ4MT_BLOCKSIZE_DEFAULT;
+    if (blockSize < LZ4MT_BLOCKSIZE_MIN) return LZ4MT_BLOCKSIZE_MIN;
+    if (blockSize > LZ4MT_BLOCKSIZE_MAX) return LZ4MT_BLOCKSIZE_MAX;
+    return blockSize;
+}
+
+static int LZ4MT_nbBlocks(int srcSize, int blockSize)
+{
+    return (int)(((U64)srcSize + (U64)blockSize - 1) / (U64)blockSize);
+}
+
+int LZ4_compressBound_parallel(int srcSize, int blockSize)
+{
+    if (srcSize < 0 || srcSize > LZ4_MAX_INPUT_SIZE) return 0;
+    blockSize = LZ4MT_clampBlockSize(blockSize);
+    {   int const nbBlocks = LZ4MT_nbBlocks(srcSize, blockSize);
+        int const lastBlockSize = srcSize - (nbBlocks - 1) * blockSize;
+        U64 bound = LZ4MT_HEADER_SIZE + 4 * (U64)nbBlocks;
+        if (nbBlocks > 0) {
+            bound += (U64)(nbBlocks - 1) * (U64)LZ4_compressBound(blockSize);
+            bound += (U64)LZ4_compressBound(lastBlockSize);
+        }
+        if (bound > (U64)LZ4_MAX_INPUT_SIZE) return 0;
+        return (int)bound;
+    }
+}
+
+typedef struct {
+    const char* src;
+    char* dst;
+    int srcSize;
+    int dstCapacity;
+    int blockSize;
+    int nbBlocks;
+    int acceleration;
+    U32 flags;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  committed;
+    int nextBlock;      /* next block to hand out */
+    int nbCommitted;    /* blocks [0, nbCommitted) have a known position in dst */
+    int* cSizes;        /* compressed size of each block, 0 while pending */
+    size_t* positions;  /* valid for blocks <= nbCommitted */
+    int error;
+} LZ4MT_cctx;
+
+/* LZ4MT_commit() :
+ * must be called with ctx->mutex locked.
+ * Advances the commit point over all consecutive finished blocks,
+ * which gives their successor a position within dst. */
+static void LZ4MT_commit(LZ4MT_cctx* ctx)
+{
+    while (ctx->nbCommitted < ctx->nbBlocks && ctx->cSizes[ctx->nbCommitted] > 0) {
+        int const n = ctx->nbCommitted;
+        ctx->positions[n+1] = ctx->positions[n] + (size_t)ctx->cSizes[n];
+        ctx->nbCommitted++;
+    }
+    pthread_cond_broadcast(&ctx->committed);
+}
+
+static void LZ4MT_setError(LZ4MT_cctx* ctx)
+{
+    pthread_mutex_lock(&ctx->mutex);
+    ctx->error = 1;
+    pthread_cond_broadcast(&ctx->committed);
+    pthread_mutex_unlock(&ctx->mutex);
+}
+
+/* LZ4MT_compressBlock() :
+ * A linked block is primed with the tail of the previous block, read straight from src.
+ * Since this history immediately precedes the block, LZ4_compress_fast_continue()
+ * runs in prefix mode, as fast as a single stream would. */
+static int LZ4MT_compressBlock(const LZ4MT_cctx* ctx, LZ4_stream_t* state,
+                               const char* blockStart, char* dst, int blockSize, int dstCapacity)
+{
+    if ((ctx->flags & LZ4MT_FLAG_LINKED) && blockStart != ctx->src) {
+        LZ4_loadDict(state, blockStart - LZ4MT_LINK_SIZE, LZ4MT_LINK_SIZE);
+        return LZ4_compress_fast_continue(state, blockStart, dst, blockSize, dstCapacity, ctx->acceleration);
+    }
+    return LZ4_compress_fast_extState(state, blockStart, dst, blockSize, dstCapacity, ctx->acceleration);
+}
+
+static void* LZ4MT_compressWorker(void* arg)
+{
+    LZ4MT_cctx* const ctx = (LZ4MT_cctx*)arg;
+    int const scratchCapacity = LZ4_compressBound(ctx->blockSize);
+    LZ4_stream_t* const state = (LZ4_stream_t*)malloc(sizeof(LZ4_stream_t));   /* malloc() is properly aligned for LZ4_stream_t */
+    char* const scratch = (char*)malloc((size_t)scratchCapacity);
+
+    if (state == NULL || scratch == NULL) {
+        free(state); free(scratch);
+        LZ4MT_setError(ctx);
+        return NULL;
+    }
+    LZ4_initStream(state, sizeof(*state));
+
+    while (1) {
+        int blockNb, direct, cSize, error;
+        size_t pos;
+
+        pthread_mutex_lock(&ctx->mutex);
+        if (ctx->error || ctx->nextBlock >= ctx->nbBlocks) {
+            pthread_mutex_unlock(&ctx->mutex);
+            break;
+        }
+        blockNb = ctx->nextBlock++;
+        /* when all previous blocks are committed, the block's position is already known :
+         * compress it straight into dst, skipping the scratch copy */
+        direct = (ctx->nbCommitted == blockNb);
+        pos = direct ? ctx->positions[blockNb] : 0;
+        pthread_mutex_unlock(&ctx->mutex);
+
+        {   const char* const blockStart = ctx->src + (size_t)blockNb * (size_t)ctx->blockSize;
+            int const blockSize = (blockNb == ctx->nbBlocks - 1) ?
+                                  ctx->srcSize - blockNb * ctx->blockSize : ctx->blockSize;
+            if (direct) {
+                if (pos >= (size_t)ctx->dstCapacity) { LZ4MT_setError(ctx); break; }
+                cSize = LZ4MT_compressBlock(ctx, state, blockStart, ctx->dst + pos, blockSize,
+                                            ctx->dstCapacity - (int)pos);
+            } else {
+                cSize = LZ4MT_compressBlock(ctx, state, blockStart, scratch, blockSize, scratchCapacity);
+            }
+        }
+        if (cSize <= 0) { LZ4MT_setError(ctx); break; }
+
+        pthread_mutex_lock(&ctx->mutex);
+        ctx->cSizes[blockNb] = cSize;
+        LZ4MT_commit(ctx);
+        while (!ctx->error && ctx->nbCommitted <= blockNb) {
+            pthread_cond_wait(&ctx->committed, &ctx->mutex);
+        }
+        error = ctx->error;
+        if (!error) pos = ctx->positions[blockNb];
+        pthread_mutex_unlock(&ctx->mutex);
+        if (error) break;
+
+        if (!direct) {
+            if (pos + (size_t)cSize > (size_t)ctx->dstCapacity) { LZ4MT_setError(ctx); break; }
+            memcpy(ctx->dst + pos, scratch, (size_t)cSize);
+        }
+        LZ4MT_writeLE32(ctx->dst + LZ4MT_HEADER_SIZE + 4 * (size_t)blockNb, (U32)cSize);
+    }
+
+    free(scratch);
+    free(state);
+    return NULL;
+}
+
+static int LZ4MT_compress_generic(const char* src, char* dst,
+                                  int srcSize, int dstCapacity,
+                                  int acceleration, int blockSize, int nbWorkers, U32 flags)
+{
+    LZ4MT_cctx ctx;
+    size_t headerSize;
+    int result;
+
+    if (srcSize < 0 || srcSize > LZ4_MAX_INPUT_SIZE) return 0;
+    if (src == NULL && srcSize > 0) return 0;
+    if (dst == NULL || dstCapacity <= 0) return 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.src = src;
+    ctx.dst = dst;
+    ctx.srcSize = srcSize;
+    ctx.dstCapacity = dstCapacity;
+    ctx.blockSize = LZ4MT_clampBlockSize(blockSize);
+    ctx.nbBlocks = LZ4MT_nbBlocks(srcSize, ctx.blockSize);
+    ctx.acceleration = acceleration;
+    ctx.flags = flags;
+
+    headerSize = LZ4MT_HEADER_SIZE + 4 * (size_t)ctx.nbBlocks;
+    if (headerSize > (size_t)dstCapacity) return 0;
+
+    ctx.cSizes = (int*)calloc((size_t)ctx.nbBlocks + 1, sizeof(int));
+    ctx.positions = (size_t*)malloc(((size_t)ctx.nbBlocks + 1) * sizeof(size_t));
+    if (ctx.cSizes == NULL || ctx.positions == NULL) {
+        free(ctx.cSizes); free(ctx.positions);
+        return 0;
+    }
+    ctx.positions[0] = headerSize;
+
+    pthread_mutex_init(&ctx.mutex, NULL);
+    pthread_cond_init(&ctx.committed, NULL);
+
+    LZ4MT_runWorkers(LZ4MT_compressWorker, &ctx, LZ4MT_selectNbWorkers(nbWorkers, ctx.nbBlocks));
+
+    if (ctx.error || ctx.nbCommitted != ctx.nbBlocks) {
+        result = 0;
+    } else {
+        LZ4MT_writeLE32(dst + 0, LZ4MT_MAGICNUMBER);
+        LZ4MT_writeLE32(dst + 4, flags);
+        LZ4MT_writeLE32(dst + 8, (U32)ctx.blockSize);
+        LZ4MT_writeLE32(dst + 12, (U32)srcSize);
+        result = (int)ctx.positions[ctx.nbBlocks];
+    }
+
+    pthread_cond_destroy(&ctx.committed);
+    pthread_mutex_destroy(&ctx.mutex);
+    free(ctx.positions);
+    free(ctx.cSizes);
+    return result;
+}
+
+int LZ4_compress_parallel(const char* src, char* dst,
+                          int srcSize, int dstCapacity,
+                          int acceleration, int blockSize, int nbWorkers)
+{
+    return LZ4MT_compress_generic(src, dst, srcSize, dstCapacity, acceleration, blockSize, nbWorkers, 0);
+}
+
+int LZ4_compress_parallel_linked(const char* src, char* dst,
+                                 int srcSize, int dstCapacity,
+                                 int acceleration, int blockSize, int nbWorkers)
+{
+    return LZ4MT_compress_generic(src, dst, srcSize, dstCapacity, acceleration, blockSize, nbWorkers,
+                                  LZ4MT_FLAG_LINKED);
+}
+
+
+/*-************************************
+*  Decompression
+**************************************/
+typedef struct {
+    const char* src;
+    char* dst;
+    int contentSize;
+    int blockSize;
+    int nbBlocks;
+    U32 flags;
+    const size_t* positions;   /* nbBlocks+1 entries : start of each block within src */
+
+    pthread_mutex_t mutex;
+    int nextBlock;
+    int error;
+} LZ4MT_dctx;
+
+static void* LZ4MT_decompressWorker(void* arg)
+{
+    LZ4MT_dctx* const ctx = (LZ4MT_dctx*)arg;
+
+    while (1) {
+        int blockNb;
+        pthread_mutex_lock(&ctx->mutex);
+        if (ctx->error || ctx->nextBlock >= ctx->nbBlocks) {
+            pthread_mutex_unlock(&ctx->mutex);
+            break;
+        }
+        blockNb = ctx->nextBlock++;
+        pthread_mutex_unlock(&ctx->mutex);
+
+        {   int const blockSize = (blockNb == ctx->nbBlocks - 1) ?
+                                  ctx->contentSize - blockNb * ctx->blockSize : ctx->blockSize;
+            int const cSize = (int)(ctx->positions[blockNb+1] - ctx->positions[blockNb]);
+            const char* const cBlock = ctx->src + ctx->positions[blockNb];
+            char* const dBlock = ctx->dst + (size_t)blockNb * (size_t)ctx->blockSize;
+            /* a linked block is decoded after its predecessor, which sits right before it in dst */
+            int const dSize = ((ctx->flags & LZ4MT_FLAG_LINKED) && blockNb > 0) ?
+                              LZ4_decompress_safe_usingDict(cBlock, dBlock, cSize, blockSize,
+                                                            dBlock - LZ4MT_LINK_SIZE, LZ4MT_LINK_SIZE) :
+                              LZ4_decompress_safe(cBlock, dBlock, cSize, blockSize);
+            if (dSize != blockSize) {
+                pthread_mutex_lock(&ctx->mutex);
+                ctx->error = 1;
+                pthread_mutex_unlock(&ctx->mutex);
+                break;
+        }   }
+    }
+    return NULL;
+}
+
+/* LZ4MT_readHeader() :
+ * @return : nb of blocks announced by the header, or -1 if it's invalid */
+static int LZ4MT_readHeader(const char* src, int srcSize, int* blockSizePtr, int* contentSizePtr, U32* flagsPtr)
+{
+    U32 flags, blockSize, contentSize;
+    if (src == NULL || srcSize < LZ4MT_HEADER_SIZE) return -1;
+    if (LZ4MT_readLE32(src) != LZ4MT_MAGICNUMBER) return -1;
+    flags = LZ4MT_readLE32(src + 4);
+    if (flags & ~LZ4MT_FLAG_LINKED) return -1;   /* unknown flags */
+    blockSize = LZ4MT_readLE32(src + 8);
+    contentSize = LZ4MT_readLE32(src + 12);
+    if (blockSize < LZ4MT_BLOCKSIZE_MIN || blockSize > LZ4MT_BLOCKSIZE_MAX) return -1;
+    if (contentSize > LZ4_MAX_INPUT_SIZE) return -1;
+    *blockSizePtr = (int)blockSize;
+    *contentSizePtr = (int)contentSize;
+    *flagsPtr = flags;
+    return LZ4MT_nbBlocks((int)contentSize, (int)blockSize);
+}
+
+int LZ4_getContentSize_parallel(const char* src, int srcSize)
+{
+    int blockSize, contentSize;
+    U32 flags;
+    if (LZ4MT_readHeader(src, srcSize, &blockSize, &contentSize, &flags) < 0) return -1;
+    return contentSize;
+}
+
+int LZ4_decompress_parallel(const char* src, char* dst,
+                            int srcSize, int dstCapacity, int nbWorkers)
+{
+    LZ4MT_dctx ctx;
+    size_t* positions;
+    int const nbBlocks = LZ4MT_readHeader(src, srcSize, &ctx.blockSize, &ctx.contentSize, &ctx.flags);
+
+    if (nbBlocks < 0) return -1;
+    if (ctx.contentSize > dstCapacity) return -1;
+    if (ctx.contentSize > 0 && dst == NULL) return -1;
+    if ((size_t)srcSize < LZ4MT_HEADER_SIZE + 4 * (size_t)nbBlocks) return -1;
+
+    positions = (size_t*)malloc(((size_t)nbBlocks + 1) * sizeof(size_t));
+    if (positions == NULL) return -1;
+    {   int n;
+        positions[0] = LZ4MT_HEADER_SIZE + 4 * (size_t)nbBlocks;
+        for (n = 0; n < nbBlocks; n++) {
+            U32 const cSize = LZ4MT_readLE32(src + LZ4MT_HEADER_SIZE + 4 * (size_t)n);
+            if (cSize == 0 || cSize > (U32)srcSize) { free(positions); return -1; }
+            positions[n+1] = positions[n] + cSize;
+        }
+        if (positions[nbBlocks] != (size_t)srcSize) { free(positions); return -1; }
+    }
+
+    ctx.src = src;
+    ctx.dst = dst;
+    ctx.nbBlocks = nbBlocks;
+    ctx.positions = positions;
+    ctx.nextBlock = 0;
+    ctx.error = 0;
+    pthread_mutex_init(&ctx.mutex, NULL);
+
+    if (ctx.flags & LZ4MT_FLAG_LINKED) nbWorkers = 1;   /* each block needs its predecessor */
+    LZ4MT_runWorkers(LZ4MT_decompressWorker, &ctx, LZ4MT_selectNbWorkers(nbWorkers, nbBlocks));
+
+    pthread_mutex_destroy(&ctx.mutex);
+    free(positions);
+    return ctx.error ? -1 : ctx.contentSize;
+}
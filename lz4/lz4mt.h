@@ -0,0 +1,152 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Multi-threaded block-parallel API
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4MT_H_19283746
+#define LZ4MT_H_19283746
+
+/* --- Dependency --- */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  lz4mt.h splits a large input into independent blocks of a fixed size,
+  and compresses them concurrently, one LZ4_stream_t per worker thread.
+
+  The result is a self-contained "parallel container" :
+
+    | magic | flags | blockSize | contentSize | blockTable[nbBlocks] | block 0 | block 1 | ...
+
+  All header fields are 32-bit little-endian values.
+  nbBlocks == (contentSize + blockSize - 1) / blockSize.
+  blockTable[n] is the compressed size of block n.
+  Blocks are stored back to back, in order, right after the table.
+
+  Each block is a regular LZ4 block, without any reference to other blocks.
+  It can be decoded on its own with LZ4_decompress_safe(),
+  its decompressed size being blockSize (except the last one, which can be shorter).
+
+  Linked containers (flags & LZ4MT_FLAG_LINKED) trade decoding parallelism for ratio :
+  each block, except the first one, may also reference the last 64 KB of the previous block,
+  exactly as if they had been compressed by a single LZ4_compress_fast_continue() stream.
+  Such a block must be decoded with LZ4_decompress_safe_usingDict(),
+  using the 64 KB of content which precede it as dictionary.
+*/
+
+/*-************************************
+*  Container parameters
+**************************************/
+#define LZ4MT_MAGICNUMBER        0x50345A4CU   /* "LZ4P" */
+#define LZ4MT_HEADER_SIZE        16            /* magic + flags + blockSize + contentSize */
+#define LZ4MT_BLOCKSIZE_MIN      (64 << 10)
+#define LZ4MT_BLOCKSIZE_DEFAULT  (1 << 20)
+#define LZ4MT_BLOCKSIZE_MAX      (64 << 20)
+#define LZ4MT_NBWORKERS_MAX      256
+
+#define LZ4MT_FLAG_LINKED        1U            /* blocks may reference the tail of the previous block */
+
+/*! LZ4_compressBound_parallel() :
+ *  Provides the maximum size that LZ4_compress_parallel() may output,
+ *  including header and block table, for a given input and block size.
+ *  blockSize <= 0 selects LZ4MT_BLOCKSIZE_DEFAULT.
+ * @return : maximum output size, or 0 if parameters are invalid.
+ */
+LZ4LIB_API int LZ4_compressBound_parallel(int srcSize, int blockSize);
+
+/*! LZ4_compress_parallel() :
+ *  Compresses 'srcSize' bytes from 'src' into a parallel container written into 'dst'.
+ *  'src' is cut into independent blocks of 'blockSize' bytes,
+ *  which are compressed concurrently by a pool of 'nbWorkers' threads,
+ *  using LZ4_compress_fast_extState() with one LZ4_stream_t per worker.
+ *  Workers fetch blocks in order, so work is balanced dynamically,
+ *  and only need one block of scratch space each : no full-size staging buffer is allocated.
+ *
+ *  acceleration : same meaning as in LZ4_compress_fast().
+ *  blockSize : <= 0 selects LZ4MT_BLOCKSIZE_DEFAULT,
+ *              other values are clamped within [LZ4MT_BLOCKSIZE_MIN, LZ4MT_BLOCKSIZE_MAX].
+ *  nbWorkers : <= 0 selects the number of online cores. Capped by LZ4MT_NBWORKERS_MAX and by the number of blocks.
+ *              nbWorkers == 1 compresses in the calling thread, without creating any thread.
+ *
+ * @return : the number of bytes written into 'dst' (necessarily <= dstCapacity),
+ *           or 0 if compression fails (typically, 'dst' too small, or not enough memory).
+ *  Compression is guaranteed to succeed if dstCapacity >= LZ4_compressBound_parallel(srcSize, blockSize).
+ */
+LZ4LIB_API int LZ4_compress_parallel(const char* src, char* dst,
+                                     int srcSize, int dstCapacity,
+                                     int acceleration, int blockSize, int nbWorkers);
+
+/*! LZ4_compress_parallel_linked() :
+ *  Same as LZ4_compress_parallel(), but produces a linked container.
+ *  Blocks are still compressed concurrently, since the whole input is available :
+ *  before compressing block n, its worker primes its LZ4_stream_t with LZ4_loadDict(),
+ *  using the last 64 KB of block n-1 straight from 'src'.
+ *  The compression ratio gets close to single-stream mode, especially with small blocks,
+ *  at the cost of hashing 64 KB more per block.
+ *  Decoding a linked container is sequential though : see LZ4_decompress_parallel().
+ *  Parameters, return value and bound are the same as LZ4_compress_parallel().
+ */
+LZ4LIB_API int LZ4_compress_parallel_linked(const char* src, char* dst,
+                                            int srcSize, int dstCapacity,
+                                            int acceleration, int blockSize, int nbWorkers);
+
+/*! LZ4_getContentSize_parallel() :
+ *  Reads the decompressed size announced by a parallel container header,
+ *  so that the destination buffer can be allocated before decoding.
+ * @return : decompressed size, or a negative value if 'src' doesn't start with a valid header.
+ */
+LZ4LIB_API int LZ4_getContentSize_parallel(const char* src, int srcSize);
+
+/*! LZ4_decompress_parallel() :
+ *  Decodes a container produced by LZ4_compress_parallel() or LZ4_compress_parallel_linked().
+ *  Blocks are dispatched to a pool of 'nbWorkers' threads (<= 0 : number of online cores).
+ *  Each worker invokes LZ4_decompress_safe() straight into its own slice of 'dst',
+ *  so there is no intermediate buffer, and no copy.
+ *  Blocks of a linked container depend on the previous one, so they are decoded in order,
+ *  within the calling thread, whatever 'nbWorkers' :
+ *  each block uses the content already decoded just before it within 'dst' as dictionary.
+ *  'srcSize' must be the exact size of the container.
+ * @return : the number of bytes decompressed into 'dst' (== content size),
+ *           or a negative value if the container is malformed, or if 'dst' is too small.
+ *  Note : like LZ4_decompress_safe(), it never writes outside of 'dst',
+ *         nor reads outside of 'src', even when the container is maliciously crafted.
+ */
+LZ4LIB_API int LZ4_decompress_parallel(const char* src, char* dst,
+                                       int srcSize, int dstCapacity, int nbWorkers);
+
+#endif /* LZ4MT_H_19283746 */
+
+#if defined (__cplusplus)
+}
+#endif
@@ -0,0 +1,213 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Page packing
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <limits.h>     /* INT_MAX */
+#include <string.h>     /* memcpy, memset */
+#define LZ4_STATIC_LINKING_ONLY   /* LZ4_compress_destSize_extState */
+#include "lz4page.h"
+
+
+/*-************************************
+*  Local helpers
+**************************************/
+#define LZ4PAGE_UNCOMPRESSED_FLAG 0x80000000U
+#define LZ4PAGE_WINDOW_MIN (128 << 10)
+
+static void LZ4PAGE_writeLE32(void* dst, unsigned value)
+{
+    unsigned char* const p = (unsigned char*)dst;
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned LZ4PAGE_readLE32(const void* src)
+{
+    const unsigned char* const p = (const unsigned char*)src;
+    return (unsigned)p[0] | ((unsigned)p[1] << 8) | ((unsigned)p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+static int LZ4PAGE_validPageSize(int pageSize)
+{
+    return (pageSize >= LZ4PAGE_SIZE_MIN) && (pageSize <= LZ4PAGE_SIZE_MAX);
+}
+
+
+/*-************************************
+*  Compression
+**************************************/
+int LZ4_pageBound(int srcSize, int pageSize)
+{
+    int const capacity = pageSize - LZ4PAGE_HEADER_SIZE;
+    if (!LZ4PAGE_validPageSize(pageSize) || srcSize < 0) return 0;
+    /* each page but the last holds at least `capacity` bytes */
+    return srcSize / capacity + (srcSize % capacity != 0);
+}
+
+/* LZ4PAGE_fillPage() :
+ * fills one page from `src`, picking whichever of compression or raw storage holds more source bytes.
+ * Compression only sees a window of the source : literals are only written when a match is found,
+ * so on incompressible data, the whole input given to LZ4_compress_destSize() would be scanned
+ * before noticing that the page is full. The window starts at `*windowPtr`,
+ * and grows while it's entirely consumed. It's updated to suit the next page.
+ * @return : number of source bytes held by the page (> 0) */
+static int LZ4PAGE_fillPage(LZ4_stream_t* ctx, const char* src, int srcSize,
+                            char* page, int pageSize, int* windowPtr, int acceleration)
+{
+    int const capacity = pageSize - LZ4PAGE_HEADER_SIZE;
+    int const rawSize = (srcSize < capacity) ? srcSize : capacity;
+    char* const payload = page + LZ4PAGE_HEADER_SIZE;
+    int window = (*windowPtr < srcSize) ? *windowPtr : srcSize;
+    int consumed, cSize;
+    unsigned header;
+
+    for (;;) {
+        consumed = window;
+        cSize = LZ4_compress_destSize_extState(ctx, src, payload, &consumed, capacity, acceleration);
+        if (consumed < window || window == srcSize) break;
+        window = (window > srcSize / 4) ? srcSize : window * 4;
+    }
+    /* next window : twice what this page held, which leaves room for variations.
+     * When the page compressed, the window is kept above 64 KB : on larger inputs,
+     * LZ4_compress_generic() switches to a 5-byte hash, which fills pages ~2% better on text. */
+    *windowPtr = (consumed > INT_MAX / 2) ? INT_MAX : consumed * 2;
+    if (*windowPtr < 2 * capacity) *windowPtr = 2 * capacity;
+    if (consumed > rawSize && *windowPtr < LZ4PAGE_WINDOW_MIN) *windowPtr = LZ4PAGE_WINDOW_MIN;
+
+    if (cSize > 0 && consumed > rawSize) {
+        header = (unsigned)cSize;
+    } else {
+        /* raw storage holds as much, and decodes faster */
+        memcpy(payload, src, (size_t)rawSize);
+        header = (unsigned)rawSize | LZ4PAGE_UNCOMPRESSED_FLAG;
+        consumed = rawSize;
+    }
+    LZ4PAGE_writeLE32(page, header);
+    {   int const payloadSize = (int)(header & ~LZ4PAGE_UNCOMPRESSED_FLAG);
+        memset(payload + payloadSize, 0, (size_t)(capacity - payloadSize));
+    }
+    return consumed;
+}
+
+int LZ4_compress_pages(const char* src, int srcSize,
+                       char* dst, int maxPages, int pageSize,
+                       int* pageOffsets, int acceleration)
+{
+    LZ4_stream_t ctx;
+    int pos = 0;
+    int nbPages = 0;
+    int window = 2 * pageSize;
+
+    if (pageOffsets == NULL || !LZ4PAGE_validPageSize(pageSize) || srcSize < 0 || maxPages < 0) return 0;
+    if (srcSize > 0 && (src == NULL || dst == NULL)) return 0;
+    pageOffsets[0] = 0;
+    if (LZ4_initStream(&ctx, sizeof(ctx)) == NULL) return 0;
+
+    while (pos < srcSize) {
+        if (nbPages == maxPages) return 0;
+        pageOffsets[nbPages] = pos;
+        pos += LZ4PAGE_fillPage(&ctx, src + pos, srcSize - pos,
+                                dst + (size_t)nbPages * (size_t)pageSize, pageSize,
+                                &window, acceleration);
+        nbPages++;
+    }
+    pageOffsets[nbPages] = pos;
+    return nbPages;
+}
+
+
+/*-************************************
+*  Decompression
+**************************************/
+int LZ4_decompress_page(const char* page, int pageSize, char* dst, int dstCapacity)
+{
+    unsigned header;
+    int payloadSize;
+
+    if (page == NULL || !LZ4PAGE_validPageSize(pageSize) || dstCapacity < 0) return -1;
+    header = LZ4PAGE_readLE32(page);
+    payloadSize = (int)(header & ~LZ4PAGE_UNCOMPRESSED_FLAG);
+    if (payloadSize > pageSize - LZ4PAGE_HEADER_SIZE) return -1;
+
+    if (header & LZ4PAGE_UNCOMPRESSED_FLAG) {
+        if (payloadSize > dstCapacity) return -1;
+        memcpy(dst, page + LZ4PAGE_HEADER_SIZE, (size_t)payloadSize);
+        return payloadSize;
+    }
+    return LZ4_decompress_safe(page + LZ4PAGE_HEADER_SIZE, dst, payloadSize, dstCapacity);
+}
+
+int LZ4_findPage(const int* pageOffsets, int nbPages, int srcOffset)
+{
+    int low = 0;
+    int high = nbPages;   /* invariant : pageOffsets[low] <= srcOffset < pageOffsets[high] */
+
+    if (pageOffsets == NULL || nbPages <= 0) return -1;
+    if (srcOffset < pageOffsets[0] || srcOffset >= pageOffsets[nbPages]) return -1;
+    while (high - low > 1) {
+        int const mid = low + (high - low) / 2;
+        if (pageOffsets[mid] <= srcOffset) low = mid;
+        else high = mid;
+    }
+    return low;
+}
+
+int LZ4_buildPageIndex(const int* pageOffsets, int nbPages, int pageSize, int* pageIndex)
+{
+    int nbEntries, entry;
+    int page = 0;
+
+    if (pageOffsets == NULL || pageIndex == NULL || nbPages <= 0 || !LZ4PAGE_validPageSize(pageSize)) return 0;
+    nbEntries = LZ4_pageBound(pageOffsets[nbPages] - pageOffsets[0], pageSize);
+    for (entry = 0; entry < nbEntries; entry++) {
+        /* entry * capacity < srcSize : no overflow */
+        int const offset = pageOffsets[0] + entry * (pageSize - LZ4PAGE_HEADER_SIZE);
+        while (pageOffsets[page + 1] <= offset) page++;
+        pageIndex[entry] = page;
+    }
+    return nbEntries;
+}
+
+int LZ4_findPage_usingIndex(const int* pageOffsets, int nbPages,
+                            const int* pageIndex, int pageSize, int srcOffset)
+{
+    int page;
+
+    if (pageOffsets == NULL || pageIndex == NULL || nbPages <= 0 || !LZ4PAGE_validPageSize(pageSize)) return -1;
+    if (srcOffset < pageOffsets[0] || srcOffset >= pageOffsets[nbPages]) return -1;
+    page = pageIndex[(srcOffset - pageOffsets[0]) / (pageSize - LZ4PAGE_HEADER_SIZE)];
+    /* the next page may start within the entry, not the one after it */
+    if (pageOffsets[page + 1] <= srcOffset) page++;
+    return page;
+}
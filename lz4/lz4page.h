@@ -0,0 +1,127 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Page packing
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4PAGE_H_29461705
+#define LZ4PAGE_H_29461705
+
+/* --- Dependency --- */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  lz4page.h compresses a stream of bytes (typically, variable-length records laid back to back)
+  into fixed-size pages, for page caches and block devices.
+
+  Each page is filled close to capacity with LZ4_compress_destSize(),
+  so the number of source bytes it holds varies from page to page.
+  Pages are independent : any page can be decoded on its own.
+  Page p starts at dst + p*pageSize, and the source offsets it covers are reported
+  into an array of offsets : page p regenerates src[pageOffsets[p] .. pageOffsets[p+1]-1].
+  This array is the index : LZ4_findPage() locates the page holding a given source offset.
+  For constant time lookups, LZ4_buildPageIndex() derives a direct index from it.
+
+  Page layout : a 4-byte little-endian header, then the payload, then zero padding.
+  The header holds the payload size. When its highest bit is set, the payload is stored uncompressed :
+  this happens when compression would hold fewer source bytes than the page itself,
+  which guarantees that each page but the last holds at least pageSize - LZ4PAGE_HEADER_SIZE source bytes.
+*/
+
+#define LZ4PAGE_HEADER_SIZE 4
+#define LZ4PAGE_SIZE_MIN    64
+#define LZ4PAGE_SIZE_MAX    (4 << 20)
+
+/*! LZ4_pageBound() :
+ *  Provides the number of pages which guarantees that LZ4_compress_pages() succeeds
+ *  for `srcSize` bytes.
+ * @return : maximum number of pages, or 0 if `pageSize` is not within [LZ4PAGE_SIZE_MIN, LZ4PAGE_SIZE_MAX].
+ */
+LZ4LIB_API int LZ4_pageBound(int srcSize, int pageSize);
+
+/*! LZ4_compress_pages() :
+ *  Compresses `srcSize` bytes from `src` into pages of `pageSize` bytes, written back to back into `dst`,
+ *  which must provide room for `maxPages` pages.
+ *  `pageOffsets` must provide room for `maxPages+1` values :
+ *  on success, pageOffsets[0] == 0, pageOffsets[nbPages] == srcSize,
+ *  and page p regenerates src[pageOffsets[p] .. pageOffsets[p+1]-1].
+ *  acceleration : same meaning as in LZ4_compress_fast().
+ * @return : number of pages written,
+ *           or 0 if compression fails (invalid parameters, or `maxPages` too small).
+ *  Note : an empty source produces no page : it returns 0 too, with pageOffsets[0] == 0.
+ */
+LZ4LIB_API int LZ4_compress_pages(const char* src, int srcSize,
+                                  char* dst, int maxPages, int pageSize,
+                                  int* pageOffsets, int acceleration);
+
+/*! LZ4_decompress_page() :
+ *  Decodes a single page of `pageSize` bytes, produced by LZ4_compress_pages(), into `dst`.
+ *  A page regenerates pageOffsets[p+1] - pageOffsets[p] bytes.
+ * @return : number of bytes decoded into `dst`,
+ *           or a negative value if the page is malformed or doesn't fit into `dstCapacity`.
+ *  Note : like LZ4_decompress_safe(), it never reads outside of the page, nor writes outside of `dst`.
+ */
+LZ4LIB_API int LZ4_decompress_page(const char* page, int pageSize, char* dst, int dstCapacity);
+
+/*! LZ4_findPage() :
+ *  Finds the page holding source offset `srcOffset`, using the index produced by LZ4_compress_pages().
+ *  This is a binary search over the `nbPages+1` offsets, O(log(nbPages)) ;
+ *  the page itself is then at dst + p*pageSize.
+ * @return : page number, or -1 if `srcOffset` is beyond the source.
+ */
+LZ4LIB_API int LZ4_findPage(const int* pageOffsets, int nbPages, int srcOffset);
+
+/*! LZ4_buildPageIndex() :
+ *  Builds a direct index over the offsets produced by LZ4_compress_pages(), for LZ4_findPage_usingIndex().
+ *  Entry i is the page holding source offset i * (pageSize - LZ4PAGE_HEADER_SIZE) :
+ *  since each page but the last holds at least that many bytes, at most one page starts within an entry.
+ *  `pageIndex` must provide room for LZ4_pageBound(srcSize, pageSize) values, srcSize being pageOffsets[nbPages].
+ *  That's no more than the number of pages of incompressible data, one int per page.
+ * @return : number of entries written, or 0 if parameters are invalid or the source is empty.
+ */
+LZ4LIB_API int LZ4_buildPageIndex(const int* pageOffsets, int nbPages, int pageSize, int* pageIndex);
+
+/*! LZ4_findPage_usingIndex() :
+ *  Same result as LZ4_findPage(), in constant time, using the index built by LZ4_buildPageIndex()
+ *  with the same `pageOffsets`, `nbPages` and `pageSize`.
+ * @return : page number, or -1 if `srcOffset` is beyond the source.
+ */
+LZ4LIB_API int LZ4_findPage_usingIndex(const int* pageOffsets, int nbPages,
+                                       const int* pageIndex, int pageSize, int srcOffset);
+
+#endif /* LZ4PAGE_H_29461705 */
+
+#if defined (__cplusplus)
+}
+#endif
@@ -0,0 +1,159 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Ring-buffer streaming decoder
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <stdlib.h>     /* malloc, free */
+#include <string.h>     /* memcpy */
+#include "lz4ring.h"
+
+
+/*-************************************
+*  Decoder state
+**************************************/
+struct LZ4_ringDecoder_s {
+    LZ4_streamDecode_t stream;
+    char* ring;
+    int ringSize;
+    int ringPos;            /* where next block is decoded */
+    int maxBlockSize;
+    char* staging;          /* block header + compressed block, while partially received */
+    int stagingCapacity;
+    int stagingSize;
+};
+
+static unsigned LZ4RING_readLE32(const void* src)
+{
+    const unsigned char* const p = (const unsigned char*)src;
+    return (unsigned)p[0] | ((unsigned)p[1] << 8) | ((unsigned)p[2] << 16) | ((unsigned)p[3] << 24);
+}
+
+LZ4_ringDecoder* LZ4_createRingDecoder(int maxBlockSize)
+{
+    int const ringSize = LZ4_decoderRingBufferSize(maxBlockSize);
+    int const maxCSize = LZ4_compressBound(maxBlockSize);
+    LZ4_ringDecoder* decoder;
+    if (ringSize <= 0 || maxCSize <= 0) return NULL;
+
+    decoder = (LZ4_ringDecoder*)malloc(sizeof(*decoder));
+    if (decoder == NULL) return NULL;
+    decoder->ring = (char*)malloc((size_t)ringSize);
+    decoder->staging = (char*)malloc((size_t)maxCSize + LZ4RING_BLOCKHEADER_SIZE);
+    if (decoder->ring == NULL || decoder->staging == NULL) {
+        LZ4_freeRingDecoder(decoder);
+        return NULL;
+    }
+    decoder->ringSize = ringSize;
+    decoder->maxBlockSize = maxBlockSize;
+    decoder->stagingCapacity = maxCSize + LZ4RING_BLOCKHEADER_SIZE;
+    LZ4_resetRingDecoder(decoder);
+    return decoder;
+}
+
+void LZ4_freeRingDecoder(LZ4_ringDecoder* decoder)
+{
+    if (decoder == NULL) return;
+    free(decoder->ring);
+    free(decoder->staging);
+    free(decoder);
+}
+
+void LZ4_resetRingDecoder(LZ4_ringDecoder* decoder)
+{
+    LZ4_setStreamDecode(&decoder->stream, NULL, 0);
+    decoder->ringPos = 0;
+    decoder->stagingSize = 0;
+}
+
+
+/*-************************************
+*  Decoding
+**************************************/
+/* @return : compressed size announced by a block header, or -1 if it's not possible */
+static int LZ4RING_blockSize(const LZ4_ringDecoder* decoder, const char* header)
+{
+    unsigned const cSize = LZ4RING_readLE32(header);
+    if (cSize == 0 || cSize > (unsigned)(decoder->stagingCapacity - LZ4RING_BLOCKHEADER_SIZE)) return -1;
+    return (int)cSize;
+}
+
+int LZ4_ringDecoder_decode(LZ4_ringDecoder* decoder,
+                           const char* src, int srcSize,
+                           const char** blockPtr, int* blockSize)
+{
+    const char* block;
+    int cSize;
+    int consumed;
+
+    *blockPtr = NULL;
+    *blockSize = 0;
+    if (srcSize < 0 || (src == NULL && srcSize > 0)) return -1;
+
+    if (decoder->stagingSize == 0 && srcSize >= LZ4RING_BLOCKHEADER_SIZE) {
+        /* fast path : whole block within src, decoded in place */
+        cSize = LZ4RING_blockSize(decoder, src);
+        if (cSize < 0) return -1;
+        if (cSize <= srcSize - LZ4RING_BLOCKHEADER_SIZE) {
+            block = src + LZ4RING_BLOCKHEADER_SIZE;
+            consumed = LZ4RING_BLOCKHEADER_SIZE + cSize;
+            goto _decode;
+    }   }
+
+    /* gather the block into the staging area : header first, then the announced size */
+    consumed = 0;
+    while (decoder->stagingSize < LZ4RING_BLOCKHEADER_SIZE && consumed < srcSize)
+        decoder->staging[decoder->stagingSize++] = src[consumed++];
+    if (decoder->stagingSize < LZ4RING_BLOCKHEADER_SIZE) return consumed;
+    cSize = LZ4RING_blockSize(decoder, decoder->staging);
+    if (cSize < 0) return -1;
+    {   int const missing = LZ4RING_BLOCKHEADER_SIZE + cSize - decoder->stagingSize;
+        int const toCopy = (missing < srcSize - consumed) ? missing : srcSize - consumed;
+        memcpy(decoder->staging + decoder->stagingSize, src + consumed, (size_t)toCopy);
+        decoder->stagingSize += toCopy;
+        consumed += toCopy;
+        if (toCopy < missing) return consumed;
+    }
+    block = decoder->staging + LZ4RING_BLOCKHEADER_SIZE;
+    decoder->stagingSize = 0;
+
+_decode:
+    /* wrap around when the next block may not fit : history then lies at the end of the ring */
+    if (decoder->ringSize - decoder->ringPos < decoder->maxBlockSize) decoder->ringPos = 0;
+    {   char* const dst = decoder->ring + decoder->ringPos;
+        int const dSize = LZ4_decompress_safe_continue(&decoder->stream, block, dst,
+                                                       cSize, decoder->maxBlockSize);
+        if (dSize < 0) return -1;
+        decoder->ringPos += dSize;
+        *blockPtr = dst;
+        *blockSize = dSize;
+    }
+    return consumed;
+}
@@ -0,0 +1,100 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Ring-buffer streaming decoder
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4RING_H_47150392
+#define LZ4RING_H_47150392
+
+/* --- Dependency --- */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  lz4ring.h decodes a stream of linked LZ4 blocks as it arrives, typically from a socket,
+  with bounded memory per stream and no allocation once created.
+
+  Stream format : each block is preceded by its compressed size, as a 32-bit little-endian value.
+  Blocks are produced by LZ4_compress_fast_continue() (or any compliant encoder),
+  and regenerate at most `maxBlockSize` bytes each.
+
+    | cSize 0 | block 0 | cSize 1 | block 1 | ...
+
+  The decoder owns a ring buffer of LZ4_decoderRingBufferSize(maxBlockSize) bytes.
+  Blocks are decoded into it next to each other, so each block finds its history
+  right before it (prefix mode), until the ring wraps around : history then never needs to be moved.
+  Input can be delivered in chunks of any size. A block entirely present within a chunk
+  is decoded straight from it ; otherwise, its bytes are gathered into an internal staging area,
+  sized for the largest possible block.
+  Decoded blocks are handed out as views into the ring buffer : no copy is involved.
+*/
+
+typedef struct LZ4_ringDecoder_s LZ4_ringDecoder;   /* incomplete type */
+
+#define LZ4RING_BLOCKHEADER_SIZE 4
+
+/*! LZ4_createRingDecoder() :
+ *  Allocates a decoder for blocks regenerating at most `maxBlockSize` bytes each (> 16).
+ *  Its memory budget is about LZ4_decoderRingBufferSize(maxBlockSize) + LZ4_compressBound(maxBlockSize).
+ * @return : the decoder, or NULL on error (invalid size, not enough memory).
+ */
+LZ4LIB_API LZ4_ringDecoder* LZ4_createRingDecoder(int maxBlockSize);
+LZ4LIB_API void LZ4_freeRingDecoder(LZ4_ringDecoder* decoder);
+
+/*! LZ4_resetRingDecoder() :
+ *  Prepares the decoder for a new stream, dropping history and any partially received block.
+ *  Also required after an error.
+ */
+LZ4LIB_API void LZ4_resetRingDecoder(LZ4_ringDecoder* decoder);
+
+/*! LZ4_ringDecoder_decode() :
+ *  Consumes input from `src`, and decodes at most one block.
+ *  `srcSize` can be anything, including less than a block header.
+ *  When a block is complete, `*blockPtr` and `*blockSize` receive a view of its decoded content,
+ *  otherwise, `*blockSize` is 0.
+ *  A view remains valid until the next call, and at least until 64 KB more have been decoded.
+ * @return : the number of bytes consumed from `src` (<= srcSize),
+ *           or a negative value if the stream is invalid (in which case the decoder must be reset).
+ *  Typical usage : call in a loop on each received chunk, until the chunk is fully consumed.
+ *  All bytes are consumed when no block is produced.
+ */
+LZ4LIB_API int LZ4_ringDecoder_decode(LZ4_ringDecoder* decoder,
+                                      const char* src, int srcSize,
+                                      const char** blockPtr, int* blockSize);
+
+#endif /* LZ4RING_H_47150392 */
+
+#if defined (__cplusplus)
+}
+#endif
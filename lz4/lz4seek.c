@@ -0,0 +1,292 @@
+/*
+   LZ4 - Fast LZ compression algorithm
+   Seekable container
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <stdlib.h>     /* malloc, free */
+#include <string.h>     /* memcpy */
+#define LZ4_STATIC_LINKING_ONLY   /* LZ4_compress_fast_extState_fastReset */
+#include "lz4seek.h"
+
+
+/*-************************************
+*  Basic Types
+**************************************/
+#if defined(__cplusplus) || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */)
+# include <stdint.h>
+  typedef uint8_t  BYTE;
+  typedef uint32_t U32;
+  typedef uint64_t U64;
+#else
+  typedef unsigned char       BYTE;
+  typedef unsigned int        U32;
+  typedef unsigned long long  U64;
+#endif
+
+#define LZ4SEEK_UNCOMPRESSED_FLAG 0x80000000U
+
+
+/*-************************************
+*  Memory routines
+**************************************/
+static U32 LZ4SEEK_readLE32(const void* src)
+{
+    const BYTE* const p = (const BYTE*)src;
+    return (U32)p[0] | ((U32)p[1] << 8) | ((U32)p[2] << 16) | ((U32)p[3] << 24);
+}
+
+static void LZ4SEEK_writeLE32(void* dst, U32 value32)
+{
+    BYTE* const p = (BYTE*)dst;
+    p[0] = (BYTE)value32;
+    p[1] = (BYTE)(value32 >> 8);
+    p[2] = (BYTE)(value32 >> 16);
+    p[3] = (BYTE)(value32 >> 24);
+}
+
+static U64 LZ4SEEK_readLE64(const void* src)
+{
+    const BYTE* const p = (const BYTE*)src;
+    return (U64)LZ4SEEK_readLE32(p) | ((U64)LZ4SEEK_readLE32(p + 4) << 32);
+}
+
+static void LZ4SEEK_writeLE64(void* dst, U64 value64)
+{
+    LZ4SEEK_writeLE32(dst, (U32)value64);
+    LZ4SEEK_writeLE32((BYTE*)dst + 4, (U32)(value64 >> 32));
+}
+
+
+/*-************************************
+*  Compression
+**************************************/
+static int LZ4SEEK_validBlockSize(int blockSize)
+{
+    return (blockSize >= LZ4SEEK_BLOCKSIZE_MIN) && (blockSize <= LZ4SEEK_BLOCKSIZE_MAX);
+}
+
+size_t LZ4_compressBound_seekable(size_t srcSize, int blockSize)
+{
+    U64 nbBlocks;
+    if (blockSize <= 0) blockSize = LZ4SEEK_BLOCKSIZE_DEFAULT;
+    if (!LZ4SEEK_validBlockSize(blockSize)) return 0;
+    nbBlocks = ((U64)srcSize + (U64)blockSize - 1) / (U64)blockSize;
+    if (nbBlocks > 0x7FFFFFFFU) return 0;
+    /* a block never takes more room than its content : it is stored uncompressed otherwise */
+    return srcSize + (size_t)nbBlocks * 4 + LZ4SEEK_FOOTER_SIZE;
+}
+
+size_t LZ4_compress_seekable(const void* src, size_t srcSize,
+                             void* dst, size_t dstCapacity,
+                             int blockSize, int acceleration)
+{
+    const BYTE* const istart = (const BYTE*)src;
+    BYTE* const ostart = (BYTE*)dst;
+    size_t const bound = LZ4_compressBound_seekable(srcSize, blockSize);
+    LZ4_stream_t ctx;
+    U32* blockTable;
+    U32 nbBlocks, n;
+    size_t pos = 0;
+
+    if (blockSize <= 0) blockSize = LZ4SEEK_BLOCKSIZE_DEFAULT;
+    if (bound == 0 || dst == NULL || (src == NULL && srcSize > 0)) return 0;
+    nbBlocks = (U32)((srcSize + (size_t)blockSize - 1) / (size_t)blockSize);
+    /* the table can't be written in place : its position depends on the size of all blocks */
+    blockTable = (U32*)malloc(((size_t)nbBlocks + 1) * sizeof(U32));
+    if (blockTable == NULL) return 0;
+    if (LZ4_initStream(&ctx, sizeof(ctx)) == NULL) { free(blockTable); return 0; }
+
+    for (n = 0; n < nbBlocks; n++) {
+        size_t const srcPos = (size_t)n * (size_t)blockSize;
+        int const dSize = (srcSize - srcPos < (size_t)blockSize) ? (int)(srcSize - srcPos) : blockSize;
+        int cSize = 0;
+        if (dstCapacity - pos < (size_t)dSize) { free(blockTable); return 0; }
+        if (dSize > 1)
+            cSize = LZ4_compress_fast_extState_fastReset(&ctx, (const char*)istart + srcPos, (char*)ostart + pos,
+                                                         dSize, dSize - 1, acceleration);
+        if (cSize > 0) {
+            blockTable[n] = (U32)cSize;
+        } else {   /* didn't shrink : stored */
+            memcpy(ostart + pos, istart + srcPos, (size_t)dSize);
+            cSize = dSize;
+            blockTable[n] = (U32)dSize | LZ4SEEK_UNCOMPRESSED_FLAG;
+        }
+        pos += (size_t)cSize;
+    }
+
+    if (dstCapacity - pos < (size_t)nbBlocks * 4 + LZ4SEEK_FOOTER_SIZE) { free(blockTable); return 0; }
+    for (n = 0; n < nbBlocks; n++) {
+        LZ4SEEK_writeLE32(ostart + pos, blockTable[n]);
+        pos += 4;
+    }
+    free(blockTable);
+    LZ4SEEK_writeLE32(ostart + pos, (U32)blockSize);
+    LZ4SEEK_writeLE32(ostart + pos + 4, nbBlocks);
+    LZ4SEEK_writeLE64(ostart + pos + 8, (U64)srcSize);
+    LZ4SEEK_writeLE32(ostart + pos + 16, LZ4SEEK_MAGICNUMBER);
+    return pos + LZ4SEEK_FOOTER_SIZE;
+}
+
+
+/*-************************************
+*  Random access
+**************************************/
+struct LZ4_seekReader_s {
+    const BYTE* src;
+    const BYTE* blockTable;     /* within src */
+    U64* blockStarts;           /* nbBlocks+1 positions within src */
+    U64 contentSize;
+    U32 nbBlocks;
+    int blockSize;
+    char* scratch;              /* one block, for ranges starting within a block */
+};
+
+LZ4_seekReader* LZ4_createSeekReader(const void* src, size_t srcSize)
+{
+    const BYTE* const istart = (const BYTE*)src;
+    const BYTE* footer;
+    LZ4_seekReader* reader;
+    U64 pos = 0;
+    U32 n;
+
+    if (src == NULL || srcSize < LZ4SEEK_FOOTER_SIZE) return NULL;
+    footer = istart + srcSize - LZ4SEEK_FOOTER_SIZE;
+    if (LZ4SEEK_readLE32(footer + 16) != LZ4SEEK_MAGICNUMBER) return NULL;
+
+    reader = (LZ4_seekReader*)malloc(sizeof(*reader));
+    if (reader == NULL) return NULL;
+    reader->src = istart;
+    reader->blockSize = (int)LZ4SEEK_readLE32(footer);
+    reader->nbBlocks = LZ4SEEK_readLE32(footer + 4);
+    reader->contentSize = LZ4SEEK_readLE64(footer + 8);
+    reader->blockStarts = NULL;
+    reader->scratch = NULL;
+    if ( !LZ4SEEK_validBlockSize(reader->blockSize)
+      || reader->nbBlocks > 0x7FFFFFFFU
+      || (U64)reader->nbBlocks * 4 > srcSize - LZ4SEEK_FOOTER_SIZE
+      /* written as (size-1)/blockSize+1 : (size + blockSize - 1) overflows for a forged contentSize */
+      || reader->nbBlocks != (reader->contentSize ? (reader->contentSize - 1) / (U64)reader->blockSize + 1 : 0) ) {
+        LZ4_freeSeekReader(reader);
+        return NULL;
+    }
+    reader->blockTable = footer - (size_t)reader->nbBlocks * 4;
+    reader->blockStarts = (U64*)malloc(((size_t)reader->nbBlocks + 1) * sizeof(U64));
+    reader->scratch = (char*)malloc((size_t)reader->blockSize);
+    if (reader->blockStarts == NULL || reader->scratch == NULL) {
+        LZ4_freeSeekReader(reader);
+        return NULL;
+    }
+
+    for (n = 0; n < reader->nbBlocks; n++) {
+        U32 const entry = LZ4SEEK_readLE32(reader->blockTable + 4 * (size_t)n);
+        U32 const storedSize = entry & ~LZ4SEEK_UNCOMPRESSED_FLAG;
+        U64 const dSize = (n + 1 < reader->nbBlocks) ? (U64)reader->blockSize
+                        : reader->contentSize - (U64)n * (U64)reader->blockSize;
+        int const valid = (entry & LZ4SEEK_UNCOMPRESSED_FLAG) ? (storedSize == dSize)
+                        : (storedSize > 0 && storedSize < dSize);
+        if (!valid) { LZ4_freeSeekReader(reader); return NULL; }
+        reader->blockStarts[n] = pos;
+        pos += storedSize;
+    }
+    reader->blockStarts[reader->nbBlocks] = pos;
+    if (pos != (U64)(reader->blockTable - istart)) {   /* blocks must exactly fill the space before the table */
+        LZ4_freeSeekReader(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+void LZ4_freeSeekReader(LZ4_seekReader* reader)
+{
+    if (reader == NULL) return;
+    free(reader->blockStarts);
+    free(reader->scratch);
+    free(reader);
+}
+
+unsigned long long LZ4_seekReader_contentSize(const LZ4_seekReader* reader)
+{
+    return reader->contentSize;
+}
+
+/* LZ4SEEK_decodeBlockPrefix() :
+ * decodes the first `targetSize` bytes of block n into `dst` (targetSize <= block size).
+ * A whole block goes through LZ4_decompress_safe(), which benefits from the SIMD decoding kernels,
+ * otherwise decoding stops once `targetSize` bytes are produced.
+ * @return : 0 on success, < 0 if the block is malformed */
+static int LZ4SEEK_decodeBlockPrefix(const LZ4_seekReader* reader, U32 n, char* dst, int targetSize)
+{
+    U32 const entry = LZ4SEEK_readLE32(reader->blockTable + 4 * (size_t)n);
+    const char* const block = (const char*)reader->src + reader->blockStarts[n];
+    int const storedSize = (int)(reader->blockStarts[n+1] - reader->blockStarts[n]);
+    U64 const blockStart = (U64)n * (U64)reader->blockSize;
+    int const blockDSize = (reader->contentSize - blockStart < (U64)reader->blockSize) ?
+                           (int)(reader->contentSize - blockStart) : reader->blockSize;
+    if (entry & LZ4SEEK_UNCOMPRESSED_FLAG) {
+        memcpy(dst, block, (size_t)targetSize);
+        return 0;
+    }
+    if (targetSize == blockDSize)
+        return (LZ4_decompress_safe(block, dst, storedSize, targetSize) == targetSize) ? 0 : -1;
+    return (LZ4_decompress_safe_partial(block, dst, storedSize, targetSize, targetSize) == targetSize) ? 0 : -1;
+}
+
+int LZ4_decompress_seekable_range(LZ4_seekReader* reader,
+                                  void* dst, int dstCapacity,
+                                  unsigned long long offset, int len)
+{
+    char* const ostart = (char*)dst;
+    U64 const bSize = (U64)reader->blockSize;
+    U64 end;
+    int written = 0;
+    U32 n;
+
+    if (len < 0 || dstCapacity < 0 || offset > reader->contentSize) return -1;
+    end = (reader->contentSize - offset < (U64)len) ? reader->contentSize : offset + (U64)len;
+    if (end - offset > (U64)dstCapacity) return -1;
+    if (end == offset) return 0;
+
+    for (n = (U32)(offset / bSize); (U64)n * bSize < end; n++) {
+        U64 const blockStart = (U64)n * bSize;
+        int const from = (offset > blockStart) ? (int)(offset - blockStart) : 0;
+        int const to = (end - blockStart < bSize) ? (int)(end - blockStart) : reader->blockSize;
+        if (from == 0) {
+            /* straight into dst ; the last block may stop early */
+            if (LZ4SEEK_decodeBlockPrefix(reader, n, ostart + written, to) < 0) return -1;
+        } else {
+            /* the range starts within this block : its beginning must be decoded too */
+            if (LZ4SEEK_decodeBlockPrefix(reader, n, reader->scratch, to) < 0) return -1;
+            memcpy(ostart + written, reader->scratch + from, (size_t)(to - from));
+        }
+        written += to - from;
+    }
+    return written;
+}
@@ -0,0 +1,136 @@
+/*
+ *  LZ4 - Fast LZ compression algorithm
+ *  Seekable container
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#ifndef LZ4SEEK_H_61840527
+#define LZ4SEEK_H_61840527
+
+/* --- Dependencies --- */
+#include <stddef.h>   /* size_t */
+#include "lz4.h"
+
+
+/**
+  Introduction
+
+  lz4seek.h produces and reads a "seekable container",
+  from which any byte range can be decoded without decoding what precedes it.
+
+    | block 0 | block 1 | ... | block N-1 | blockTable[N] | footer |
+    footer : | blockSize | nbBlocks | contentSize (64-bit) | magic |
+
+  All fields are little-endian, 32-bit unless noted.
+  The input is cut into independent blocks of blockSize bytes (the last one can be shorter),
+  so the block holding a given offset is known right away.
+  blockTable[n] is the stored size of block n. When its highest bit is set,
+  block n is stored uncompressed (it didn't shrink), otherwise it's a regular LZ4 block.
+  The index sits at the end, so a writer can emit blocks as they are produced,
+  and a reader locates it from the end of the container.
+
+  Reading [offset, offset+len) only decodes the blocks covering this range :
+  the cost of a point read is bounded by blockSize, whatever the container size.
+  Within the last block, decoding stops as soon as the range is complete (LZ4_decompress_safe_partial()).
+  Sizes are 64-bit, so containers can exceed 2 GB (typically, a memory-mapped file).
+*/
+
+/*-************************************
+*  Container parameters
+**************************************/
+#define LZ4SEEK_MAGICNUMBER        0x53345A4CU   /* "LZ4S" */
+#define LZ4SEEK_FOOTER_SIZE        20            /* blockSize + nbBlocks + contentSize + magic */
+#define LZ4SEEK_BLOCKSIZE_MIN      (1 << 10)
+#define LZ4SEEK_BLOCKSIZE_DEFAULT  (64 << 10)
+#define LZ4SEEK_BLOCKSIZE_MAX      (64 << 20)
+
+
+/*-************************************
+*  Compression
+**************************************/
+/*! LZ4_compressBound_seekable() :
+ *  Provides the maximum size of a seekable container for `srcSize` bytes, index and footer included.
+ *  blockSize <= 0 selects LZ4SEEK_BLOCKSIZE_DEFAULT.
+ * @return : maximum output size, or 0 if parameters are invalid.
+ */
+LZ4LIB_API size_t LZ4_compressBound_seekable(size_t srcSize, int blockSize);
+
+/*! LZ4_compress_seekable() :
+ *  Compresses `srcSize` bytes from `src` into a seekable container written into `dst`.
+ *  blockSize : <= 0 selects LZ4SEEK_BLOCKSIZE_DEFAULT,
+ *              other values must be within [LZ4SEEK_BLOCKSIZE_MIN, LZ4SEEK_BLOCKSIZE_MAX].
+ *              Smaller blocks make point reads cheaper, and compression ratio worse.
+ *  acceleration : same meaning as in LZ4_compress_fast().
+ * @return : the number of bytes written into `dst`,
+ *           or 0 if compression fails (invalid parameters, `dst` too small, not enough memory).
+ *  Compression is guaranteed to succeed if dstCapacity >= LZ4_compressBound_seekable(srcSize, blockSize).
+ */
+LZ4LIB_API size_t LZ4_compress_seekable(const void* src, size_t srcSize,
+                                        void* dst, size_t dstCapacity,
+                                        int blockSize, int acceleration);
+
+
+/*-************************************
+*  Random access
+**************************************/
+typedef struct LZ4_seekReader_s LZ4_seekReader;   /* incomplete type */
+
+/*! LZ4_createSeekReader() :
+ *  Validates the container of `srcSize` bytes at `src`, and loads its index.
+ *  `src` is referenced, not copied : it must remain valid and unmodified while the reader is in use.
+ *  A reader also owns a scratch buffer of one block, used when a range starts in the middle of a block.
+ *  So it can't be used by several threads at the same time : create one reader per thread.
+ * @return : the reader, or NULL if the container is malformed or there is not enough memory.
+ */
+LZ4LIB_API LZ4_seekReader* LZ4_createSeekReader(const void* src, size_t srcSize);
+LZ4LIB_API void LZ4_freeSeekReader(LZ4_seekReader* reader);
+
+/*! LZ4_seekReader_contentSize() :
+ * @return : total decompressed size of the container. */
+LZ4LIB_API unsigned long long LZ4_seekReader_contentSize(const LZ4_seekReader* reader);
+
+/*! LZ4_decompress_seekable_range() :
+ *  Decodes bytes [offset, offset+len) of the content into `dst`.
+ *  The range is clipped to the end of the content.
+ *  Blocks fully covered are decoded straight into `dst`, without intermediate copy.
+ * @return : number of bytes written into `dst`,
+ *           or a negative value if `offset` is beyond the content, `dstCapacity` is too small
+ *           for the (clipped) range, or a block is malformed.
+ */
+LZ4LIB_API int LZ4_decompress_seekable_range(LZ4_seekReader* reader,
+                                             void* dst, int dstCapacity,
+                                             unsigned long long offset, int len);
+
+#endif /* LZ4SEEK_H_61840527 */
+
+#if defined (__cplusplus)
+}
+#endif
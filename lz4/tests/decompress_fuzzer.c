@@ -0,0 +1,181 @@
+// Fuzz target for LZ4_decompress_safe(), LZ4_decompress_safe_partial() and LZ4_decompress_safe_usingDict().
+// Builds with libFuzzer (-fsanitize=fuzzer), or with fuzz_main.c to replay inputs.
+//
+// Besides memory safety, every result is checked against the reference decoder (reference_decoder.c) :
+//   - each decoding kernel available on the host (LZ4_decompress_safe_withKernel()) must return
+//     the same value as the others, and the same bytes when it succeeds,
+//   - whenever the reference decoder accepts a block, each API must decode it to the same bytes,
+//     LZ4_decompress_safe_partial() stopping at its target size,
+//   - no API may report more bytes than it was allowed to write.
+//
+// Input layout : | mode | capacity (2 bytes LE) | dictionary selector | dictionary | block |
+//   mode bit 0    : round trip, the "block" is first compressed with LZ4_compress_fast_continue(),
+//                   so that valid blocks are exercised too, not only malformed ones
+//   mode bits 1-3 : acceleration - 1 of the round trip
+//   mode bits 4-7 : target of LZ4_decompress_safe_partial(), in 16ths of the capacity
+//   dictionary selector : dictionary size in 256-byte units (255 : 64 KB), capped by the input size
+//
+// tests/corpus holds seeds and past regressions, replayed by `make fuzz` :
+//   offset0 : matches with offset 0, which every kernel must decode to the same bytes
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define LZ4_STATIC_LINKING_ONLY   // LZ4_decompress_safe_withKernel()
+#include "lz4.h"
+#include "reference_decoder.h"
+
+#define FUZZ_HEADER_SIZE 4
+
+#define FUZZ_ASSERT(c)                                                          \
+    do {                                                                        \
+        if (!(c)) {                                                             \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #c); \
+            abort();                                                            \
+        }                                                                       \
+    } while (0)
+
+static const LZ4_decodeKernel_e kernels[] = {
+    LZ4_decodeKernel_portable, LZ4_decodeKernel_ssse3, LZ4_decodeKernel_avx2, LZ4_decodeKernel_neon
+};
+
+static char* alloc_buffer(size_t size) {
+    char* const p = (char*)malloc(size ? size : 1);
+    FUZZ_ASSERT(p != NULL);
+    return p;
+}
+
+// LZ4_decompress_safe(), and each kernel, against the reference
+static void check_no_dict(const char* src, int src_size, int capacity) {
+    char* const expected = alloc_buffer((size_t)capacity);
+    char* const first = alloc_buffer((size_t)capacity);
+    char* const out = alloc_buffer((size_t)capacity);
+    int ref_size, first_size;
+    size_t k;
+
+    // distinct stale contents : a kernel reading output it hasn't written yet can't match the others
+    memset(first, 0xA5, (size_t)capacity);
+    ref_size = LZ4_reference_decompress(src, expected, src_size, capacity, NULL, 0);
+    first_size = LZ4_decompress_safe(src, first, src_size, capacity);
+
+    FUZZ_ASSERT(first_size <= capacity);
+    if (ref_size >= 0) {
+        FUZZ_ASSERT(first_size == ref_size);
+        FUZZ_ASSERT(memcmp(first, expected, (size_t)ref_size) == 0);
+    }
+    for (k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        int size;
+        if (!LZ4_decodeKernelAvailable(kernels[k])) continue;
+        memset(out, (int)(0x5A + k), (size_t)capacity);
+        size = LZ4_decompress_safe_withKernel(src, out, src_size, capacity, kernels[k]);
+        FUZZ_ASSERT(size == first_size);
+        if (size > 0) FUZZ_ASSERT(memcmp(out, first, (size_t)size) == 0);
+    }
+
+    free(out);
+    free(first);
+    free(expected);
+}
+
+// LZ4_decompress_safe_partial() : must stop at its target on valid blocks
+static void check_partial(const char* src, int src_size, int capacity, int target) {
+    char* const expected = alloc_buffer((size_t)capacity);
+    char* const out = alloc_buffer((size_t)capacity);
+    int const ref_size = LZ4_reference_decompress(src, expected, src_size, capacity, NULL, 0);
+    int const size = LZ4_decompress_safe_partial(src, out, src_size, target, capacity);
+
+    FUZZ_ASSERT(size <= target);
+    if (ref_size >= 0) {
+        int const expected_size = (ref_size < target) ? ref_size : target;
+        FUZZ_ASSERT(size == expected_size);
+        FUZZ_ASSERT(memcmp(out, expected, (size_t)size) == 0);
+    }
+
+    free(out);
+    free(expected);
+}
+
+// LZ4_decompress_safe_usingDict(), with the dictionary in its own buffer (external dictionary),
+// then right before the output (prefix)
+static void check_dict(const char* src, int src_size, int capacity, const char* dict, int dict_size) {
+    char* const expected = alloc_buffer((size_t)capacity);
+    char* const ext_dict = alloc_buffer((size_t)dict_size);
+    char* const out = alloc_buffer((size_t)capacity);
+    char* const prefixed = alloc_buffer((size_t)dict_size + (size_t)capacity);
+    int const ref_size = LZ4_reference_decompress(src, expected, src_size, capacity, dict, dict_size);
+    int size;
+
+    memcpy(ext_dict, dict, (size_t)dict_size);
+    size = LZ4_decompress_safe_usingDict(src, out, src_size, capacity, ext_dict, dict_size);
+    FUZZ_ASSERT(size <= capacity);
+    if (ref_size >= 0) {
+        FUZZ_ASSERT(size == ref_size);
+        FUZZ_ASSERT(memcmp(out, expected, (size_t)size) == 0);
+    }
+
+    memcpy(prefixed, dict, (size_t)dict_size);
+    size = LZ4_decompress_safe_usingDict(src, prefixed + dict_size, src_size, capacity, prefixed, dict_size);
+    FUZZ_ASSERT(size <= capacity);
+    if (ref_size >= 0) {
+        FUZZ_ASSERT(size == ref_size);
+        FUZZ_ASSERT(memcmp(prefixed + dict_size, expected, (size_t)size) == 0);
+    }
+
+    free(prefixed);
+    free(out);
+    free(ext_dict);
+    free(expected);
+}
+
+static void check_block(const char* src, int src_size, int capacity, int target,
+                        const char* dict, int dict_size) {
+    check_no_dict(src, src_size, capacity);
+    check_partial(src, src_size, capacity, target);
+    if (dict_size > 0) check_dict(src, src_size, capacity, dict, dict_size);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    unsigned mode;
+    int capacity, dict_size, payload_size, src_size, target;
+    const char* dict;
+    const char* src;
+
+    if (size < FUZZ_HEADER_SIZE || size - FUZZ_HEADER_SIZE > (size_t)LZ4_MAX_INPUT_SIZE) return 0;
+    mode = data[0];
+    capacity = data[1] | (data[2] << 8);
+    dict_size = (data[3] == 255) ? (64 << 10) : (data[3] << 8);
+    payload_size = (int)(size - FUZZ_HEADER_SIZE);
+    if (dict_size > payload_size) dict_size = payload_size;
+    dict = (const char*)data + FUZZ_HEADER_SIZE;
+    src = dict + dict_size;
+    src_size = payload_size - dict_size;
+
+    if (mode & 1) {
+        // round trip : the block is valid, and must decode back to the source
+        int const bound = LZ4_compressBound(src_size);
+        char* const compressed = alloc_buffer((size_t)bound);
+        char* const decoded = alloc_buffer((size_t)src_size);
+        LZ4_stream_t* const stream = LZ4_createStream();
+        int c_size;
+
+        FUZZ_ASSERT(stream != NULL);
+        LZ4_loadDict(stream, dict, dict_size);
+        c_size = LZ4_compress_fast_continue(stream, src, compressed, src_size, bound, (int)((mode >> 1) & 7) + 1);
+        FUZZ_ASSERT(c_size > 0);
+        FUZZ_ASSERT(LZ4_reference_decompress(compressed, decoded, c_size, src_size, dict, dict_size) == src_size);
+        FUZZ_ASSERT(memcmp(decoded, src, (size_t)src_size) == 0);
+
+        capacity = src_size + capacity % 64;   // exact size, or a little more
+        target = capacity - (int)(((long long)capacity * (mode >> 4)) / 16);
+        check_block(compressed, c_size, capacity, target, dict, dict_size);
+
+        LZ4_freeStream(stream);
+        free(decoded);
+        free(compressed);
+    } else {
+        target = capacity - (int)(((long long)capacity * (mode >> 4)) / 16);
+        check_block(src, src_size, capacity, target, dict, dict_size);
+    }
+    return 0;
+}
@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define LZ4_STATIC_LINKING_ONLY   // LZ4_decompress_safe_withKernel()
+#include "lz4.h"
+#include "lz4hc.h"
+#include "reference_decoder.h"
+
+// Differential check and performance regression test of the decoding kernels.
+//
+// Synthetic inputs, chosen to stress each copy path (long literal runs, short offsets, long matches, ...),
+// are cut into blocks, compressed with LZ4_compress_default() and LZ4_compress_HC(),
+// then decoded by the reference decoder and by each kernel available on the host.
+// Every kernel must reproduce the reference output exactly.
+// Speeds are reported relative to the portable kernel, measured on the same machine within the same run,
+// so they can be compared across machines, and used as a regression gate.
+//
+// usage : differential [-b SIZE,SIZE,...] [-r ROUNDS] [-t TOLERANCE]
+//   -b : block sizes, K and M suffixes accepted. Default : 4K,64K,1M.
+//   -r : timed rounds per measurement, the fastest one is kept. Default : 5.
+//   -t : fails when a SIMD kernel is slower than the portable one by more than TOLERANCE (e.g. 0.05 = 5%).
+//        Default : speeds are only reported.
+// Exit code : 0 on success, 1 when a kernel disagrees with the reference, 2 on a speed regression.
+
+#define DIFF_DATA_SIZE      (4 << 20)
+#define DIFF_BLOCKSIZES_MAX 8
+#define DIFF_HC_LEVEL       9
+
+typedef enum { data_text, data_short_offsets, data_literals, data_long_matches, data_count } data_distribution;
+
+static const char* const distribution_names[data_count] = { "text", "short-offsets", "literals", "long-matches" };
+
+static const LZ4_decodeKernel_e kernels[] = {
+    LZ4_decodeKernel_portable, LZ4_decodeKernel_ssse3, LZ4_decodeKernel_avx2, LZ4_decodeKernel_neon
+};
+#define NB_KERNELS ((int)(sizeof(kernels) / sizeof(kernels[0])))
+
+static const char* const kernel_names[NB_KERNELS] = { "portable", "ssse3", "avx2", "neon" };
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+// --- Data generation ---
+
+static unsigned long long rng_state;
+
+static unsigned rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned)(rng_state >> 32);
+}
+
+// words drawn with a skewed distribution : mostly short literal runs and matches
+static void fill_text(char* p, size_t n) {
+    static const char* const words[] = {
+        "the ", "of ", "and ", "to ", "in ", "a ", "is ", "that ", "for ", "it ",
+        "as ", "was ", "with ", "be ", "by ", "on ", "not ", "he ", "this ", "are ",
+        "compression ", "algorithm ", "dictionary ", "performance ", "benchmark ",
+        "throughput ", "latency ", "memory ", "buffer ", "stream ", ".\n", ", "
+    };
+    size_t const nb_words = sizeof(words) / sizeof(words[0]);
+    size_t i = 0;
+    while (i < n) {
+        unsigned const r = rng_next();
+        const char* const w = words[((r & 0xFFFF) * (r >> 16 & 0xFFFF) >> 16) % nb_words];
+        size_t len = strlen(w);
+        if (len > n - i) len = n - i;
+        memcpy(p + i, w, len);
+        i += len;
+    }
+}
+
+// repeated patterns of 1 to 15 bytes : overlapping matches, handled by the short offset kernels
+static void fill_short_offsets(char* p, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        unsigned const r = rng_next();
+        size_t const period = 1 + (r & 15) % 15;
+        size_t len = 16 + ((r >> 8) & 255);
+        size_t j;
+        if (len > n - i) len = n - i;
+        for (j = 0; j < len; j++) p[i + j] = (j < period) ? (char)rng_next() : p[i + j - period];
+        i += len;
+    }
+}
+
+// mostly random bytes, with a few matches : long literal runs
+static void fill_literals(char* p, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        unsigned const r = rng_next();
+        size_t len = 64 + (r & 1023);
+        size_t j;
+        if (len > n - i) len = n - i;
+        if (i >= 4096 && (r >> 16) % 4 == 0) {
+            memcpy(p + i, p + i - 1024 - ((r >> 20) & 2047), len < 64 ? len : 64);
+            j = len < 64 ? len : 64;
+        } else {
+            j = 0;
+        }
+        for (; j < len; j++) p[i + j] = (char)rng_next();
+        i += len;
+    }
+}
+
+// copies of earlier segments, with a few modified bytes : long matches with large offsets
+static void fill_long_matches(char* p, size_t n) {
+    size_t i = 0;
+    while (i < n) {
+        unsigned const r = rng_next();
+        size_t len = 256 + (r & 4095);
+        if (len > n - i) len = n - i;
+        if (i < 65536) {
+            size_t j;
+            for (j = 0; j < len; j++) p[i + j] = (char)rng_next();
+        } else {
+            size_t const offset = 32 + (rng_next() % 65000);
+            size_t j;
+            for (j = 0; j < len; j++) p[i + j] = p[i + j - offset];
+            p[i + len - 1] = (char)rng_next();
+        }
+        i += len;
+    }
+}
+
+static void fill_data(char* p, size_t n, data_distribution dist) {
+    rng_state = 0x9E3779B97F4A7C15ULL;
+    switch (dist) {
+    case data_text:          fill_text(p, n); break;
+    case data_short_offsets: fill_short_offsets(p, n); break;
+    case data_literals:      fill_literals(p, n); break;
+    case data_long_matches:  fill_long_matches(p, n); break;
+    default: break;
+    }
+}
+
+
+// --- Compressed blocks ---
+
+typedef struct {
+    char* compressed;       // blocks back to back
+    int* c_sizes;
+    int nb_blocks;
+    int block_size;
+    int src_size;
+    size_t total_c_size;
+} block_set;
+
+static int compress_blocks(block_set* set, const char* src, int src_size, int block_size, int hc) {
+    int b;
+    size_t pos = 0;
+    set->nb_blocks = (src_size + block_size - 1) / block_size;
+    set->block_size = block_size;
+    set->src_size = src_size;
+    set->c_sizes = (int*)malloc((size_t)set->nb_blocks * sizeof(int));
+    set->compressed = (char*)malloc((size_t)set->nb_blocks * (size_t)LZ4_compressBound(block_size));
+    if (set->c_sizes == NULL || set->compressed == NULL) return 1;
+    for (b = 0; b < set->nb_blocks; b++) {
+        int const size = (b == set->nb_blocks - 1) ? src_size - b * block_size : block_size;
+        int const bound = LZ4_compressBound(size);
+        const char* const block = src + (size_t)b * (size_t)block_size;
+        int const c_size = hc ? LZ4_compress_HC(block, set->compressed + pos, size, bound, DIFF_HC_LEVEL)
+                              : LZ4_compress_default(block, set->compressed + pos, size, bound);
+        if (c_size <= 0) return 1;
+        set->c_sizes[b] = c_size;
+        pos += (size_t)c_size;
+    }
+    set->total_c_size = pos;
+    return 0;
+}
+
+static void free_blocks(block_set* set) {
+    free(set->compressed);
+    free(set->c_sizes);
+}
+
+// decodes all blocks, with the reference decoder when kernel < 0
+// returns the number of blocks which fail to decode to `expected`
+static int decode_blocks(const block_set* set, char* dst, int kernel) {
+    int b, errors = 0;
+    size_t pos = 0;
+    for (b = 0; b < set->nb_blocks; b++) {
+        int const size = (b == set->nb_blocks - 1) ? set->src_size - b * set->block_size : set->block_size;
+        char* const out = dst + (size_t)b * (size_t)set->block_size;
+        int const d_size = (kernel < 0)
+            ? LZ4_reference_decompress(set->compressed + pos, out, set->c_sizes[b], size, NULL, 0)
+            : LZ4_decompress_safe_withKernel(set->compressed + pos, out, set->c_sizes[b], size, kernels[kernel]);
+        if (d_size != size) errors++;
+        pos += (size_t)set->c_sizes[b];
+    }
+    return errors;
+}
+
+// MB/s of the fastest round
+static double measure(const block_set* set, char* dst, int kernel, int nb_rounds) {
+    double best = 0;
+    int r;
+    for (r = 0; r < nb_rounds; r++) {
+        double const start = now_ns();
+        double elapsed;
+        decode_blocks(set, dst, kernel);
+        elapsed = now_ns() - start;
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    return (double)set->src_size / (best / 1e9) / (1 << 20);
+}
+
+
+// --- Command line ---
+
+static int parse_size(const char* s, int* value) {
+    char* end;
+    long n = strtol(s, &end, 10);
+    if (end == s || n <= 0) return 1;
+    if (*end == 'K' || *end == 'k') { n <<= 10; end++; }
+    else if (*end == 'M' || *end == 'm') { n <<= 20; end++; }
+    if (*end != '\0' || n > DIFF_DATA_SIZE) return 1;
+    *value = (int)n;
+    return 0;
+}
+
+static int parse_size_list(const char* s, int* values, int nb_max) {
+    int nb = 0;
+    char buffer[256];
+    char* token;
+    if (strlen(s) >= sizeof(buffer)) return 0;
+    strcpy(buffer, s);
+    for (token = strtok(buffer, ","); token != NULL; token = strtok(NULL, ",")) {
+        if (nb == nb_max || parse_size(token, &values[nb]) != 0) return 0;
+        nb++;
+    }
+    return nb;
+}
+
+int main(int argc, char** argv) {
+    int block_sizes[DIFF_BLOCKSIZES_MAX] = { 4 << 10, 64 << 10, 1 << 20 };
+    int nb_block_sizes = 3;
+    int nb_rounds = 5;
+    double tolerance = -1;
+    int mismatches = 0, regressions = 0;
+    int i, k;
+    char* const src = (char*)malloc(DIFF_DATA_SIZE);
+    char* const dst = (char*)malloc(DIFF_DATA_SIZE);
+    data_distribution dist;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+            nb_block_sizes = parse_size_list(argv[++i], block_sizes, DIFF_BLOCKSIZES_MAX);
+            if (nb_block_sizes == 0) { fprintf(stderr, "invalid block sizes : %s\n", argv[i]); return 1; }
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            nb_rounds = atoi(argv[++i]);
+            if (nb_rounds < 1) nb_rounds = 1;
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else {
+            fprintf(stderr, "usage : %s [-b SIZE,SIZE,...] [-r ROUNDS] [-t TOLERANCE]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (src == NULL || dst == NULL) { fprintf(stderr, "not enough memory\n"); return 1; }
+
+    printf("%-14s %-5s %8s %6s %10s", "data", "codec", "block", "ratio", "reference");
+    for (k = 0; k < NB_KERNELS; k++) {
+        if (LZ4_decodeKernelAvailable(kernels[k])) printf(" %16s", kernel_names[k]);
+    }
+    printf("   (MB/s, x portable)\n");
+
+    for (dist = data_text; dist < data_count; dist++) {
+        fill_data(src, DIFF_DATA_SIZE, dist);
+        for (i = 0; i < nb_block_sizes; i++) {
+            int hc;
+            for (hc = 0; hc <= 1; hc++) {
+                block_set set;
+                double portable_speed = 0;
+                if (compress_blocks(&set, src, DIFF_DATA_SIZE, block_sizes[i], hc) != 0) {
+                    fprintf(stderr, "compression failed\n");
+                    return 1;
+                }
+                printf("%-14s %-5s %7dK %6.3f", distribution_names[dist], hc ? "hc" : "fast",
+                       block_sizes[i] >> 10, (double)DIFF_DATA_SIZE / (double)set.total_c_size);
+
+                // the reference output must match the source before it can judge the kernels
+                memset(dst, 0, DIFF_DATA_SIZE);
+                if (decode_blocks(&set, dst, -1) != 0 || memcmp(dst, src, DIFF_DATA_SIZE) != 0) {
+                    printf("  reference decoder MISMATCH\n");
+                    mismatches++;
+                    free_blocks(&set);
+                    continue;
+                }
+                printf(" %10.1f", measure(&set, dst, -1, 1));
+
+                for (k = 0; k < NB_KERNELS; k++) {
+                    double speed;
+                    if (!LZ4_decodeKernelAvailable(kernels[k])) continue;
+                    memset(dst, 0, DIFF_DATA_SIZE);
+                    if (decode_blocks(&set, dst, k) != 0 || memcmp(dst, src, DIFF_DATA_SIZE) != 0) {
+                        printf(" %16s", "MISMATCH");
+                        mismatches++;
+                        continue;
+                    }
+                    speed = measure(&set, dst, k, nb_rounds);
+                    if (kernels[k] == LZ4_decodeKernel_portable) portable_speed = speed;
+                    printf(" %8.1f (%.2fx)", speed, speed / portable_speed);
+                    if (tolerance >= 0 && speed < portable_speed * (1 - tolerance)) {
+                        printf(" REGRESSION");
+                        regressions++;
+                    }
+                }
+                printf("\n");
+                free_blocks(&set);
+            }
+        }
+    }
+
+    free(dst);
+    free(src);
+    if (mismatches) { printf("%d mismatch(es) against the reference decoder\n", mismatches); return 1; }
+    if (regressions) { printf("%d speed regression(s) beyond %.0f%%\n", regressions, tolerance * 100); return 2; }
+    printf("All kernels match the reference decoder\n");
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Fuzz target entry point for building without libFuzzer :
+// runs LLVMFuzzerTestOneInput() once per file given on the command line.
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+static int run_file(const char* name) {
+    FILE* const f = fopen(name, "rb");
+    char* buf = NULL;
+    long size;
+    int result = 1;
+
+    if (f == NULL) {
+        fprintf(stderr, "error opening input file %s\n", name);
+        return 1;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0) goto out;
+    rewind(f);
+    buf = (char*)malloc(size ? (size_t)size : 1);
+    if (buf == NULL) {
+        fprintf(stderr, "malloc() failed\n");
+        goto out;
+    }
+    if (size > 0 && fread(buf, (size_t)size, 1, f) != 1) {
+        fprintf(stderr, "fread() failed\n");
+        goto out;
+    }
+    (void)LLVMFuzzerTestOneInput((const uint8_t*)buf, (size_t)size);
+    result = 0;
+
+out:
+    free(buf);
+    fclose(f);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    int i, errors = 0;
+    if (argc < 2) {
+        fprintf(stderr, "usage : %s FILE...\n", argv[0]);
+        return 1;
+    }
+    for (i = 1; i < argc; i++) errors += run_file(argv[i]);
+    return errors != 0;
+}
@@ -0,0 +1,74 @@
+#include <limits.h>
+#include <stddef.h>
+#include "reference_decoder.h"
+
+#define REF_MINMATCH      4
+#define REF_MFLIMIT       12
+#define REF_LASTLITERALS  5
+
+// Adds the extra length bytes following a token field equal to 15.
+// Returns 0 on success, -1 when reading past the end of the block.
+static int read_length(const unsigned char** ip, const unsigned char* iend, size_t* length) {
+    unsigned s;
+    do {
+        if (*ip >= iend) return -1;
+        s = *(*ip)++;
+        *length += s;
+        if (*length > INT_MAX) return -1;
+    } while (s == 255);
+    return 0;
+}
+
+int LZ4_reference_decompress(const char* src, char* dst, int srcSize, int dstCapacity,
+                             const char* dict, int dictSize) {
+    const unsigned char* ip = (const unsigned char*)src;
+    const unsigned char* const iend = ip + (srcSize > 0 ? srcSize : 0);
+    unsigned char* const ostart = (unsigned char*)dst;
+    unsigned char* op = ostart;
+    const unsigned char* const dictEnd = (const unsigned char*)dict + dictSize;
+    size_t const capacity = (size_t)(dstCapacity > 0 ? dstCapacity : 0);
+    size_t last_match_start = 0, last_match_end = 0;
+    int has_match = 0;
+
+    if (src == NULL || srcSize <= 0 || dstCapacity < 0 || dictSize < 0) return -1;
+    if (dict == NULL && dictSize > 0) return -1;
+
+    while (1) {
+        unsigned token;
+        size_t length, offset, n;
+
+        // literals
+        if (ip >= iend) return -1;
+        token = *ip++;
+        length = token >> 4;
+        if (length == 15 && read_length(&ip, iend, &length) != 0) return -1;
+        if (length > (size_t)(iend - ip)) return -1;
+        if (length > capacity - (size_t)(op - ostart)) return -1;
+        for (n = 0; n < length; n++) *op++ = *ip++;
+        if (ip == iend) break;   // the last sequence has no match
+
+        // match
+        if (iend - ip < 2) return -1;
+        offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - ostart) + (size_t)dictSize) return -1;
+        length = token & 15;
+        if (length == 15 && read_length(&ip, iend, &length) != 0) return -1;
+        length += REF_MINMATCH;
+        if (length > capacity - (size_t)(op - ostart)) return -1;
+        last_match_start = (size_t)(op - ostart);
+        for (n = 0; n < length; n++, op++) {
+            size_t const pos = (size_t)(op - ostart);
+            *op = (pos >= offset) ? op[-(ptrdiff_t)offset] : dictEnd[-(ptrdiff_t)(offset - pos)];
+        }
+        last_match_end = (size_t)(op - ostart);
+        has_match = 1;
+    }
+
+    if (has_match) {
+        size_t const decoded = (size_t)(op - ostart);
+        if (last_match_start + REF_MFLIMIT > decoded) return -1;
+        if (last_match_end + REF_LASTLITERALS > decoded) return -1;
+    }
+    return (int)(op - ostart);
+}
@@ -0,0 +1,22 @@
+#ifndef LZ4_REFERENCE_DECODER_H
+#define LZ4_REFERENCE_DECODER_H
+
+// Reference decoder of the LZ4 block format, used to cross-check lz4.c.
+//
+// It copies one byte at a time, and shares no code with lz4.c :
+// no wild copies, no fast loop, no SIMD kernel. It is slow, and meant to be obviously right.
+// It validates everything the block format requires :
+//   - offsets are within [1, decoded bytes + dictSize]
+//   - the last sequence only has literals
+//   - the last match starts at least 12 bytes (MFLIMIT) before the end of the block,
+//     and ends at least 5 bytes (LASTLITERALS) before it.
+// lz4.c checks the end-of-block rules against dstCapacity rather than against the decoded size,
+// so it may accept a few blocks the reference rejects, but never the other way around.
+
+// Decodes the block `src` into `dst`.
+// `dict` is the history preceding `dst` (its last `dictSize` bytes), it can be NULL when dictSize == 0.
+// Returns the decoded size, or -1 if the block is invalid or dstCapacity is too small.
+int LZ4_reference_decompress(const char* src, char* dst, int srcSize, int dstCapacity,
+                             const char* dict, int dictSize);
+
+#endif // LZ4_REFERENCE_DECODER_H
@@ -0,0 +1,624 @@
+/*
+ *  xxHash - Extremely Fast Hash algorithm
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <string.h>   /* memcpy */
+#include "xxhash.h"
+
+
+/*-************************************
+*  Tuning parameters
+**************************************/
+/*!XXH_VECTOR :
+ * SIMD flavor of the XXH64() stripe loop.
+ * Default : XXH_SCALAR. The SIMD flavors emulate the 64-bit multiply from 32x32->64 products,
+ * and xxhash_bench measures them about 3x slower than the scalar loop on x86 (AVX2 : 7.0 vs 23.4 GB/s).
+ * A SIMD flavor can be selected for a target where it measures faster,
+ * for instance with -DXXH_VECTOR=XXH_NEON. */
+#define XXH_SCALAR 0   /* portable scalar loop */
+#define XXH_SSE2   1   /* x86-64, or x86 with -msse2 */
+#define XXH_AVX2   2   /* x86 with -mavx2 */
+#define XXH_NEON   3   /* little-endian ARM NEON / AArch64 */
+
+#ifndef XXH_VECTOR
+#  define XXH_VECTOR XXH_SCALAR
+#endif
+
+#if (XXH_VECTOR == XXH_AVX2)
+#  include <immintrin.h>
+#elif (XXH_VECTOR == XXH_SSE2)
+#  include <emmintrin.h>
+#elif (XXH_VECTOR == XXH_NEON)
+#  include <arm_neon.h>
+#endif
+
+
+/*-************************************
+*  Compiler Options
+**************************************/
+#ifdef _MSC_VER    /* Visual Studio */
+#  define XXH_FORCE_INLINE static __forceinline
+#  define XXH_rotl32(x,r) _rotl(x,r)
+#  define XXH_rotl64(x,r) _rotl64(x,r)
+#else
+#  if defined (__GNUC__) || defined (__clang__)
+#    define XXH_FORCE_INLINE static inline __attribute__((always_inline))
+#  elif defined (__cplusplus) || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L))   /* C99 */
+#    define XXH_FORCE_INLINE static inline
+#  else
+#    define XXH_FORCE_INLINE static
+#  endif
+#  define XXH_rotl32(x,r) (((x) << (r)) | ((x) >> (32 - (r))))
+#  define XXH_rotl64(x,r) (((x) << (r)) | ((x) >> (64 - (r))))
+#endif
+
+
+/*-************************************
+*  Basic Types
+**************************************/
+typedef unsigned char BYTE;
+typedef XXH32_hash_t  U32;
+typedef XXH64_hash_t  U64;
+
+
+/*-************************************
+*  Memory access
+**************************************/
+static unsigned XXH_isLittleEndian(void)
+{
+    const union { U32 u; BYTE c[4]; } one = { 1 };   /* don't use static : performance detrimental */
+    return one.c[0];
+}
+
+static U32 XXH_swap32 (U32 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(x);
+#else
+    return  ((x << 24) & 0xff000000 ) |
+            ((x <<  8) & 0x00ff0000 ) |
+            ((x >>  8) & 0x0000ff00 ) |
+            ((x >> 24) & 0x000000ff );
+#endif
+}
+
+static U64 XXH_swap64 (U64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(x);
+#else
+    return  ((x << 56) & 0xff00000000000000ULL) |
+            ((x << 40) & 0x00ff000000000000ULL) |
+            ((x << 24) & 0x0000ff0000000000ULL) |
+            ((x << 8)  & 0x000000ff00000000ULL) |
+            ((x >> 8)  & 0x00000000ff000000ULL) |
+            ((x >> 24) & 0x0000000000ff0000ULL) |
+            ((x >> 40) & 0x000000000000ff00ULL) |
+            ((x >> 56) & 0x00000000000000ffULL);
+#endif
+}
+
+/* memcpy() is the portable way to express an unaligned access,
+ * modern compilers translate it into a single load */
+XXH_FORCE_INLINE U32 XXH_readLE32(const void* ptr)
+{
+    U32 val;
+    memcpy(&val, ptr, sizeof(val));
+    return XXH_isLittleEndian() ? val : XXH_swap32(val);
+}
+
+XXH_FORCE_INLINE U64 XXH_readLE64(const void* ptr)
+{
+    U64 val;
+    memcpy(&val, ptr, sizeof(val));
+    return XXH_isLittleEndian() ? val : XXH_swap64(val);
+}
+
+
+/*-************************************
+*  32-bit hash functions
+**************************************/
+#define XXH_PRIME32_1  0x9E3779B1U
+#define XXH_PRIME32_2  0x85EBCA77U
+#define XXH_PRIME32_3  0xC2B2AE3DU
+#define XXH_PRIME32_4  0x27D4EB2FU
+#define XXH_PRIME32_5  0x165667B1U
+
+XXH_FORCE_INLINE U32 XXH32_round(U32 acc, U32 input)
+{
+    acc += input * XXH_PRIME32_2;
+    acc  = XXH_rotl32(acc, 13);
+    acc *= XXH_PRIME32_1;
+    return acc;
+}
+
+static U32 XXH32_avalanche(U32 h32)
+{
+    h32 ^= h32 >> 15;
+    h32 *= XXH_PRIME32_2;
+    h32 ^= h32 >> 13;
+    h32 *= XXH_PRIME32_3;
+    h32 ^= h32 >> 16;
+    return h32;
+}
+
+/* XXH32_finalize() :
+ * Processes the last 0-15 bytes of input */
+static U32 XXH32_finalize(U32 h32, const BYTE* p, size_t len)
+{
+    while (len >= 4) {
+        h32 += XXH_readLE32(p) * XXH_PRIME32_3;
+        h32  = XXH_rotl32(h32, 17) * XXH_PRIME32_4;
+        p += 4; len -= 4;
+    }
+    while (len > 0) {
+        h32 += (*p++) * XXH_PRIME32_5;
+        h32  = XXH_rotl32(h32, 11) * XXH_PRIME32_1;
+        len--;
+    }
+    return XXH32_avalanche(h32);
+}
+
+XXH_PUBLIC_API XXH32_hash_t XXH32 (const void* input, size_t len, XXH32_hash_t seed)
+{
+    const BYTE* p = (const BYTE*)input;
+    const BYTE* const bEnd = p + len;
+    U32 h32;
+
+    if (len >= 16) {
+        const BYTE* const limit = bEnd - 15;
+        U32 v1 = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+        U32 v2 = seed + XXH_PRIME32_2;
+        U32 v3 = seed + 0;
+        U32 v4 = seed - XXH_PRIME32_1;
+
+        do {
+            v1 = XXH32_round(v1, XXH_readLE32(p)); p+=4;
+            v2 = XXH32_round(v2, XXH_readLE32(p)); p+=4;
+            v3 = XXH32_round(v3, XXH_readLE32(p)); p+=4;
+            v4 = XXH32_round(v4, XXH_readLE32(p)); p+=4;
+        } while (p < limit);
+
+        h32 = XXH_rotl32(v1, 1)  + XXH_rotl32(v2, 7)
+            + XXH_rotl32(v3, 12) + XXH_rotl32(v4, 18);
+    } else {
+        h32  = seed + XXH_PRIME32_5;
+    }
+
+    h32 += (U32)len;
+
+    return XXH32_finalize(h32, p, len&15);
+}
+
+
+/*-************************************
+*  32-bit streaming
+**************************************/
+XXH_PUBLIC_API void XXH32_reset(XXH32_state_t* statePtr, XXH32_hash_t seed)
+{
+    memset(statePtr, 0, sizeof(*statePtr));
+    statePtr->v[0] = seed + XXH_PRIME32_1 + XXH_PRIME32_2;
+    statePtr->v[1] = seed + XXH_PRIME32_2;
+    statePtr->v[2] = seed + 0;
+    statePtr->v[3] = seed - XXH_PRIME32_1;
+}
+
+XXH_PUBLIC_API void XXH32_update(XXH32_state_t* state, const void* input, size_t len)
+{
+    const BYTE* p = (const BYTE*)input;
+    const BYTE* const bEnd = p + len;
+
+    if (len == 0) return;
+
+    state->total_len_32 += (U32)len;
+    state->large_len |= (U32)((len>=16) | (state->total_len_32>=16));
+
+    if (state->memsize + len < 16)  {   /* fill in tmp buffer */
+        memcpy((BYTE*)(state->mem32) + state->memsize, input, len);
+        state->memsize += (U32)len;
+        return;
+    }
+
+    if (state->memsize) {   /* some data left from previous update */
+        memcpy((BYTE*)(state->mem32) + state->memsize, input, 16-state->memsize);
+        {   const BYTE* const m = (const BYTE*)state->mem32;
+            state->v[0] = XXH32_round(state->v[0], XXH_readLE32(m+0));
+            state->v[1] = XXH32_round(state->v[1], XXH_readLE32(m+4));
+            state->v[2] = XXH32_round(state->v[2], XXH_readLE32(m+8));
+            state->v[3] = XXH32_round(state->v[3], XXH_readLE32(m+12));
+        }
+        p += 16-state->memsize;
+        state->memsize = 0;
+    }
+
+    if (p <= bEnd-16) {
+        const BYTE* const limit = bEnd - 16;
+        U32 v1 = state->v[0];
+        U32 v2 = state->v[1];
+        U32 v3 = state->v[2];
+        U32 v4 = state->v[3];
+
+        do {
+            v1 = XXH32_round(v1, XXH_readLE32(p)); p+=4;
+            v2 = XXH32_round(v2, XXH_readLE32(p)); p+=4;
+            v3 = XXH32_round(v3, XXH_readLE32(p)); p+=4;
+            v4 = XXH32_round(v4, XXH_readLE32(p)); p+=4;
+        } while (p<=limit);
+
+        state->v[0] = v1;
+        state->v[1] = v2;
+        state->v[2] = v3;
+        state->v[3] = v4;
+    }
+
+    if (p < bEnd) {
+        memcpy(state->mem32, p, (size_t)(bEnd-p));
+        state->memsize = (unsigned)(bEnd-p);
+    }
+}
+
+XXH_PUBLIC_API XXH32_hash_t XXH32_digest(const XXH32_state_t* state)
+{
+    U32 h32;
+
+    if (state->large_len) {
+        h32 = XXH_rotl32(state->v[0], 1)
+            + XXH_rotl32(state->v[1], 7)
+            + XXH_rotl32(state->v[2], 12)
+            + XXH_rotl32(state->v[3], 18);
+    } else {
+        h32 = state->v[2] /* == seed */ + XXH_PRIME32_5;
+    }
+
+    h32 += state->total_len_32;
+
+    return XXH32_finalize(h32, (const BYTE*)state->mem32, state->memsize);
+}
+
+
+/*-************************************
+*  64-bit hash functions
+**************************************/
+#define XXH_PRIME64_1  0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2  0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3  0x165667B19E3779F9ULL
+#define XXH_PRIME64_4  0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5  0x27D4EB2F165667C5ULL
+
+XXH_FORCE_INLINE U64 XXH64_round(U64 acc, U64 input)
+{
+    acc += input * XXH_PRIME64_2;
+    acc  = XXH_rotl64(acc, 31);
+    acc *= XXH_PRIME64_1;
+    return acc;
+}
+
+static U64 XXH64_mergeRound(U64 acc, U64 val)
+{
+    val  = XXH64_round(0, val);
+    acc ^= val;
+    acc  = acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+    return acc;
+}
+
+static U64 XXH64_avalanche(U64 h64)
+{
+    h64 ^= h64 >> 33;
+    h64 *= XXH_PRIME64_2;
+    h64 ^= h64 >> 29;
+    h64 *= XXH_PRIME64_3;
+    h64 ^= h64 >> 32;
+    return h64;
+}
+
+/* XXH64_finalize() :
+ * Processes the last 0-31 bytes of input */
+static U64 XXH64_finalize(U64 h64, const BYTE* p, size_t len)
+{
+    while (len >= 8) {
+        U64 const k1 = XXH64_round(0, XXH_readLE64(p));
+        p += 8;
+        h64 ^= k1;
+        h64  = XXH_rotl64(h64, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h64 ^= (U64)(XXH_readLE32(p)) * XXH_PRIME64_1;
+        p += 4;
+        h64 = XXH_rotl64(h64, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        len -= 4;
+    }
+    while (len > 0) {
+        h64 ^= (*p++) * XXH_PRIME64_5;
+        h64 = XXH_rotl64(h64, 11) * XXH_PRIME64_1;
+        len--;
+    }
+    return XXH64_avalanche(h64);
+}
+
+/* XXH64_stripes() :
+ * Accumulates `nbStripes` (>= 1) stripes of 32 bytes into the 4 lanes of `v` */
+static void XXH64_stripes(U64 v[4], const BYTE* p, size_t nbStripes)
+{
+    U64 v1 = v[0];
+    U64 v2 = v[1];
+    U64 v3 = v[2];
+    U64 v4 = v[3];
+
+    do {
+        v1 = XXH64_round(v1, XXH_readLE64(p)); p+=8;
+        v2 = XXH64_round(v2, XXH_readLE64(p)); p+=8;
+        v3 = XXH64_round(v3, XXH_readLE64(p)); p+=8;
+        v4 = XXH64_round(v4, XXH_readLE64(p)); p+=8;
+    } while (--nbStripes);
+
+    v[0] = v1;
+    v[1] = v2;
+    v[2] = v3;
+    v[3] = v4;
+}
+
+
+/*-************************************
+*  64-bit SIMD stripes
+**************************************/
+/* The 4 lanes of XXH64 are independent, so a stripe maps onto SIMD registers,
+ * one 64-bit lane per 64-bit element.
+ * None of the targets has a 64x64->64 vector multiply, so it's built from 32x32->64 products :
+ *   a*b mod 2^64 == lo(a)*lo(b) + ((hi(a)*lo(b) + lo(a)*hi(b)) << 32)
+ * Loads are native, hence these variants are only enabled on little-endian targets. */
+
+#if (XXH_VECTOR == XXH_AVX2)
+
+XXH_FORCE_INLINE __m256i XXH_mul64_avx2(__m256i a, __m256i b, __m256i bHi)
+{
+    __m256i const lo    = _mm256_mul_epu32(a, b);
+    __m256i const cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                           _mm256_mul_epu32(a, bHi));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+static void XXH64_stripes_vec(U64 v[4], const BYTE* p, size_t nbStripes)
+{
+    __m256i const prime1   = _mm256_set1_epi64x((long long)XXH_PRIME64_1);
+    __m256i const prime1Hi = _mm256_set1_epi64x((long long)(XXH_PRIME64_1 >> 32));
+    __m256i const prime2   = _mm256_set1_epi64x((long long)XXH_PRIME64_2);
+    __m256i const prime2Hi = _mm256_set1_epi64x((long long)(XXH_PRIME64_2 >> 32));
+    __m256i acc = _mm256_loadu_si256((const __m256i*)(const void*)v);
+
+    do {
+        __m256i const input = _mm256_loadu_si256((const __m256i*)(const void*)p);
+        acc = _mm256_add_epi64(acc, XXH_mul64_avx2(input, prime2, prime2Hi));
+        acc = _mm256_or_si256(_mm256_slli_epi64(acc, 31), _mm256_srli_epi64(acc, 33));
+        acc = XXH_mul64_avx2(acc, prime1, prime1Hi);
+        p += 32;
+    } while (--nbStripes);
+
+    _mm256_storeu_si256((__m256i*)(void*)v, acc);
+}
+
+#elif (XXH_VECTOR == XXH_SSE2)
+
+XXH_FORCE_INLINE __m128i XXH_mul64_sse2(__m128i a, __m128i b, __m128i bHi)
+{
+    __m128i const lo    = _mm_mul_epu32(a, b);
+    __m128i const cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                                        _mm_mul_epu32(a, bHi));
+    return _mm_add_epi64(lo, _mm_slli_epi64(cross, 32));
+}
+
+XXH_FORCE_INLINE __m128i XXH64_round_sse2(__m128i acc, __m128i input,
+                                          __m128i prime1, __m128i prime1Hi,
+                                          __m128i prime2, __m128i prime2Hi)
+{
+    acc = _mm_add_epi64(acc, XXH_mul64_sse2(input, prime2, prime2Hi));
+    acc = _mm_or_si128(_mm_slli_epi64(acc, 31), _mm_srli_epi64(acc, 33));
+    return XXH_mul64_sse2(acc, prime1, prime1Hi);
+}
+
+static void XXH64_stripes_vec(U64 v[4], const BYTE* p, size_t nbStripes)
+{
+    __m128i const prime1   = _mm_set1_epi64x((long long)XXH_PRIME64_1);
+    __m128i const prime1Hi = _mm_set1_epi64x((long long)(XXH_PRIME64_1 >> 32));
+    __m128i const prime2   = _mm_set1_epi64x((long long)XXH_PRIME64_2);
+    __m128i const prime2Hi = _mm_set1_epi64x((long long)(XXH_PRIME64_2 >> 32));
+    __m128i acc12 = _mm_loadu_si128((const __m128i*)(const void*)(v+0));
+    __m128i acc34 = _mm_loadu_si128((const __m128i*)(const void*)(v+2));
+
+    do {
+        acc12 = XXH64_round_sse2(acc12, _mm_loadu_si128((const __m128i*)(const void*)(p+0)),
+                                 prime1, prime1Hi, prime2, prime2Hi);
+        acc34 = XXH64_round_sse2(acc34, _mm_loadu_si128((const __m128i*)(const void*)(p+16)),
+                                 prime1, prime1Hi, prime2, prime2Hi);
+        p += 32;
+    } while (--nbStripes);
+
+    _mm_storeu_si128((__m128i*)(void*)(v+0), acc12);
+    _mm_storeu_si128((__m128i*)(void*)(v+2), acc34);
+}
+
+#elif (XXH_VECTOR == XXH_NEON)
+
+XXH_FORCE_INLINE uint64x2_t XXH_mul64_neon(uint64x2_t a, uint32x2_t bLo, uint32x2_t bHi)
+{
+    uint32x2_t const aLo = vmovn_u64(a);
+    uint32x2_t const aHi = vshrn_n_u64(a, 32);
+    uint64x2_t const lo  = vmull_u32(aLo, bLo);
+    uint64x2_t const cross = vmlal_u32(vmull_u32(aHi, bLo), aLo, bHi);
+    return vaddq_u64(lo, vshlq_n_u64(cross, 32));
+}
+
+XXH_FORCE_INLINE uint64x2_t XXH64_round_neon(uint64x2_t acc, uint64x2_t input,
+                                             uint32x2_t prime1Lo, uint32x2_t prime1Hi,
+                                             uint32x2_t prime2Lo, uint32x2_t prime2Hi)
+{
+    acc = vaddq_u64(acc, XXH_mul64_neon(input, prime2Lo, prime2Hi));
+    acc = vorrq_u64(vshlq_n_u64(acc, 31), vshrq_n_u64(acc, 33));
+    return XXH_mul64_neon(acc, prime1Lo, prime1Hi);
+}
+
+static void XXH64_stripes_vec(U64 v[4], const BYTE* p, size_t nbStripes)
+{
+    uint32x2_t const prime1Lo = vdup_n_u32((U32)XXH_PRIME64_1);
+    uint32x2_t const prime1Hi = vdup_n_u32((U32)(XXH_PRIME64_1 >> 32));
+    uint32x2_t const prime2Lo = vdup_n_u32((U32)XXH_PRIME64_2);
+    uint32x2_t const prime2Hi = vdup_n_u32((U32)(XXH_PRIME64_2 >> 32));
+    uint64x2_t acc12 = vld1q_u64(v+0);
+    uint64x2_t acc34 = vld1q_u64(v+2);
+
+    do {
+        acc12 = XXH64_round_neon(acc12, vreinterpretq_u64_u8(vld1q_u8(p+0)),
+                                 prime1Lo, prime1Hi, prime2Lo, prime2Hi);
+        acc34 = XXH64_round_neon(acc34, vreinterpretq_u64_u8(vld1q_u8(p+16)),
+                                 prime1Lo, prime1Hi, prime2Lo, prime2Hi);
+        p += 32;
+    } while (--nbStripes);
+
+    vst1q_u64(v+0, acc12);
+    vst1q_u64(v+2, acc34);
+}
+
+#endif  /* XXH_VECTOR */
+
+XXH_PUBLIC_API const char* XXH_vectorName(void)
+{
+    static const char* const names[] = { "scalar", "sse2", "avx2", "neon" };
+    return names[XXH_VECTOR];
+}
+
+
+typedef void (*XXH64_stripes_f)(U64 v[4], const BYTE* p, size_t nbStripes);
+
+XXH_FORCE_INLINE U64 XXH64_generic(const void* input, size_t len, U64 seed, XXH64_stripes_f stripes)
+{
+    const BYTE* p = (const BYTE*)input;
+    U64 h64;
+
+    if (len >= 32) {
+        U64 v[4];
+        v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        v[1] = seed + XXH_PRIME64_2;
+        v[2] = seed + 0;
+        v[3] = seed - XXH_PRIME64_1;
+
+        stripes(v, p, len / 32);
+        p += len & ~(size_t)31;
+
+        h64 = XXH_rotl64(v[0], 1) + XXH_rotl64(v[1], 7)
+            + XXH_rotl64(v[2], 12) + XXH_rotl64(v[3], 18);
+        h64 = XXH64_mergeRound(h64, v[0]);
+        h64 = XXH64_mergeRound(h64, v[1]);
+        h64 = XXH64_mergeRound(h64, v[2]);
+        h64 = XXH64_mergeRound(h64, v[3]);
+    } else {
+        h64  = seed + XXH_PRIME64_5;
+    }
+
+    h64 += (U64) len;
+
+    return XXH64_finalize(h64, p, len & 31);
+}
+
+XXH_PUBLIC_API XXH64_hash_t XXH64 (const void* input, size_t len, XXH64_hash_t seed)
+{
+#if (XXH_VECTOR != XXH_SCALAR)
+    if (XXH_isLittleEndian())   /* SIMD loads are native */
+        return XXH64_generic(input, len, seed, XXH64_stripes_vec);
+#endif
+    return XXH64_generic(input, len, seed, XXH64_stripes);
+}
+
+
+/*-************************************
+*  64-bit streaming
+**************************************/
+XXH_PUBLIC_API void XXH64_reset(XXH64_state_t* statePtr, XXH64_hash_t seed)
+{
+    memset(statePtr, 0, sizeof(*statePtr));
+    statePtr->v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+    statePtr->v[1] = seed + XXH_PRIME64_2;
+    statePtr->v[2] = seed + 0;
+    statePtr->v[3] = seed - XXH_PRIME64_1;
+}
+
+XXH_PUBLIC_API void XXH64_update(XXH64_state_t* state, const void* input, size_t len)
+{
+    const BYTE* p = (const BYTE*)input;
+    const BYTE* const bEnd = p + len;
+
+    if (len == 0) return;
+
+    state->total_len += len;
+
+    if (state->memsize + len < 32) {   /* fill in tmp buffer */
+        memcpy(((BYTE*)state->mem64) + state->memsize, input, len);
+        state->memsize += (U32)len;
+        return;
+    }
+
+    if (state->memsize) {   /* tmp buffer is full */
+        memcpy(((BYTE*)state->mem64) + state->memsize, input, 32-state->memsize);
+        XXH64_stripes(state->v, (const BYTE*)state->mem64, 1);
+        p += 32 - state->memsize;
+        state->memsize = 0;
+    }
+
+    if ((size_t)(bEnd - p) >= 32) {
+        size_t const nbStripes = (size_t)(bEnd - p) / 32;
+        XXH64_stripes(state->v, p, nbStripes);
+        p += nbStripes * 32;
+    }
+
+    if (p < bEnd) {
+        memcpy(state->mem64, p, (size_t)(bEnd-p));
+        state->memsize = (unsigned)(bEnd-p);
+    }
+}
+
+XXH_PUBLIC_API XXH64_hash_t XXH64_digest(const XXH64_state_t* state)
+{
+    U64 h64;
+
+    if (state->total_len >= 32) {
+        h64 = XXH_rotl64(state->v[0], 1) + XXH_rotl64(state->v[1], 7)
+            + XXH_rotl64(state->v[2], 12) + XXH_rotl64(state->v[3], 18);
+        h64 = XXH64_mergeRound(h64, state->v[0]);
+        h64 = XXH64_mergeRound(h64, state->v[1]);
+        h64 = XXH64_mergeRound(h64, state->v[2]);
+        h64 = XXH64_mergeRound(h64, state->v[3]);
+    } else {
+        h64  = state->v[2] /*seed*/ + XXH_PRIME64_5;
+    }
+
+    h64 += (U64) state->total_len;
+
+    return XXH64_finalize(h64, (const BYTE*)state->mem64, state->memsize);
+}
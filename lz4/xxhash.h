@@ -0,0 +1,135 @@
+/*
+ *  xxHash - Extremely Fast Hash algorithm
+ *  Header File
+
+   BSD 2-Clause License (http://www.opensource.org/licenses/bsd-license.php)
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions are
+   met:
+
+       * Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+       * Redistributions in binary form must reproduce the above
+   copyright notice, this list of conditions and the following disclaimer
+   in the documentation and/or other materials provided with the
+   distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef XXHASH_H_5627135585666179
+#define XXHASH_H_5627135585666179
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/**
+  Introduction
+
+  xxHash is a non-cryptographic hash algorithm, working at speeds close to RAM limits.
+  XXH32 is the checksum used by the LZ4 frame format (header, block and content checksums).
+  XXH64 is faster on 64-bit platforms, and is available for application-level integrity checks.
+  Results are identical on all platforms, whatever their endianness or alignment rules.
+*/
+
+/*-************************************
+*  Dependencies
+**************************************/
+#include <stddef.h>   /* size_t */
+
+#if defined(__cplusplus) || (defined (__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L) /* C99 */)
+#  include <stdint.h>
+   typedef uint32_t XXH32_hash_t;
+   typedef uint64_t XXH64_hash_t;
+#else
+#  include <limits.h>
+#  if UINT_MAX == 0xFFFFFFFFUL
+     typedef unsigned int  XXH32_hash_t;
+#  else
+     typedef unsigned long XXH32_hash_t;
+#  endif
+   typedef unsigned long long XXH64_hash_t;
+#endif
+
+#ifndef XXH_PUBLIC_API
+#  define XXH_PUBLIC_API   /* do nothing */
+#endif
+
+
+/*-************************************
+*  Simple Hash Function
+**************************************/
+/*! XXH32() :
+ *  Calculates the 32-bit hash of the `length` bytes starting at `input`.
+ *  `input` can be NULL when `length == 0`.
+ */
+XXH_PUBLIC_API XXH32_hash_t XXH32 (const void* input, size_t length, XXH32_hash_t seed);
+
+/*! XXH64() :
+ *  Calculates the 64-bit hash of the `length` bytes starting at `input`.
+ *  Faster than XXH32() on 64-bit platforms.
+ */
+XXH_PUBLIC_API XXH64_hash_t XXH64 (const void* input, size_t length, XXH64_hash_t seed);
+
+/*! XXH_vectorName() :
+ *  Name of the stripe loop used by XXH64() ("scalar", "sse2", "avx2" or "neon"),
+ *  selected at compile time (see XXH_VECTOR in xxhash.c). */
+XXH_PUBLIC_API const char* XXH_vectorName(void);
+
+
+/*-************************************
+*  Streaming Hash Functions
+**************************************/
+/*! XXH32_state_t :
+ *  Allows hashing an input delivered in several segments.
+ *  Sequence : XXH32_reset(), then XXH32_update() any number of times, then XXH32_digest().
+ *  XXH32_digest() doesn't modify the state, so it can be invoked at any point,
+ *  the result being the hash of all data provided so far.
+ *  The state can be allocated statically (on stack or within another structure).
+ *  Its members must be considered private.
+ */
+typedef struct XXH32_state_s {
+   XXH32_hash_t total_len_32;
+   XXH32_hash_t large_len;
+   XXH32_hash_t v[4];
+   XXH32_hash_t mem32[4];
+   XXH32_hash_t memsize;
+   XXH32_hash_t reserved;   /* never read nor write, might be removed in a future version */
+} XXH32_state_t;
+
+XXH_PUBLIC_API void XXH32_reset  (XXH32_state_t* statePtr, XXH32_hash_t seed);
+XXH_PUBLIC_API void XXH32_update (XXH32_state_t* statePtr, const void* input, size_t length);
+XXH_PUBLIC_API XXH32_hash_t XXH32_digest (const XXH32_state_t* statePtr);
+
+/*! XXH64_state_t :
+ *  Same usage as XXH32_state_t. */
+typedef struct XXH64_state_s {
+   XXH64_hash_t total_len;
+   XXH64_hash_t v[4];
+   XXH64_hash_t mem64[4];
+   XXH32_hash_t memsize;
+   XXH32_hash_t reserved32;   /* never read nor write, might be removed in a future version */
+   XXH64_hash_t reserved64;   /* idem */
+} XXH64_state_t;
+
+XXH_PUBLIC_API void XXH64_reset  (XXH64_state_t* statePtr, XXH64_hash_t seed);
+XXH_PUBLIC_API void XXH64_update (XXH64_state_t* statePtr, const void* input, size_t length);
+XXH_PUBLIC_API XXH64_hash_t XXH64_digest (const XXH64_state_t* statePtr);
+
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* XXHASH_H_5627135585666179 */
@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "xxhash.h"
+#include "random_data.h"  // Contains 1MB data array as in previous example
+
+#define BENCH_NB_ROUNDS 2000   // 2 GB hashed per function
+
+static unsigned char copy_buffer[RANDOM_DATA_SIZE];
+static volatile unsigned long long bench_sink;   // keeps results alive
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double bandwidth(double seconds) {
+    return ((double)RANDOM_DATA_SIZE * BENCH_NB_ROUNDS) / seconds / (1 << 20);
+}
+
+static double bench_memcpy(void) {
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_NB_ROUNDS; i++) {
+        memcpy(copy_buffer, random_data, RANDOM_DATA_SIZE);
+        bench_sink += copy_buffer[i % RANDOM_DATA_SIZE];
+    }
+    return bandwidth(now_seconds() - start);
+}
+
+static double bench_xxh32(void) {
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_NB_ROUNDS; i++)
+        bench_sink += XXH32(random_data, RANDOM_DATA_SIZE, (XXH32_hash_t)i);
+    return bandwidth(now_seconds() - start);
+}
+
+static double bench_xxh64(void) {
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_NB_ROUNDS; i++)
+        bench_sink += XXH64(random_data, RANDOM_DATA_SIZE, (XXH64_hash_t)i);
+    return bandwidth(now_seconds() - start);
+}
+
+int main(void) {
+    double copy_speed;
+
+    printf("Hashing %d bytes x %d rounds\n", RANDOM_DATA_SIZE, BENCH_NB_ROUNDS);
+    copy_speed = bench_memcpy();
+    printf("memcpy          : %8.1f MB/s\n", copy_speed);
+    {
+        double speed = bench_xxh32();
+        printf("XXH32           : %8.1f MB/s (%.2fx memcpy)\n", speed, speed / copy_speed);
+        speed = bench_xxh64();
+        printf("XXH64 %-10s: %8.1f MB/s (%.2fx memcpy)\n", XXH_vectorName(), speed, speed / copy_speed);
+    }
+    return 0;
+}
@@ -164,22 +164,12 @@ in main compilers:
   realloc(NULL,     0)  : returns non_NULL
   realloc(non_NULL, 0)  : returns NULL
 */
-// =========================================
-// Configurable memory pool size
-// =========================================
-#define POOL_SIZE (16*1024 * 1024) // 16 MB
-
-// Static memory pool and stack pointer
-static uint8_t memory_pool[POOL_SIZE];
-static size_t pool_top = 0;
-
-static inline size_t align8(size_t size) {
-    return (size + 7) & ~7;
-}
 
 void *MyAlloc(size_t size)
 {
-#if 0
+  if (size == 0)
+    return NULL;
+  // PRINT_ALLOC("Alloc    ", g_allocCount, size, NULL)
   #ifdef SZ_ALLOC_DEBUG
   {
     void *p = malloc(size);
@@ -192,42 +182,17 @@ void *MyAlloc(size_t size)
   #else
   return malloc(size);
   #endif
-#else
-    size = align8(size);
-    if (pool_top + size + sizeof(size_t) > POOL_SIZE) {
-        return NULL; // Out of memory
-    }
-    size_t *header = (size_t *)&memory_pool[pool_top];
-    *header = size;
-    void *ptr = (void *)(header + 1);
-    pool_top += size + sizeof(size_t);
-    return ptr;
-
-
-#endif
 }
 
-void MyFree(void *ptr)
+void MyFree(void *address)
 {
-#if 0
-  return;
   PRINT_FREE("Free    ", g_allocCount, address)
   
   free(address);
-#else
-    if (!ptr) return;
-    size_t *header = (size_t *)ptr - 1;
-    size_t size = *header;
-    // Check if it's the top allocation
-    if ((uint8_t *)ptr + size == &memory_pool[pool_top]) {
-        pool_top -= size + sizeof(size_t);
-    }
-#endif
 }
 
-void *MyRealloc(void *ptr, size_t new_size)
+void *MyRealloc(void *address, size_t size)
 {
-#if 0 
   if (size == 0)
   {
     MyFree(address);
@@ -246,47 +211,8 @@ void *MyRealloc(void *ptr, size_t new_size)
   #else
   return realloc(address, size);
   #endif
-#else
-    if (!ptr) return MyAlloc(new_size);
-    size_t *header = (size_t *)ptr - 1;
-    size_t old_size = *header;
-    new_size = align8(new_size);
-
-    // If ptr is last allocation in pool, adjust in place
-    if ((uint8_t *)ptr + old_size == &memory_pool[pool_top]) {
-        size_t diff = (new_size > old_size) ? (new_size - old_size) : 0;
-        if (pool_top + diff <= POOL_SIZE) {
-            pool_top += diff;
-            *header = new_size;
-            return ptr;
-        }
-    }
-
-    // Otherwise allocate new block
-    void *new_ptr = MyAlloc(new_size);
-    if (!new_ptr) return NULL;
-    memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
-    return new_ptr;
-#endif
-}
-
-// =========================================
-// Reset pool (like heap reset)
-// =========================================
-void my_reset_pool(void) {
-    pool_top = 0;
-}
-
-// =========================================
-// Debug helper
-// =========================================
-size_t my_used_memory(void) {
-    return pool_top;
 }
 
-size_t my_free_memory(void) {
-    return POOL_SIZE - pool_top;
-}
 
 #ifdef _WIN32
 
@@ -676,3 +602,94 @@ void AlignOffsetAlloc_CreateVTable(CAlignOffsetAlloc *p)
   p->vt.Alloc = AlignOffsetAlloc_Alloc;
   p->vt.Free = AlignOffsetAlloc_Free;
 }
+
+
+#define ARENA_ALIGN  ArenaAlloc_BLOCK_ALIGN
+
+/* each block is preceded by a header of ARENA_ALIGN bytes.
+   Two last words of the header are (pos) before and after allocation of block */
+#define ARENA_HEADER(address)  ((size_t *)(void *)(address) - 2)
+
+static void *ArenaAlloc_Alloc(ISzAllocPtr pp, size_t size)
+{
+  CArenaAlloc *p = Z7_CONTAINER_FROM_VTBL(pp, CArenaAlloc, vt);
+  const size_t size2 = (size + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+  if (size == 0)
+    return NULL;
+  if (size2 >= size
+      && p->size - p->pos >= size2
+      && p->size - p->pos - size2 >= ARENA_ALIGN)
+  {
+    Byte *address = p->buf + p->pos + ARENA_ALIGN;
+    size_t *header = ARENA_HEADER(address);
+    header[0] = p->pos;
+    p->pos += ARENA_ALIGN + size2;
+    header[1] = p->pos;
+    p->numBlocks++;
+    return address;
+  }
+  /* the arena is full */
+  return ISzAlloc_Alloc(p->baseAlloc, size);
+}
+
+
+static void ArenaAlloc_FreeBlock(ISzAllocPtr pp, void *address)
+{
+  CArenaAlloc *p = Z7_CONTAINER_FROM_VTBL(pp, CArenaAlloc, vt);
+  if (!address)
+    return;
+  if (p->buf && (Byte *)address > p->buf && (Byte *)address < p->buf + p->size)
+  {
+    const size_t *header = ARENA_HEADER(address);
+    /* the memory of last block is reused immediately,
+       and the memory of another blocks is reused, when all blocks are freed */
+    if (header[1] == p->pos)
+      p->pos = header[0];
+    if (--p->numBlocks == 0)
+      p->pos = 0;
+    return;
+  }
+  ISzAlloc_Free(p->baseAlloc, address);
+}
+
+
+void ArenaAlloc_Construct(CArenaAlloc *p, ISzAllocPtr baseAlloc)
+{
+  p->vt.Alloc = ArenaAlloc_Alloc;
+  p->vt.Free = ArenaAlloc_FreeBlock;
+  p->baseAlloc = baseAlloc;
+  p->bufBase = NULL;
+  p->buf = NULL;
+  p->size = 0;
+  p->pos = 0;
+  p->numBlocks = 0;
+}
+
+
+SRes ArenaAlloc_Create(CArenaAlloc *p, size_t size)
+{
+  if (p->buf && p->size >= size)
+    return SZ_OK;
+  if (p->numBlocks != 0)
+    return SZ_ERROR_FAIL;
+  ArenaAlloc_Free(p);
+  if (size + ARENA_ALIGN < size)
+    return SZ_ERROR_MEM;
+  p->bufBase = ISzAlloc_Alloc(p->baseAlloc, size + ARENA_ALIGN);
+  if (!p->bufBase)
+    return SZ_ERROR_MEM;
+  p->buf = (Byte *)p->bufBase + ((ARENA_ALIGN - ((size_t)p->bufBase & (ARENA_ALIGN - 1))) & (ARENA_ALIGN - 1));
+  p->size = size;
+  return SZ_OK;
+}
+
+
+void ArenaAlloc_Free(CArenaAlloc *p)
+{
+  ISzAlloc_Free(p->baseAlloc, p->bufBase);
+  p->bufBase = NULL;
+  p->buf = NULL;
+  p->size = 0;
+  p->pos = 0;
+  p->numBlocks = 0;
+}
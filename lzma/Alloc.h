@@ -71,6 +71,38 @@ typedef struct
 void AlignOffsetAlloc_CreateVTable(CAlignOffsetAlloc *p);
 
 
+/*
+  CArenaAlloc allocates the blocks sequentially from one buffer (arena)
+  that is owned by one encoder or decoder context.
+  The memory of last allocated block is reused immediately after MyFree(),
+  and whole arena is reused, when all blocks are freed. So the arena can be
+  used for next calls without any reset.
+  If the arena is full, the blocks are allocated from (baseAlloc).
+  CArenaAlloc is not thread-safe: each thread must use its own arena.
+*/
+
+#define ArenaAlloc_BLOCK_ALIGN  64
+/* the size of arena for (numBlocks) blocks with total size (dataSize) */
+#define ArenaAlloc_GET_SIZE(dataSize, numBlocks)  ((dataSize) + (size_t)(numBlocks) * (ArenaAlloc_BLOCK_ALIGN * 2))
+
+typedef struct
+{
+  ISzAlloc vt;
+  ISzAllocPtr baseAlloc;
+  void *bufBase;
+  Byte *buf;          /* aligned for ArenaAlloc_BLOCK_ALIGN */
+  size_t size;
+  size_t pos;
+  size_t numBlocks;   /* the number of allocated blocks in arena */
+} CArenaAlloc;
+
+void ArenaAlloc_Construct(CArenaAlloc *p, ISzAllocPtr baseAlloc);
+/* ArenaAlloc_Create() reuses the current arena, if it's not smaller than (size).
+   It returns SZ_ERROR_FAIL, if the arena must be reallocated, but some blocks are not freed */
+SRes ArenaAlloc_Create(CArenaAlloc *p, size_t size);
+void ArenaAlloc_Free(CArenaAlloc *p);
+
+
 EXTERN_C_END
 
 #endif
@@ -318,7 +318,7 @@ static UInt32 GetBlockSize(CMatchFinder *p, UInt32 historySize)
 
 
 // input is historySize
-static UInt32 MatchFinder_GetHashMask2(CMatchFinder *p, UInt32 hs)
+static UInt32 MatchFinder_GetHashMask2(const CMatchFinder *p, UInt32 hs)
 {
   if (p->numHashBytes == 2)
     return (1 << 16) - 1;
@@ -344,7 +344,7 @@ static UInt32 MatchFinder_GetHashMask2(CMatchFinder *p, UInt32 hs)
 }
 
 // input is historySize
-static UInt32 MatchFinder_GetHashMask(CMatchFinder *p, UInt32 hs)
+static UInt32 MatchFinder_GetHashMask(const CMatchFinder *p, UInt32 hs)
 {
   if (p->numHashBytes == 2)
     return (1 << 16) - 1;
@@ -373,9 +373,8 @@ static UInt32 MatchFinder_GetHashMask(CMatchFinder *p, UInt32 hs)
 }
 
 
-int MatchFinder_Create(CMatchFinder *p, UInt32 historySize,
-    UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter,
-    ISzAllocPtr alloc)
+static void MatchFinder_SetKeepSizes(CMatchFinder *p, UInt32 historySize,
+    UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter)
 {
   /* we need one additional byte in (p->keepSizeBefore),
      since we use MoveBlock() after (p->pos++) and before dictionary using */
@@ -388,94 +387,126 @@ int MatchFinder_Create(CMatchFinder *p, UInt32 historySize,
     keepAddBufferAfter = p->numHashBytes;
   // keepAddBufferAfter -= 2; // for debug
   p->keepSizeAfter = keepAddBufferAfter;
+}
 
-  if (p->directInput)
-    p->blockSize = 0;
-  if (p->directInput || LzInWindow_Create2(p, GetBlockSize(p, historySize), alloc))
+
+/* it returns the number of hash items (hashSizeSum), or 0 for overflow */
+
+static size_t MatchFinder_GetHashSize(const CMatchFinder *p, UInt32 historySize,
+    UInt32 *hashMask, UInt32 *fixedHashSizeRes)
+{
+  size_t hashSizeSum;
+  UInt32 hs;
+  UInt32 hsCur;
+      
+  if (p->numHashOutBits != 0)
   {
-    size_t hashSizeSum;
+    unsigned numBits = p->numHashOutBits;
+    const unsigned nbMax =
+        (p->numHashBytes == 2 ? 16 :
+        (p->numHashBytes == 3 ? 24 : 32));
+    if (numBits >= nbMax)
+      numBits = nbMax;
+    if (numBits >= 32)
+      hs = (UInt32)0 - 1;
+    else
+      hs = ((UInt32)1 << numBits) - 1;
+    // (hash_size >= (1 << 16)) : Required for (numHashBytes > 2)
+    hs |= (1 << 16) - 1; /* don't change it! */
+    if (p->numHashBytes >= 5)
+      hs |= (256 << kLzHash_CrcShift_2) - 1;
     {
-      UInt32 hs;
-      UInt32 hsCur;
-      
-      if (p->numHashOutBits != 0)
-      {
-        unsigned numBits = p->numHashOutBits;
-        const unsigned nbMax =
-            (p->numHashBytes == 2 ? 16 :
-            (p->numHashBytes == 3 ? 24 : 32));
-        if (numBits >= nbMax)
-          numBits = nbMax;
-        if (numBits >= 32)
-          hs = (UInt32)0 - 1;
-        else
-          hs = ((UInt32)1 << numBits) - 1;
-        // (hash_size >= (1 << 16)) : Required for (numHashBytes > 2)
-        hs |= (1 << 16) - 1; /* don't change it! */
-        if (p->numHashBytes >= 5)
-          hs |= (256 << kLzHash_CrcShift_2) - 1;
-        {
-          const UInt32 hs2 = MatchFinder_GetHashMask2(p, historySize);
-          if (hs >= hs2)
-            hs = hs2;
-        }
-        hsCur = hs;
-        if (p->expectedDataSize < historySize)
-        {
-          const UInt32 hs2 = MatchFinder_GetHashMask2(p, (UInt32)p->expectedDataSize);
-          if (hsCur >= hs2)
-            hsCur = hs2;
-        }
-      }
-      else
-      {
-        hs = MatchFinder_GetHashMask(p, historySize);
+      const UInt32 hs2 = MatchFinder_GetHashMask2(p, historySize);
+      if (hs >= hs2)
+        hs = hs2;
+    }
+    hsCur = hs;
+    if (p->expectedDataSize < historySize)
+    {
+      const UInt32 hs2 = MatchFinder_GetHashMask2(p, (UInt32)p->expectedDataSize);
+      if (hsCur >= hs2)
+        hsCur = hs2;
+    }
+  }
+  else
+  {
+    hs = MatchFinder_GetHashMask(p, historySize);
+    hsCur = hs;
+    if (p->expectedDataSize < historySize)
+    {
+      hsCur = MatchFinder_GetHashMask(p, (UInt32)p->expectedDataSize);
+      if (hsCur >= hs) // is it possible?
         hsCur = hs;
-        if (p->expectedDataSize < historySize)
-        {
-          hsCur = MatchFinder_GetHashMask(p, (UInt32)p->expectedDataSize);
-          if (hsCur >= hs) // is it possible?
-            hsCur = hs;
-        }
-      }
+    }
+  }
 
-      p->hashMask = hsCur;
+  *hashMask = hsCur;
 
-      hashSizeSum = hs;
-      hashSizeSum++;
-      if (hashSizeSum < hs)
-        return 0;
-      {
-        UInt32 fixedHashSize = 0;
-        if (p->numHashBytes > 2 && p->numHashBytes_Min <= 2) fixedHashSize += kHash2Size;
-        if (p->numHashBytes > 3 && p->numHashBytes_Min <= 3) fixedHashSize += kHash3Size;
-        // if (p->numHashBytes > 4) p->fixedHashSize += hs4; // kHash4Size;
-        hashSizeSum += fixedHashSize;
-        p->fixedHashSize = fixedHashSize;
-      }
-    }
+  hashSizeSum = hs;
+  hashSizeSum++;
+  if (hashSizeSum < hs)
+    return 0;
+  {
+    UInt32 fixedHashSize = 0;
+    if (p->numHashBytes > 2 && p->numHashBytes_Min <= 2) fixedHashSize += kHash2Size;
+    if (p->numHashBytes > 3 && p->numHashBytes_Min <= 3) fixedHashSize += kHash3Size;
+    // if (p->numHashBytes > 4) p->fixedHashSize += hs4; // kHash4Size;
+    hashSizeSum += fixedHashSize;
+    *fixedHashSizeRes = fixedHashSize;
+  }
+  return hashSizeSum;
+}
+
+
+/* it returns the number of refs in (hash) and (son) arrays, or 0 for overflow */
+
+static size_t MatchFinder_GetNumRefs(const CMatchFinder *p, size_t hashSizeSum, UInt32 historySize)
+{
+  size_t newSize;
+  size_t numSons;
+  const UInt32 newCyclicBufferSize = historySize + 1; // do not change it
+  numSons = newCyclicBufferSize;
+  if (p->btMode)
+    numSons <<= 1;
+  newSize = hashSizeSum + numSons;
+
+  if (numSons < newCyclicBufferSize || newSize < numSons)
+    return 0;
+
+  // aligned size is not required here, but it can be better for some loops
+  #define NUM_REFS_ALIGN_MASK 0xF
+  return (newSize + NUM_REFS_ALIGN_MASK) & ~(size_t)NUM_REFS_ALIGN_MASK;
+}
+
+
+int MatchFinder_Create(CMatchFinder *p, UInt32 historySize,
+    UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter,
+    ISzAllocPtr alloc)
+{
+  MatchFinder_SetKeepSizes(p, historySize, keepAddBufferBefore, matchMaxLen, keepAddBufferAfter);
+
+  if (p->directInput)
+    p->blockSize = 0;
+  if (p->directInput || LzInWindow_Create2(p, GetBlockSize(p, historySize), alloc))
+  {
+    size_t hashSizeSum;
+    UInt32 fixedHashSize = 0;
+    hashSizeSum = MatchFinder_GetHashSize(p, historySize, &p->hashMask, &fixedHashSize);
+    if (hashSizeSum == 0)
+      return 0;
+    p->fixedHashSize = fixedHashSize;
 
     p->matchMaxLen = matchMaxLen;
 
     {
       size_t newSize;
-      size_t numSons;
-      const UInt32 newCyclicBufferSize = historySize + 1; // do not change it
       p->historySize = historySize;
-      p->cyclicBufferSize = newCyclicBufferSize; // it must be = (historySize + 1)
+      p->cyclicBufferSize = historySize + 1; // it must be = (historySize + 1)
       
-      numSons = newCyclicBufferSize;
-      if (p->btMode)
-        numSons <<= 1;
-      newSize = hashSizeSum + numSons;
-
-      if (numSons < newCyclicBufferSize || newSize < numSons)
+      newSize = MatchFinder_GetNumRefs(p, hashSizeSum, historySize);
+      if (newSize == 0)
         return 0;
 
-      // aligned size is not required here, but it can be better for some loops
-      #define NUM_REFS_ALIGN_MASK 0xF
-      newSize = (newSize + NUM_REFS_ALIGN_MASK) & ~(size_t)NUM_REFS_ALIGN_MASK;
-
       // 22.02: we don't reallocate buffer, if old size is enough
       if (p->hash && p->numRefs >= newSize)
         return 1;
@@ -497,6 +528,30 @@ int MatchFinder_Create(CMatchFinder *p, UInt32 historySize,
 }
 
 
+UInt64 MatchFinder_GetMemUsage(const CMatchFinder *p, UInt32 historySize,
+    UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter)
+{
+  UInt64 size = 0;
+  size_t hashSizeSum, numRefs;
+  UInt32 hashMask, fixedHashSize = 0;
+  if (!p->directInput)
+  {
+    CMatchFinder mf = *p;
+    MatchFinder_SetKeepSizes(&mf, historySize, keepAddBufferBefore, matchMaxLen, keepAddBufferAfter);
+    size = GetBlockSize(&mf, historySize);
+    if (size == 0)
+      return 0;
+  }
+  hashSizeSum = MatchFinder_GetHashSize(p, historySize, &hashMask, &fixedHashSize);
+  if (hashSizeSum == 0)
+    return 0;
+  numRefs = MatchFinder_GetNumRefs(p, hashSizeSum, historySize);
+  if (numRefs == 0)
+    return 0;
+  return size + (UInt64)numRefs * sizeof(CLzRef);
+}
+
+
 static void MatchFinder_SetLimits(CMatchFinder *p)
 {
   UInt32 k;
@@ -100,6 +100,10 @@ int MatchFinder_Create(CMatchFinder *p, UInt32 historySize,
     UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter,
     ISzAllocPtr alloc);
 void MatchFinder_Free(CMatchFinder *p, ISzAllocPtr alloc);
+/* MatchFinder_GetMemUsage() returns the size of memory that MatchFinder_Create()
+   allocates for same parameters and settings of (p), or 0 for unsupported parameters */
+UInt64 MatchFinder_GetMemUsage(const CMatchFinder *p, UInt32 historySize,
+    UInt32 keepAddBufferBefore, UInt32 matchMaxLen, UInt32 keepAddBufferAfter);
 void MatchFinder_Normalize3(UInt32 subValue, CLzRef *items, size_t numItems);
 
 /*
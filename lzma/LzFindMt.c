@@ -0,0 +1,850 @@
+/* LzFindMt.c -- multithreaded Match finder for LZ algorithms
+2026-10-16 : Public domain */
+
+#include "Precomp.h"
+
+// #include <stdio.h>
+
+#include "CpuArch.h"
+
+#include "LzHash.h"
+#include "LzFindMt.h"
+
+/*
+  The pipeline has 3 threads:
+
+  HASH thread : reads the input stream, moves the data window,
+                and writes the heads of the main hash table to hash blocks.
+                A head is stored as (pos - hashValue) : the distance to the previous
+                position with the same hash, or (pos) for empty hash record.
+  BT thread   : updates the binary tree (son) for each head
+                and writes the lists of tree matches to bt blocks.
+  LZ thread   : the caller's thread. It reads bt blocks, mixes in
+                the 2-byte and 3-byte hash matches, and passes the result to encoder.
+
+  Each thread owns its own part of the hash table and its own copy of (pos):
+    HASH : main hash     (hash + fixedHashSize)
+    BT   : son
+    LZ   : hash2, hash3  (hash[0 ... fixedHashSize - 1])
+  The positions of all threads are equal for same byte of data.
+  The HASH thread normalizes its positions at the start of hash block,
+  and passes (subValue) in block header. The BT thread applies it to (son),
+  and passes it to the LZ thread at the start of next bt block.
+
+  hash block : header of (kMtHashBlockHeader) items and heads:
+    [0] numHeads
+    [1] number of available bytes at first position of block
+    [2] first position of block (after normalization)
+    [3] subValue for normalization before this block, or 0
+    [4] (1) if there is no data after the positions of this block
+        except of (numHashBytes - 1) bytes tail that has no heads.
+
+  bt block : header of (kMtBtBlockHeader) items and records for each position:
+    [0] size of block, including header
+    [1] number of available bytes at first position of block
+    [2] subValue for normalization before first position, or 0
+    record : (num) followed by (num / 2) pairs {len, dist - 1} of increasing (len).
+*/
+
+#define kMtHashBlockSize    ((UInt32)1 << 17)
+#define kMtHashNumBlocks    (1 << 1)
+
+#define GET_HASH_BLOCK_OFFSET(i)  (((i) & (kMtHashNumBlocks - 1)) * kMtHashBlockSize)
+
+#define kMtBtBlockSize      ((UInt32)1 << 16)
+#define kMtBtNumBlocks      (1 << 4)
+
+#define GET_BT_BLOCK_OFFSET(i)  (((i) & (kMtBtNumBlocks - 1)) * (size_t)kMtBtBlockSize)
+
+#define kHashBufferSize (kMtHashBlockSize * kMtHashNumBlocks)
+#define kBtBufferSize   (kMtBtBlockSize * kMtBtNumBlocks)
+
+#define kMtHashBlockHeader  5
+#define kMtBtBlockHeader    3
+
+#define kMtMaxValForNormalize ((UInt32)0xFFFFFFFF)
+// #define kMtMaxValForNormalize ((UInt32)1 << 18) // for debug
+
+#define MF(mt) ((mt)->MatchFinder)
+
+#define kEmptyHashValue 0
+
+
+/* ---------- CMtSync ---------- */
+
+static void MtSync_Construct(CMtSync *p)
+{
+  p->affinity = 0;
+  p->affinityGroup = -1;
+  p->affinityInGroup = 0;
+  p->wasCreated = False;
+  p->needStart = True;
+  p->csWasInitialized = False;
+  p->csWasEntered = False;
+  p->exit = False;
+  p->stopWriting = False;
+  p->numProcessedBlocks = 0;
+  Thread_CONSTRUCT(&p->thread)
+  Event_Construct(&p->canStart);
+  Event_Construct(&p->wasStopped);
+  Semaphore_Construct(&p->freeSemaphore);
+  Semaphore_Construct(&p->filledSemaphore);
+}
+
+
+#define LOCK_BUFFER(p) { \
+    CriticalSection_Enter(&(p)->cs); \
+    (p)->csWasEntered = True; }
+
+#define UNLOCK_BUFFER(p) { \
+    if ((p)->csWasEntered) { \
+      (p)->csWasEntered = False; \
+      CriticalSection_Leave(&(p)->cs); }}
+
+
+/* MtSync_GetNextBlock() is called by the consumer thread.
+   It releases the current block and waits for the next filled block.
+   It returns the global index of the new block. */
+
+static UInt32 MtSync_GetNextBlock(CMtSync *p)
+{
+  UInt32 numBlocks = 0;
+  if (p->needStart)
+  {
+    p->numProcessedBlocks = 1;
+    p->needStart = False;
+    p->stopWriting = False;
+    p->exit = False;
+    Event_Reset(&p->wasStopped);
+    Event_Set(&p->canStart);
+  }
+  else
+  {
+    UNLOCK_BUFFER(p)
+    numBlocks = p->numProcessedBlocks++;
+    Semaphore_Release1(&p->freeSemaphore);
+  }
+
+  Semaphore_Wait(&p->filledSemaphore);
+  LOCK_BUFFER(p)
+  return numBlocks;
+}
+
+
+/* MtSync_StopWriting() is called by the consumer thread.
+   The consumer always owns one block here, so (freeSemaphore) can't overflow. */
+
+static void MtSync_StopWriting(CMtSync *p)
+{
+  if (!Thread_WasCreated(&p->thread) || p->needStart)
+    return;
+
+  UNLOCK_BUFFER(p)
+
+  p->stopWriting = True;
+  Semaphore_Release1(&p->freeSemaphore);
+  Event_Wait(&p->wasStopped);
+  p->needStart = True;
+}
+
+
+static void MtSync_Destruct(CMtSync *p)
+{
+  if (Thread_WasCreated(&p->thread))
+  {
+    MtSync_StopWriting(p);
+    p->exit = True;
+    Event_Set(&p->canStart);
+    Thread_Wait_Close(&p->thread);
+  }
+  if (p->csWasInitialized)
+  {
+    CriticalSection_Delete(&p->cs);
+    p->csWasInitialized = False;
+  }
+  p->csWasEntered = False;
+
+  Event_Close(&p->canStart);
+  Event_Close(&p->wasStopped);
+  Semaphore_Close(&p->freeSemaphore);
+  Semaphore_Close(&p->filledSemaphore);
+
+  p->wasCreated = False;
+}
+
+
+static WRes MtSync_Create_WRes(CMtSync *p, THREAD_FUNC_TYPE startAddress, CMatchFinderMt *obj)
+{
+  if (p->wasCreated)
+    return 0;
+
+  RINOK_WRes(CriticalSection_Init(&p->cs))
+  p->csWasInitialized = True;
+  p->csWasEntered = False;
+
+  RINOK_WRes(AutoResetEvent_CreateNotSignaled(&p->canStart))
+  RINOK_WRes(AutoResetEvent_CreateNotSignaled(&p->wasStopped))
+
+  p->needStart = True;
+  p->exit = True;  /* p->exit is unused before (canStart) Event */
+
+  RINOK_WRes(Thread_Create_With_Affinity(&p->thread, startAddress, obj, (CAffinityMask)p->affinity))
+
+  p->wasCreated = True;
+  return 0;
+}
+
+
+static SRes MtSync_Create(CMtSync *p, THREAD_FUNC_TYPE startAddress, CMatchFinderMt *obj)
+{
+  const WRes wres = MtSync_Create_WRes(p, startAddress, obj);
+  if (wres == 0)
+    return SZ_OK;
+  MtSync_Destruct(p);
+  return SZ_ERROR_THREAD;
+}
+
+
+/* MtSync_Init() is called when the producer thread doesn't work.
+   It's allowed to reinit the semaphores after previous stop. */
+
+static SRes MtSync_Init(CMtSync *p, UInt32 numBlocks)
+{
+  WRes wres;
+  p->needStart = True;
+  p->numProcessedBlocks = 0;
+  wres = Semaphore_OptCreateInit(&p->freeSemaphore, numBlocks, numBlocks);
+  if (wres == 0)
+    wres = Semaphore_OptCreateInit(&p->filledSemaphore, 0, numBlocks);
+  return (wres == 0 ? SZ_OK : SZ_ERROR_THREAD);
+}
+
+
+
+/* ---------- HASH thread ---------- */
+
+static void GetHeads2(const Byte *p, UInt32 pos,
+    UInt32 *hash, UInt32 hashMask, UInt32 *heads, UInt32 numHeads, const UInt32 *crc)
+{
+  UNUSED_VAR(hashMask)
+  UNUSED_VAR(crc)
+  for (; numHeads != 0; numHeads--)
+  {
+    const UInt32 value = GetUi16(p);
+    p++;
+    *heads++ = pos - hash[value];
+    hash[value] = pos++;
+  }
+}
+
+static void GetHeads3(const Byte *p, UInt32 pos,
+    UInt32 *hash, UInt32 hashMask, UInt32 *heads, UInt32 numHeads, const UInt32 *crc)
+{
+  for (; numHeads != 0; numHeads--)
+  {
+    const UInt32 value = (crc[p[0]] ^ p[1] ^ ((UInt32)p[2] << 8)) & hashMask;
+    p++;
+    *heads++ = pos - hash[value];
+    hash[value] = pos++;
+  }
+}
+
+static void GetHeads4(const Byte *p, UInt32 pos,
+    UInt32 *hash, UInt32 hashMask, UInt32 *heads, UInt32 numHeads, const UInt32 *crc)
+{
+  for (; numHeads != 0; numHeads--)
+  {
+    const UInt32 value = (crc[p[0]] ^ p[1] ^ ((UInt32)p[2] << 8)
+        ^ (crc[p[3]] << kLzHash_CrcShift_1)) & hashMask;
+    p++;
+    *heads++ = pos - hash[value];
+    hash[value] = pos++;
+  }
+}
+
+static void GetHeads5(const Byte *p, UInt32 pos,
+    UInt32 *hash, UInt32 hashMask, UInt32 *heads, UInt32 numHeads, const UInt32 *crc)
+{
+  for (; numHeads != 0; numHeads--)
+  {
+    const UInt32 value = (crc[p[0]] ^ p[1] ^ ((UInt32)p[2] << 8)
+        ^ (crc[p[3]] << kLzHash_CrcShift_1)
+        ^ (crc[p[4]] << kLzHash_CrcShift_2)) & hashMask;
+    p++;
+    *heads++ = pos - hash[value];
+    hash[value] = pos++;
+  }
+}
+
+
+static void HashFillBlock(CMatchFinderMt *mt, UInt32 *heads)
+{
+  CMatchFinder *mf = MF(mt);
+  UInt32 avail, num;
+  BoolInt isEnd;
+
+  if (MatchFinder_NeedMove(mf))
+  {
+    /* the BT and LZ threads use the data window only while they keep (cs) */
+    CriticalSection_Enter(&mt->btSync.cs);
+    CriticalSection_Enter(&mt->hashSync.cs);
+    {
+      const Byte *beforePtr = Inline_MatchFinder_GetPointerToCurrentPos(mf);
+      ptrdiff_t offset;
+      MatchFinder_MoveBlock(mf);
+      offset = beforePtr - Inline_MatchFinder_GetPointerToCurrentPos(mf);
+      mt->pointerToCurPos -= offset;
+      mt->buffer -= offset;
+    }
+    CriticalSection_Leave(&mt->hashSync.cs);
+    CriticalSection_Leave(&mt->btSync.cs);
+  }
+
+  MatchFinder_ReadIfRequired(mf);
+
+  avail = Inline_MatchFinder_GetNumAvailableBytes(mf);
+  isEnd = (mf->streamEndWasReached || mf->result != SZ_OK);
+
+  if (isEnd)
+    num = (avail >= mf->numHashBytes ? avail - mf->numHashBytes + 1 : 0);
+  else
+  {
+    /* we keep (keepSizeAfter) bytes after last head,
+       so the BT thread always has (matchMaxLen) bytes for each head */
+    num = (avail > mf->keepSizeAfter ? avail - mf->keepSizeAfter : 0);
+  }
+
+  if (num > kMtHashBlockSize - kMtHashBlockHeader)
+  {
+    num = kMtHashBlockSize - kMtHashBlockHeader;
+    isEnd = False;
+  }
+
+  heads[3] = 0;
+  if (num != 0 && mf->pos > kMtMaxValForNormalize - num)
+  {
+    const UInt32 subValue = (mf->pos - mf->historySize - 1);
+    MatchFinder_REDUCE_OFFSETS(mf, subValue)
+    MatchFinder_Normalize3(subValue, mf->hash + mf->fixedHashSize, (size_t)mf->hashMask + 1);
+    heads[3] = subValue;
+  }
+
+  heads[0] = num;
+  heads[1] = avail;
+  heads[2] = mf->pos;
+  heads[4] = (UInt32)isEnd;
+
+  if (num != 0)
+  {
+    mt->GetHeadsFunc(mf->buffer, mf->pos, mf->hash + mf->fixedHashSize,
+        mf->hashMask, heads + kMtHashBlockHeader, num, mf->crc);
+    mf->pos += num;
+    mf->buffer += num;
+  }
+}
+
+
+static void HashThreadFunc(CMatchFinderMt *mt)
+{
+  CMtSync *p = &mt->hashSync;
+  for (;;)
+  {
+    UInt32 blockIndex = 0;
+    Event_Wait(&p->canStart);
+    if (p->exit)
+      return;
+
+    MatchFinder_Init_HighHash(MF(mt));
+
+    for (;;)
+    {
+      Semaphore_Wait(&p->freeSemaphore);
+      if (p->stopWriting)
+        break;
+      HashFillBlock(mt, mt->hashBuf + GET_HASH_BLOCK_OFFSET(blockIndex++));
+      Semaphore_Release1(&p->filledSemaphore);
+    }
+
+    Event_Set(&p->wasStopped);
+  }
+}
+
+
+
+/* ---------- BT thread ---------- */
+
+static void BtGetNextHashBlock(CMatchFinderMt *p)
+{
+  const UInt32 *heads = p->hashBuf + GET_HASH_BLOCK_OFFSET(MtSync_GetNextBlock(&p->hashSync));
+  const UInt32 subValue = heads[3];
+  if (subValue != 0)
+  {
+    MatchFinder_Normalize3(subValue, p->son, (size_t)p->cyclicBufferSize * 2);
+    p->pos -= subValue;
+    p->btSubValue += subValue;
+  }
+  p->hashBufPos = heads + kMtHashBlockHeader;
+  p->hashBufPosLimit = p->hashBufPos + heads[0];
+  p->hashNumAvail = heads[1] - (p->pos - heads[2]);
+  p->hashBlockIsEnd = (BoolInt)heads[4];
+}
+
+
+#define BT_MOVE_POS(p) \
+  p->pos++; \
+  p->buffer++; \
+  p->hashNumAvail--; \
+  if (++p->cyclicBufferPos == p->cyclicBufferSize) \
+    p->cyclicBufferPos = 0;
+
+static void BtFillBlock(CMatchFinderMt *p, UInt32 globalBlockIndex)
+{
+  UInt32 * const block = p->btBuf + GET_BT_BLOCK_OFFSET(globalBlockIndex);
+  UInt32 * const start = block + kMtBtBlockHeader;
+  /* the largest record : (1 + (matchMaxLen - 1) * 2) items */
+  const UInt32 * const limit = block + kMtBtBlockSize - (size_t)p->matchMaxLen * 2;
+  UInt32 *d = start;
+  const UInt32 minLen = p->numHashBytes - 1;
+
+  block[2] = p->btSubValue;
+  p->btSubValue = 0;
+
+  while (d < limit)
+  {
+    if (d == start)
+      block[1] = p->hashNumAvail;
+
+    if (p->hashBufPos != p->hashBufPosLimit)
+    {
+      const UInt32 delta = *p->hashBufPos++;
+      UInt32 lenLimit = p->matchMaxLen;
+      UInt32 *d2;
+      if (lenLimit > p->hashNumAvail)
+        lenLimit = p->hashNumAvail;
+      d2 = GetMatchesSpec1(lenLimit, p->pos - delta, p->pos, p->buffer, p->son,
+          p->cyclicBufferPos, p->cyclicBufferSize, p->cutValue,
+          d + 1, minLen);
+      *d = (UInt32)(d2 - d - 1);
+      d = d2;
+      BT_MOVE_POS(p)
+    }
+    else if (p->hashBlockIsEnd)
+    {
+      /* the tail of stream : (hashNumAvail < numHashBytes) */
+      if (p->hashNumAvail == 0)
+        break;
+      *d++ = 0;
+      p->son[(size_t)p->cyclicBufferPos * 2] = kEmptyHashValue;
+      p->son[(size_t)p->cyclicBufferPos * 2 + 1] = kEmptyHashValue;
+      BT_MOVE_POS(p)
+    }
+    else
+    {
+      BtGetNextHashBlock(p);
+      if (p->btSubValue != 0)
+      {
+        /* the LZ thread normalizes its positions only at the start of bt block */
+        if (d != start)
+          break;
+        block[2] += p->btSubValue;
+        p->btSubValue = 0;
+      }
+    }
+  }
+
+  if (d == start)
+    block[1] = p->hashNumAvail;
+  block[0] = (UInt32)(d - block);
+}
+
+
+static void BtThreadFunc(CMatchFinderMt *mt)
+{
+  CMtSync *p = &mt->btSync;
+  for (;;)
+  {
+    UInt32 blockIndex = 0;
+    Event_Wait(&p->canStart);
+    if (p->exit)
+      return;
+
+    for (;;)
+    {
+      {
+        /* the HASH thread can move the data window, while we wait for free bt block */
+        const BoolInt wasEntered = mt->hashSync.csWasEntered;
+        UNLOCK_BUFFER(&mt->hashSync)
+        Semaphore_Wait(&p->freeSemaphore);
+        if (wasEntered)
+          LOCK_BUFFER(&mt->hashSync)
+      }
+      if (p->stopWriting)
+        break;
+      BtFillBlock(mt, blockIndex++);
+      Semaphore_Release1(&p->filledSemaphore);
+    }
+
+    // we stop HASH thread here
+    MtSync_StopWriting(&mt->hashSync);
+    Event_Set(&p->wasStopped);
+  }
+}
+
+
+static THREAD_FUNC_DECL HashThreadFunc2(void *p)
+{
+  HashThreadFunc((CMatchFinderMt *)p);
+  return THREAD_FUNC_RET_ZERO;
+}
+
+static THREAD_FUNC_DECL BtThreadFunc2(void *p)
+{
+  BtThreadFunc((CMatchFinderMt *)p);
+  return THREAD_FUNC_RET_ZERO;
+}
+
+
+
+/* ---------- CMatchFinderMt ---------- */
+
+void MatchFinderMt_Construct(CMatchFinderMt *p)
+{
+  p->hashBuf = NULL;
+  p->btBuf = NULL;
+  MtSync_Construct(&p->hashSync);
+  MtSync_Construct(&p->btSync);
+}
+
+static void MatchFinderMt_FreeMem(CMatchFinderMt *p, ISzAllocPtr alloc)
+{
+  ISzAlloc_Free(alloc, p->hashBuf);
+  p->hashBuf = NULL;
+  p->btBuf = NULL;
+}
+
+void MatchFinderMt_Destruct(CMatchFinderMt *p, ISzAllocPtr alloc)
+{
+  /* the BT thread stops the HASH thread */
+  MtSync_Destruct(&p->btSync);
+  MtSync_Destruct(&p->hashSync);
+  MatchFinderMt_FreeMem(p, alloc);
+}
+
+
+SRes MatchFinderMt_Create(CMatchFinderMt *p, UInt32 historySize, UInt32 keepAddBufferBefore,
+    UInt32 matchMaxLen, UInt32 keepAddBufferAfter, ISzAllocPtr alloc)
+{
+  CMatchFinder *mf = MF(p);
+  if (kMtBtBlockSize <= matchMaxLen * 4)
+    return SZ_ERROR_PARAM;
+  if (!p->hashBuf)
+  {
+    p->hashBuf = (UInt32 *)ISzAlloc_Alloc(alloc, ((size_t)kHashBufferSize + (size_t)kBtBufferSize) * sizeof(UInt32));
+    if (!p->hashBuf)
+      return SZ_ERROR_MEM;
+    p->btBuf = p->hashBuf + kHashBufferSize;
+  }
+  /* the LZ thread can be behind the HASH thread for all positions in hash and bt blocks */
+  keepAddBufferBefore += (kHashBufferSize + kBtBufferSize);
+  keepAddBufferAfter += kMtHashBlockSize;
+  if (!MatchFinder_Create(mf, historySize, keepAddBufferBefore, matchMaxLen, keepAddBufferAfter, alloc))
+    return SZ_ERROR_MEM;
+
+  RINOK(MtSync_Create(&p->hashSync, HashThreadFunc2, p))
+  RINOK(MtSync_Create(&p->btSync, BtThreadFunc2, p))
+  return SZ_OK;
+}
+
+
+UInt64 MatchFinderMt_GetMemUsage(const CMatchFinder *mf, UInt32 historySize, UInt32 keepAddBufferBefore,
+    UInt32 matchMaxLen, UInt32 keepAddBufferAfter)
+{
+  /* it must be synchronized with MatchFinderMt_Create() */
+  const UInt64 size = MatchFinder_GetMemUsage(mf, historySize,
+      keepAddBufferBefore + (kHashBufferSize + kBtBufferSize),
+      matchMaxLen, keepAddBufferAfter + kMtHashBlockSize);
+  if (size == 0 || kMtBtBlockSize <= matchMaxLen * 4)
+    return 0;
+  return size + ((UInt64)kHashBufferSize + kBtBufferSize) * sizeof(UInt32);
+}
+
+
+SRes MatchFinderMt_InitMt(CMatchFinderMt *p)
+{
+  /* the threads can still work, if previous stream was not released */
+  MtSync_StopWriting(&p->btSync);
+  RINOK(MtSync_Init(&p->hashSync, kMtHashNumBlocks))
+  return MtSync_Init(&p->btSync, kMtBtNumBlocks);
+}
+
+
+static void MatchFinderMt_Init(void *_p)
+{
+  CMatchFinderMt *p = (CMatchFinderMt *)_p;
+  CMatchFinder *mf = MF(p);
+
+  p->btBufPos =
+  p->btBufPosLimit = NULL;
+  p->hashBufPos =
+  p->hashBufPosLimit = NULL;
+  p->hashNumAvail = 0;
+  p->hashBlockIsEnd = False;
+  p->btSubValue = 0;
+
+  /* Init without data reading. We don't want to read data in this thread.
+     The HASH thread initializes the main hash table. */
+  MatchFinder_Init_4(mf);
+  MatchFinder_Init_LowHash(mf);
+
+  p->pointerToCurPos = Inline_MatchFinder_GetPointerToCurrentPos(mf);
+  p->btNumAvailBytes = 0;
+  p->failure_LZ_BT = False;
+  p->lzPos = 1;  /* (mf->pos) was initialized to 1 in MatchFinder_Init_4() */
+
+  p->hash = mf->hash;
+  p->fixedHashSize = mf->fixedHashSize;
+  p->numHashBytes = mf->numHashBytes;
+  p->crc = mf->crc;
+
+  p->son = mf->son;
+  p->matchMaxLen = mf->matchMaxLen;
+  p->pos = 1;
+  p->buffer = mf->buffer;
+  p->cyclicBufferPos = 1;
+  p->cyclicBufferSize = mf->cyclicBufferSize;
+  p->cutValue = mf->cutValue;
+}
+
+
+void MatchFinderMt_ReleaseStream(CMatchFinderMt *p)
+{
+  MtSync_StopWriting(&p->btSync);
+}
+
+
+
+/* ---------- LZ thread ---------- */
+
+static UInt32 MatchFinderMt_GetNextBlock_Bt(CMatchFinderMt *p)
+{
+  const UInt32 *block = p->btBuf + GET_BT_BLOCK_OFFSET(MtSync_GetNextBlock(&p->btSync));
+  const UInt32 subValue = block[2];
+  p->btBufPos = block + kMtBtBlockHeader;
+  p->btBufPosLimit = block + block[0];
+  p->btNumAvailBytes = block[1];
+  if (subValue != 0)
+  {
+    p->lzPos -= subValue;
+    MatchFinder_Normalize3(subValue, p->hash, p->fixedHashSize);
+  }
+  return p->btNumAvailBytes;
+}
+
+
+static const Byte * MatchFinderMt_GetPointerToCurrentPos(void *_p)
+{
+  CMatchFinderMt *p = (CMatchFinderMt *)_p;
+  return p->pointerToCurPos;
+}
+
+
+static UInt32 MatchFinderMt_GetNumAvailableBytes(void *_p)
+{
+  CMatchFinderMt *p = (CMatchFinderMt *)_p;
+  if (p->btBufPos != p->btBufPosLimit)
+    return p->btNumAvailBytes;
+  return MatchFinderMt_GetNextBlock_Bt(p);
+}
+
+
+#define SET_mmm(p) \
+  mmm = p->cyclicBufferSize; \
+  if (mmm > m) \
+    mmm = m;
+
+#define MT_HASH2_CALC \
+  h2 = (p->crc[cur[0]] ^ cur[1]) & (kHash2Size - 1);
+
+#define MT_HASH3_CALC { \
+  const UInt32 temp = p->crc[cur[0]] ^ cur[1]; \
+  h2 = temp & (kHash2Size - 1); \
+  h3 = (temp ^ ((UInt32)cur[2] << 8)) & (kHash3Size - 1); }
+
+
+static UInt32 * MixMatches2(CMatchFinderMt *p, UInt32 *d)
+{
+  UInt32 h2, d2, mmm;
+  CLzRef *hash = p->hash;
+  const Byte *cur = p->pointerToCurPos;
+  const UInt32 m = p->lzPos;
+  MT_HASH2_CALC
+
+  d2 = m - hash[h2];
+  hash[h2] = m;
+
+  SET_mmm(p)
+
+  if (d2 < mmm && *(cur - d2) == *cur)
+  {
+    *d++ = 2;
+    *d++ = d2 - 1;
+  }
+  return d;
+}
+
+static UInt32 * MixMatches3(CMatchFinderMt *p, UInt32 *d)
+{
+  UInt32 h2, h3, d2, d3, mmm;
+  CLzRef *hash = p->hash;
+  const Byte *cur = p->pointerToCurPos;
+  const UInt32 m = p->lzPos;
+  MT_HASH3_CALC
+
+  d2 = m - hash                  [h2];
+  d3 = m - (hash + kFix3HashSize)[h3];
+  hash                  [h2] = m;
+  (hash + kFix3HashSize)[h3] = m;
+
+  SET_mmm(p)
+
+  if (d2 < mmm && *(cur - d2) == *cur)
+  {
+    d[1] = d2 - 1;
+    if (*(cur - d2 + 2) == cur[2])
+    {
+      d[0] = 3;
+      return d + 2;
+    }
+    d[0] = 2;
+    d += 2;
+  }
+  if (d3 < mmm && *(cur - d3) == *cur)
+  {
+    *d++ = 3;
+    *d++ = d3 - 1;
+  }
+  return d;
+}
+
+static void SkipHashes2(CMatchFinderMt *p)
+{
+  UInt32 h2;
+  const Byte *cur = p->pointerToCurPos;
+  MT_HASH2_CALC
+  p->hash[h2] = p->lzPos;
+}
+
+static void SkipHashes3(CMatchFinderMt *p)
+{
+  UInt32 h2, h3;
+  const Byte *cur = p->pointerToCurPos;
+  MT_HASH3_CALC
+  p->hash[h2] =
+  (p->hash + kFix3HashSize)[h3] = p->lzPos;
+}
+
+
+/* MatchFinderMt_GetRecord() returns NULL,
+   if the bt block is inconsistent with the number of available bytes.
+   The encoder checks (failure_LZ_BT) and stops with error in that case. */
+
+static const UInt32 * MatchFinderMt_GetRecord(CMatchFinderMt *p)
+{
+  const UInt32 *bt = p->btBufPos;
+  UInt32 num;
+  if (bt == p->btBufPosLimit)
+  {
+    MatchFinderMt_GetNextBlock_Bt(p);
+    bt = p->btBufPos;
+    if (bt == p->btBufPosLimit)
+    {
+      p->failure_LZ_BT = True;
+      return NULL;
+    }
+  }
+  num = *bt;
+  if (num > (UInt32)(p->btBufPosLimit - bt) - 1 || p->btNumAvailBytes == 0)
+  {
+    p->failure_LZ_BT = True;
+    p->btBufPos = p->btBufPosLimit;
+    return NULL;
+  }
+  p->btBufPos = bt + 1 + num;
+  return bt;
+}
+
+#define LZ_MOVE_POS(p) \
+  p->btNumAvailBytes--; \
+  p->lzPos++; \
+  p->pointerToCurPos++;
+
+
+static UInt32 * MatchFinderMt_GetMatches(void *_p, UInt32 *d)
+{
+  CMatchFinderMt *p = (CMatchFinderMt *)_p;
+  const UInt32 *bt = MatchFinderMt_GetRecord(p);
+  UInt32 num;
+  if (!bt)
+    return d;
+  num = *bt++;
+  if (p->MixMatchesFunc && p->btNumAvailBytes >= p->numHashBytes)
+    d = p->MixMatchesFunc(p, d);
+  for (; num != 0; num -= 2)
+  {
+    d[0] = bt[0];
+    d[1] = bt[1];
+    d += 2;
+    bt += 2;
+  }
+  LZ_MOVE_POS(p)
+  return d;
+}
+
+
+static void MatchFinderMt_Skip(void *_p, UInt32 num)
+{
+  CMatchFinderMt *p = (CMatchFinderMt *)_p;
+  do
+  {
+    if (!MatchFinderMt_GetRecord(p))
+      return;
+    if (p->SkipHashesFunc && p->btNumAvailBytes >= p->numHashBytes)
+      p->SkipHashesFunc(p);
+    LZ_MOVE_POS(p)
+  }
+  while (--num);
+}
+
+
+void MatchFinderMt_CreateVTable(CMatchFinderMt *p, IMatchFinder2 *vTable)
+{
+  vTable->Init = MatchFinderMt_Init;
+  vTable->GetNumAvailableBytes = MatchFinderMt_GetNumAvailableBytes;
+  vTable->GetPointerToCurrentPos = MatchFinderMt_GetPointerToCurrentPos;
+  vTable->GetMatches = MatchFinderMt_GetMatches;
+  vTable->Skip = MatchFinderMt_Skip;
+
+  switch (MF(p)->numHashBytes)
+  {
+    case 2:
+      p->GetHeadsFunc = GetHeads2;
+      p->MixMatchesFunc = NULL;
+      p->SkipHashesFunc = NULL;
+      break;
+    case 3:
+      p->GetHeadsFunc = GetHeads3;
+      p->MixMatchesFunc = MixMatches2;
+      p->SkipHashesFunc = SkipHashes2;
+      break;
+    case 4:
+      p->GetHeadsFunc = GetHeads4;
+      p->MixMatchesFunc = MixMatches3;
+      p->SkipHashesFunc = SkipHashes3;
+      break;
+    default:
+      p->GetHeadsFunc = GetHeads5;
+      p->MixMatchesFunc = MixMatches3;
+      p->SkipHashesFunc = SkipHashes3;
+      break;
+  }
+}
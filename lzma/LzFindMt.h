@@ -0,0 +1,111 @@
+/* LzFindMt.h -- multithreaded Match finder for LZ algorithms
+2026-10-16 : Public domain */
+
+#ifndef ZIP7_INC_LZ_FIND_MT_H
+#define ZIP7_INC_LZ_FIND_MT_H
+
+#include "LzFind.h"
+#include "Threads.h"
+
+EXTERN_C_BEGIN
+
+/*
+  CMtSync links a producer thread with the thread that consumes its blocks:
+    hashSync : HASH thread -> BT thread
+    btSync   : BT thread   -> LZ thread (the thread that calls IMatchFinder2 functions)
+  The consumer keeps (cs) entered while it works with the current block.
+  The HASH thread enters both (cs) before it moves the data window.
+*/
+
+typedef struct
+{
+  UInt32 numProcessedBlocks;
+  CThread thread;
+  UInt64 affinity;
+  Int32 affinityGroup;     /* processor groups are not supported : ignored */
+  UInt64 affinityInGroup;  /* ignored */
+
+  BoolInt wasCreated;
+  BoolInt needStart;
+  BoolInt csWasInitialized;
+  BoolInt csWasEntered;
+
+  BoolInt exit;
+  BoolInt stopWriting;
+
+  CAutoResetEvent canStart;
+  CAutoResetEvent wasStopped;
+  CSemaphore freeSemaphore;
+  CSemaphore filledSemaphore;
+  CCriticalSection cs;
+} CMtSync;
+
+
+struct CMatchFinderMt_;
+
+typedef void (*Mf_GetHeads)(const Byte *buffer, UInt32 pos,
+    UInt32 *hash, UInt32 hashMask, UInt32 *heads, UInt32 numHeads, const UInt32 *crc);
+typedef UInt32 * (*Mf_Mix_Matches)(struct CMatchFinderMt_ *p, UInt32 *d);
+typedef void (*Mf_Skip_Hashes)(struct CMatchFinderMt_ *p);
+
+typedef struct CMatchFinderMt_
+{
+  /* LZ */
+  const Byte *pointerToCurPos;
+  const UInt32 *btBufPos;
+  const UInt32 *btBufPosLimit;
+  UInt32 lzPos;
+  UInt32 btNumAvailBytes;
+
+  CLzRef *hash;
+  UInt32 fixedHashSize;
+  UInt32 numHashBytes;
+  const UInt32 *crc;
+
+  Mf_Mix_Matches MixMatchesFunc;
+  Mf_Skip_Hashes SkipHashesFunc;
+  BoolInt failure_LZ_BT;
+
+  CMtSync btSync;
+
+  /* BT */
+  UInt32 *btBuf;
+  const UInt32 *hashBufPos;
+  const UInt32 *hashBufPosLimit;
+  UInt32 hashNumAvail;
+  BoolInt hashBlockIsEnd;
+  UInt32 btSubValue;
+
+  CLzRef *son;
+  UInt32 matchMaxLen;
+  UInt32 pos;
+  const Byte *buffer;
+  UInt32 cyclicBufferPos;
+  UInt32 cyclicBufferSize; /* it must be = (historySize + 1) */
+  UInt32 cutValue;
+
+  CMtSync hashSync;
+
+  /* HASH */
+  UInt32 *hashBuf;
+  Mf_GetHeads GetHeadsFunc;
+  CMatchFinder *MatchFinder;
+} CMatchFinderMt;
+
+void MatchFinderMt_Construct(CMatchFinderMt *p);
+void MatchFinderMt_Destruct(CMatchFinderMt *p, ISzAllocPtr alloc);
+SRes MatchFinderMt_Create(CMatchFinderMt *p, UInt32 historySize, UInt32 keepAddBufferBefore,
+    UInt32 matchMaxLen, UInt32 keepAddBufferAfter, ISzAllocPtr alloc);
+/* MatchFinderMt_GetMemUsage() returns the size of memory that MatchFinderMt_Create()
+   allocates for match finder with the settings of (mf), or 0 for unsupported parameters */
+UInt64 MatchFinderMt_GetMemUsage(const CMatchFinder *mf, UInt32 historySize, UInt32 keepAddBufferBefore,
+    UInt32 matchMaxLen, UInt32 keepAddBufferAfter);
+void MatchFinderMt_CreateVTable(CMatchFinderMt *p, IMatchFinder2 *vTable);
+/* MatchFinderMt_InitMt() must be called before (vTable->Init) for each new stream */
+SRes MatchFinderMt_InitMt(CMatchFinderMt *p);
+/* MatchFinderMt_ReleaseStream() stops the BT and HASH threads after the end of stream */
+void MatchFinderMt_ReleaseStream(CMatchFinderMt *p);
+
+EXTERN_C_END
+
+#endif
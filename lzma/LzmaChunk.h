@@ -0,0 +1,63 @@
+/* LzmaChunk.h -- Chunked LZMA stream format
+2026-10-16 : Public domain */
+
+#ifndef ZIP7_INC_LZMA_CHUNK_H
+#define ZIP7_INC_LZMA_CHUNK_H
+
+#include "7zTypes.h"
+
+EXTERN_C_BEGIN
+
+/*
+  Chunked LZMA stream : the data is split to chunks of (chunkSize) bytes,
+  and each chunk is coded independently (new LZMA state and empty dictionary).
+  So the chunks can be encoded and decoded in parallel.
+  All numbers are little-endian.
+
+  Header (LZMA_CHUNK_HEADER_SIZE bytes):
+    4 : signature : 'L' 'Z' 'C' 1
+    5 : LZMA properties (lc/lp/pb, dictSize) for all LZMA chunks
+    3 : reserved (0)
+    4 : chunkSize : unpacked size of each chunk, except of last chunk that can be smaller
+
+  Chunk (LZMA_CHUNK_RECORD_HEADER_SIZE bytes + packSize):
+    1 : type : LZMA_CHUNK_TYPE_STORED or LZMA_CHUNK_TYPE_LZMA
+    4 : packSize
+    4 : unpackSize
+    packSize : raw data, or LZMA data without end marker
+
+  Index : (numChunks) records of LZMA_CHUNK_INDEX_RECORD_SIZE bytes:
+    4 : packSize
+    4 : unpackSize
+
+  Footer (LZMA_CHUNK_FOOTER_SIZE bytes):
+    8 : total unpacked size
+    4 : numChunks
+    4 : signature : 'L' 'Z' 'C' 'X'
+
+  The index repeats the chunk headers. It allows the decoder to get the position
+  of each chunk in packed and unpacked data without scanning of whole stream.
+*/
+
+#define LZMA_CHUNK_HEADER_SIZE  16
+#define LZMA_CHUNK_RECORD_HEADER_SIZE  9
+#define LZMA_CHUNK_INDEX_RECORD_SIZE  8
+#define LZMA_CHUNK_FOOTER_SIZE  16
+
+#define LZMA_CHUNK_TYPE_STORED  0
+#define LZMA_CHUNK_TYPE_LZMA    1
+
+#define LZMA_CHUNK_SIGNATURE_0  'L'
+#define LZMA_CHUNK_SIGNATURE_1  'Z'
+#define LZMA_CHUNK_SIGNATURE_2  'C'
+#define LZMA_CHUNK_SIGNATURE_3  1
+#define LZMA_CHUNK_FOOTER_SIGNATURE_3  'X'
+
+#define LZMA_CHUNK_SIZE_MIN  ((UInt32)1 << 16)
+#define LZMA_CHUNK_SIZE_MAX  ((UInt32)1 << 30)
+
+#define LZMA_CHUNK_THREADS_MAX  256
+
+EXTERN_C_END
+
+#endif
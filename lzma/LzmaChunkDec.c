@@ -0,0 +1,325 @@
+/* LzmaChunkDec.c -- Chunked LZMA stream decoder
+2026-10-16 : Public domain */
+
+#include "Precomp.h"
+
+#include <string.h>
+
+#include "CpuArch.h"
+#include "LzmaChunkDec.h"
+#include "LzmaDec.h"
+
+#ifndef Z7_ST
+#include "Threads.h"
+#endif
+
+#define LZMA_CHUNK_MIN_LZMA_PACK_SIZE  5
+
+static SRes LzmaChunkDec_ReadFooter(const Byte *src, SizeT srcLen, UInt64 *unpackSize, UInt32 *numChunks)
+{
+  const Byte *footer;
+  if (srcLen < LZMA_CHUNK_HEADER_SIZE + LZMA_CHUNK_FOOTER_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+  footer = src + srcLen - LZMA_CHUNK_FOOTER_SIZE;
+  if (   src[0] != LZMA_CHUNK_SIGNATURE_0
+      || src[1] != LZMA_CHUNK_SIGNATURE_1
+      || src[2] != LZMA_CHUNK_SIGNATURE_2
+      || src[3] != LZMA_CHUNK_SIGNATURE_3
+      || footer[12] != LZMA_CHUNK_SIGNATURE_0
+      || footer[13] != LZMA_CHUNK_SIGNATURE_1
+      || footer[14] != LZMA_CHUNK_SIGNATURE_2
+      || footer[15] != LZMA_CHUNK_FOOTER_SIGNATURE_3)
+    return SZ_ERROR_UNSUPPORTED;
+  *unpackSize = GetUi64(footer);
+  *numChunks = GetUi32(footer + 8);
+  return SZ_OK;
+}
+
+
+SRes LzmaChunkDec_GetUnpackSize(const Byte *src, SizeT srcLen, UInt64 *unpackSize)
+{
+  UInt32 numChunks;
+  *unpackSize = 0;
+  return LzmaChunkDec_ReadFooter(src, srcLen, unpackSize, &numChunks);
+}
+
+
+typedef struct CLzmaChunkDec_ CLzmaChunkDec;
+
+typedef struct
+{
+  CLzmaChunkDec *owner;
+  CLzmaDec dec;
+  #ifndef Z7_ST
+  CThread thread;
+  #endif
+} CLzmaChunkDecThread;
+
+struct CLzmaChunkDec_
+{
+  const Byte *src;
+  Byte *dest;
+  SizeT *packPos;  /* the positions of chunk data in (src) */
+  UInt32 chunkSize;
+  UInt32 numChunks;
+  UInt32 lastUnpackSize;
+  unsigned numThreads;
+
+  /* the following variables are protected by (cs) */
+  UInt32 nextChunk;
+  SRes res;
+
+  #ifndef Z7_ST
+  CCriticalSection cs;
+  #endif
+  CLzmaChunkDecThread *threads;
+};
+
+#ifndef Z7_ST
+  #define LOCK_DEC(p)    if ((p)->numThreads > 1) CriticalSection_Enter(&(p)->cs);
+  #define UNLOCK_DEC(p)  if ((p)->numThreads > 1) CriticalSection_Leave(&(p)->cs);
+#else
+  #define LOCK_DEC(p)
+  #define UNLOCK_DEC(p)
+#endif
+
+
+/* it checks the index and the headers of chunks, and it fills (p->packPos) */
+
+static SRes LzmaChunkDec_ReadIndex(CLzmaChunkDec *p, SizeT srcLen, UInt64 unpackSize)
+{
+  const Byte *src = p->src;
+  const SizeT indexPos = srcLen - LZMA_CHUNK_FOOTER_SIZE - (SizeT)p->numChunks * LZMA_CHUNK_INDEX_RECORD_SIZE;
+  const Byte *index = src + indexPos;
+  SizeT pos = LZMA_CHUNK_HEADER_SIZE;
+  UInt64 total = 0;
+  UInt32 i;
+
+  for (i = 0; i < p->numChunks; i++, index += LZMA_CHUNK_INDEX_RECORD_SIZE)
+  {
+    const UInt32 packSize = GetUi32(index);
+    const UInt32 chunkUnpackSize = GetUi32(index + 4);
+    const Byte *rec = src + pos;
+    unsigned type;
+
+    if (indexPos - pos < LZMA_CHUNK_RECORD_HEADER_SIZE
+        || indexPos - pos - LZMA_CHUNK_RECORD_HEADER_SIZE < packSize)
+      return SZ_ERROR_DATA;
+    if (GetUi32(rec + 1) != packSize || GetUi32(rec + 5) != chunkUnpackSize)
+      return SZ_ERROR_DATA;
+    /* all chunks, except of last chunk, have (chunkSize) bytes */
+    if (i == p->numChunks - 1 ?
+          (chunkUnpackSize == 0 || chunkUnpackSize > p->chunkSize) :
+          (chunkUnpackSize != p->chunkSize))
+      return SZ_ERROR_DATA;
+    type = rec[0];
+    if (type == LZMA_CHUNK_TYPE_STORED)
+    {
+      if (packSize != chunkUnpackSize)
+        return SZ_ERROR_DATA;
+    }
+    else if (type == LZMA_CHUNK_TYPE_LZMA)
+    {
+      if (packSize < LZMA_CHUNK_MIN_LZMA_PACK_SIZE)
+        return SZ_ERROR_DATA;
+    }
+    else
+      return SZ_ERROR_UNSUPPORTED;
+
+    p->packPos[i] = pos + LZMA_CHUNK_RECORD_HEADER_SIZE;
+    pos += LZMA_CHUNK_RECORD_HEADER_SIZE + packSize;
+    total += chunkUnpackSize;
+    p->lastUnpackSize = chunkUnpackSize;
+  }
+
+  if (pos != indexPos || total != unpackSize)
+    return SZ_ERROR_DATA;
+  return SZ_OK;
+}
+
+
+static SRes LzmaChunkDec_DecodeChunk(CLzmaChunkDec *p, CLzmaDec *dec, UInt32 chunkIndex)
+{
+  const Byte *rec = p->src + p->packPos[chunkIndex] - LZMA_CHUNK_RECORD_HEADER_SIZE;
+  const SizeT packSize = GetUi32(rec + 1);
+  const SizeT unpackSize = GetUi32(rec + 5);
+  const Byte *data = rec + LZMA_CHUNK_RECORD_HEADER_SIZE;
+  Byte *dest = p->dest + (SizeT)chunkIndex * p->chunkSize;
+
+  if (rec[0] == LZMA_CHUNK_TYPE_STORED)
+  {
+    memcpy(dest, data, unpackSize);
+    return SZ_OK;
+  }
+  {
+    SizeT inSize = packSize;
+    ELzmaStatus status;
+    SRes res;
+    /* the chunk starts with empty dictionary, so the slice of (dest) is enough for dictionary */
+    dec->dic = dest;
+    dec->dicBufSize = unpackSize;
+    LzmaDec_Init(dec);
+    res = LzmaDec_DecodeToDic(dec, unpackSize, data, &inSize, LZMA_FINISH_END, &status);
+    if (res == SZ_OK)
+      if (dec->dicPos != unpackSize
+          || inSize != packSize
+          || (status != LZMA_STATUS_FINISHED_WITH_MARK
+            && status != LZMA_STATUS_MAYBE_FINISHED_WITHOUT_MARK))
+        res = SZ_ERROR_DATA;
+    return res;
+  }
+}
+
+
+static void LzmaChunkDec_ThreadFunc(CLzmaChunkDecThread *t)
+{
+  CLzmaChunkDec *p = t->owner;
+  for (;;)
+  {
+    UInt32 chunkIndex;
+    SRes res;
+
+    LOCK_DEC(p)
+    chunkIndex = p->nextChunk;
+    if (p->res == SZ_OK && chunkIndex != p->numChunks)
+      p->nextChunk++;
+    else
+      chunkIndex = p->numChunks;
+    UNLOCK_DEC(p)
+
+    if (chunkIndex == p->numChunks)
+      return;
+
+    res = LzmaChunkDec_DecodeChunk(p, &t->dec, chunkIndex);
+
+    if (res != SZ_OK)
+    {
+      LOCK_DEC(p)
+      if (p->res == SZ_OK)
+        p->res = res;
+      UNLOCK_DEC(p)
+    }
+  }
+}
+
+
+#ifndef Z7_ST
+static THREAD_FUNC_DECL LzmaChunkDec_ThreadFunc2(void *p)
+{
+  LzmaChunkDec_ThreadFunc((CLzmaChunkDecThread *)p);
+  return THREAD_FUNC_RET_ZERO;
+}
+#endif
+
+
+static SRes LzmaChunkDec_Run(CLzmaChunkDec *p)
+{
+  #ifndef Z7_ST
+  if (p->numThreads > 1)
+  {
+    unsigned i;
+    SRes res = SZ_OK;
+    if (CriticalSection_Init(&p->cs) != 0)
+      return SZ_ERROR_THREAD;
+    /* the calling thread works as the first thread */
+    for (i = 1; i < p->numThreads; i++)
+      if (Thread_Create(&p->threads[i].thread, LzmaChunkDec_ThreadFunc2, &p->threads[i]) != 0)
+      {
+        /* the chunks are still processed by created threads */
+        res = SZ_ERROR_THREAD;
+        break;
+      }
+    LzmaChunkDec_ThreadFunc(&p->threads[0]);
+    for (i = 1; i < p->numThreads; i++)
+      Thread_Wait_Close(&p->threads[i].thread);
+    CriticalSection_Delete(&p->cs);
+    if (p->res == SZ_OK && p->nextChunk != p->numChunks)
+      p->res = res;
+    return p->res;
+  }
+  #endif
+  LzmaChunkDec_ThreadFunc(&p->threads[0]);
+  return p->res;
+}
+
+
+SRes LzmaChunkDec_Decode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    int numThreads, ISzAllocPtr alloc)
+{
+  CLzmaChunkDec p;
+  SRes res;
+  UInt64 unpackSize;
+  UInt32 numChunks;
+  const SizeT destCap = *destLen;
+  unsigned i;
+
+  *destLen = 0;
+
+  RINOK(LzmaChunkDec_ReadFooter(src, srcLen, &unpackSize, &numChunks))
+  if ((UInt64)numChunks * LZMA_CHUNK_INDEX_RECORD_SIZE > srcLen - LZMA_CHUNK_HEADER_SIZE - LZMA_CHUNK_FOOTER_SIZE)
+    return SZ_ERROR_DATA;
+  if (GetUi32(src + 12) < LZMA_CHUNK_SIZE_MIN || GetUi32(src + 12) > LZMA_CHUNK_SIZE_MAX)
+    return SZ_ERROR_UNSUPPORTED;
+  if (unpackSize > destCap)
+    return SZ_ERROR_OUTPUT_EOF;
+
+  memset(&p, 0, sizeof(p));
+  p.src = src;
+  p.dest = dest;
+  p.chunkSize = GetUi32(src + 12);
+  p.numChunks = numChunks;
+  if (numThreads <= 0)
+    numThreads = 1;
+  #ifdef Z7_ST
+  numThreads = 1;
+  #endif
+  if (numThreads > LZMA_CHUNK_THREADS_MAX)
+    numThreads = LZMA_CHUNK_THREADS_MAX;
+  p.numThreads = (unsigned)numThreads;
+  if (p.numThreads > numChunks)
+    p.numThreads = (numChunks == 0 ? 1 : numChunks);
+  p.res = SZ_OK;
+
+  p.packPos = (SizeT *)ISzAlloc_Alloc(alloc, (size_t)numChunks * sizeof(SizeT) + 1);
+  if (!p.packPos)
+    return SZ_ERROR_MEM;
+
+  res = LzmaChunkDec_ReadIndex(&p, srcLen, unpackSize);
+
+  if (res == SZ_OK)
+  {
+    p.threads = (CLzmaChunkDecThread *)ISzAlloc_Alloc(alloc, p.numThreads * sizeof(CLzmaChunkDecThread));
+    if (!p.threads)
+      res = SZ_ERROR_MEM;
+    else
+    {
+      for (i = 0; i < p.numThreads; i++)
+      {
+        CLzmaChunkDecThread *t = &p.threads[i];
+        t->owner = &p;
+        LzmaDec_CONSTRUCT(&t->dec)
+        #ifndef Z7_ST
+        Thread_CONSTRUCT(&t->thread)
+        #endif
+      }
+      /* all chunks use same properties, so the probs are allocated only once for each thread */
+      for (i = 0; i < p.numThreads && res == SZ_OK; i++)
+        res = LzmaDec_AllocateProbs(&p.threads[i].dec, src + 4, LZMA_PROPS_SIZE, alloc);
+    }
+  }
+
+  if (res == SZ_OK)
+    res = LzmaChunkDec_Run(&p);
+
+  if (res == SZ_OK)
+    *destLen = (SizeT)unpackSize;
+
+  if (p.threads)
+  {
+    for (i = 0; i < p.numThreads; i++)
+      LzmaDec_FreeProbs(&p.threads[i].dec, alloc);
+    ISzAlloc_Free(alloc, p.threads);
+  }
+  ISzAlloc_Free(alloc, p.packPos);
+  return res;
+}
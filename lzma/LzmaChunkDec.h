@@ -0,0 +1,54 @@
+/* LzmaChunkDec.h -- Chunked LZMA stream decoder
+2026-10-16 : Public domain */
+
+#ifndef ZIP7_INC_LZMA_CHUNK_DEC_H
+#define ZIP7_INC_LZMA_CHUNK_DEC_H
+
+#include "LzmaChunk.h"
+
+EXTERN_C_BEGIN
+
+/*
+LzmaChunkDec_GetUnpackSize
+  Reads the total unpacked size from the footer of chunked LZMA stream.
+  (srcLen) is the size of whole stream.
+
+Return code:
+  SZ_OK               - OK
+  SZ_ERROR_INPUT_EOF  - the stream is smaller than header and footer
+  SZ_ERROR_UNSUPPORTED - it's not chunked LZMA stream
+*/
+
+SRes LzmaChunkDec_GetUnpackSize(const Byte *src, SizeT srcLen, UInt64 *unpackSize);
+
+/*
+LzmaChunkDec_Decode
+  Decodes the chunked LZMA stream of (srcLen) bytes.
+  The positions of chunks are calculated from the index.
+  Up to (numThreads) chunks are decoded at the same time.
+  Each thread uses one CLzmaDec object with its own probs,
+  and it decodes the chunk directly to (dest) buffer.
+
+  (alloc) must be thread-safe, if (numThreads > 1).
+
+  In:
+    *destLen   - the size of (dest) buffer
+  Out:
+    *destLen   - the size of decoded data, if SZ_OK
+
+Return code:
+  SZ_OK                - OK
+  SZ_ERROR_DATA        - Data error
+  SZ_ERROR_MEM         - Memory allocation error
+  SZ_ERROR_UNSUPPORTED - Unsupported properties or it's not chunked LZMA stream
+  SZ_ERROR_INPUT_EOF   - the stream is smaller than header and footer
+  SZ_ERROR_OUTPUT_EOF  - output buffer is too small
+  SZ_ERROR_THREAD      - error in multithreading functions
+*/
+
+SRes LzmaChunkDec_Decode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    int numThreads, ISzAllocPtr alloc);
+
+EXTERN_C_END
+
+#endif
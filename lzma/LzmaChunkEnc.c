@@ -0,0 +1,432 @@
+/* LzmaChunkEnc.c -- Chunked LZMA stream encoder
+2026-10-16 : Public domain */
+
+#include "Precomp.h"
+
+#include <string.h>
+
+#include "CpuArch.h"
+#include "LzmaChunkEnc.h"
+
+#ifndef Z7_ST
+#include "Threads.h"
+#endif
+
+void LzmaChunkEncProps_Init(CLzmaChunkEncProps *p)
+{
+  LzmaEncProps_Init(&p->lzmaProps);
+  p->chunkSize = 0;
+  p->numThreads = -1;
+}
+
+void LzmaChunkEncProps_Normalize(CLzmaChunkEncProps *p)
+{
+  /* the parallelism comes from chunks, so one LZMA encoder uses one thread by default */
+  if (p->lzmaProps.numThreads < 0)
+    p->lzmaProps.numThreads = 1;
+
+  if (p->numThreads <= 0)
+    p->numThreads = 1;
+  #ifdef Z7_ST
+  p->numThreads = 1;
+  #endif
+  if (p->numThreads > LZMA_CHUNK_THREADS_MAX)
+    p->numThreads = LZMA_CHUNK_THREADS_MAX;
+
+  if (p->chunkSize == 0)
+  {
+    UInt64 v = (UInt64)LzmaEncProps_GetDictSize(&p->lzmaProps) << 2;
+    const UInt32 kMinSize = (UInt32)1 << 20;
+    const UInt32 kMaxSize = (UInt32)1 << 28;
+    if (v < kMinSize) v = kMinSize;
+    if (v > kMaxSize) v = kMaxSize;
+    p->chunkSize = (UInt32)v;
+  }
+  if (p->chunkSize < LZMA_CHUNK_SIZE_MIN) p->chunkSize = LZMA_CHUNK_SIZE_MIN;
+  if (p->chunkSize > LZMA_CHUNK_SIZE_MAX) p->chunkSize = LZMA_CHUNK_SIZE_MAX;
+
+  /* the dictionary that is larger than chunk is useless */
+  if (p->lzmaProps.reduceSize > p->chunkSize)
+    p->lzmaProps.reduceSize = p->chunkSize;
+  LzmaEncProps_Normalize(&p->lzmaProps);
+}
+
+
+/* the properties that LzmaChunkEnc_Encode() uses for (srcLen) bytes */
+static void LzmaChunkEncProps_NormalizeForSize(CLzmaChunkEncProps *p, SizeT srcLen)
+{
+  if (p->lzmaProps.reduceSize > srcLen)
+    p->lzmaProps.reduceSize = srcLen;
+  LzmaChunkEncProps_Normalize(p);
+}
+
+
+SizeT LzmaChunkEnc_GetMaxPackSize(SizeT srcLen, const CLzmaChunkEncProps *props2)
+{
+  CLzmaChunkEncProps props = *props2;
+  UInt64 numChunks, size;
+  LzmaChunkEncProps_NormalizeForSize(&props, srcLen);
+  numChunks = ((UInt64)srcLen + props.chunkSize - 1) / props.chunkSize;
+  size = (UInt64)srcLen
+      + LZMA_CHUNK_HEADER_SIZE
+      + numChunks * (LZMA_CHUNK_RECORD_HEADER_SIZE + LZMA_CHUNK_INDEX_RECORD_SIZE)
+      + LZMA_CHUNK_FOOTER_SIZE;
+  if (size != (SizeT)size)
+    return 0;
+  return (SizeT)size;
+}
+
+
+typedef struct CLzmaChunkEnc_ CLzmaChunkEnc;
+
+typedef struct
+{
+  CLzmaChunkEnc *owner;
+  CLzmaEncHandle enc;
+  Byte *outBuf;
+  #ifndef Z7_ST
+  CThread thread;
+  CAutoResetEvent canWrite;  /* for the chunks with (chunkIndex % numThreads == index of this item) */
+  #endif
+} CLzmaChunkEncThread;
+
+struct CLzmaChunkEnc_
+{
+  const Byte *src;
+  SizeT srcLen;
+  Byte *dest;
+  SizeT destCap;
+  Byte *index;
+  const CLzmaEncProps *lzmaProps;
+  ISzAllocPtr alloc;
+  ISzAllocPtr allocBig;
+  UInt32 chunkSize;
+  UInt32 numChunks;
+  unsigned numThreads;
+
+  /* the following variables are protected by (cs) */
+  UInt32 nextChunk;  /* next chunk for encoding */
+  UInt32 nextWrite;  /* next chunk for writing */
+  SRes res;
+  /* (outPos) is changed only by the thread that writes the chunk (nextWrite) */
+  SizeT outPos;
+
+  #ifndef Z7_ST
+  CCriticalSection cs;
+  #endif
+  CLzmaChunkEncThread *threads;
+};
+
+#ifndef Z7_ST
+  #define LOCK_ENC(p)    if ((p)->numThreads > 1) CriticalSection_Enter(&(p)->cs);
+  #define UNLOCK_ENC(p)  if ((p)->numThreads > 1) CriticalSection_Leave(&(p)->cs);
+#else
+  #define LOCK_ENC(p)
+  #define UNLOCK_ENC(p)
+#endif
+
+
+static void LzmaChunkEnc_WaitWrite(CLzmaChunkEnc *p, UInt32 chunkIndex)
+{
+  #ifndef Z7_ST
+  if (p->numThreads > 1)
+  {
+    /* a thread can own only one chunk, so the (numThreads) chunks
+       after (nextWrite) use different events.
+       The event can be set for the previous chunk of same slot, so we check again. */
+    CAutoResetEvent *event = &p->threads[chunkIndex % p->numThreads].canWrite;
+    for (;;)
+    {
+      UInt32 nextWrite;
+      CriticalSection_Enter(&p->cs);
+      nextWrite = p->nextWrite;
+      CriticalSection_Leave(&p->cs);
+      if (nextWrite == chunkIndex)
+        return;
+      Event_Wait(event);
+    }
+  }
+  #else
+  UNUSED_VAR(p)
+  UNUSED_VAR(chunkIndex)
+  #endif
+}
+
+
+static void LzmaChunkEnc_WriteDone(CLzmaChunkEnc *p, SRes res)
+{
+  UInt32 nextWrite;
+  LOCK_ENC(p)
+  if (p->res == SZ_OK)
+    p->res = res;
+  nextWrite = ++p->nextWrite;
+  UNLOCK_ENC(p)
+  #ifndef Z7_ST
+  if (p->numThreads > 1)
+    Event_Set(&p->threads[nextWrite % p->numThreads].canWrite);
+  #else
+  UNUSED_VAR(nextWrite)
+  #endif
+}
+
+
+static SRes LzmaChunkEnc_WriteChunk(CLzmaChunkEnc *p, UInt32 chunkIndex,
+    unsigned type, const Byte *data, SizeT packSize, UInt32 unpackSize)
+{
+  Byte *dest;
+  if (p->destCap - p->outPos < LZMA_CHUNK_RECORD_HEADER_SIZE
+      || p->destCap - p->outPos - LZMA_CHUNK_RECORD_HEADER_SIZE < packSize)
+    return SZ_ERROR_OUTPUT_EOF;
+  dest = p->dest + p->outPos;
+  dest[0] = (Byte)type;
+  SetUi32(dest + 1, (UInt32)packSize)
+  SetUi32(dest + 5, unpackSize)
+  memcpy(dest + LZMA_CHUNK_RECORD_HEADER_SIZE, data, packSize);
+  p->outPos += LZMA_CHUNK_RECORD_HEADER_SIZE + packSize;
+  {
+    Byte *rec = p->index + (size_t)chunkIndex * LZMA_CHUNK_INDEX_RECORD_SIZE;
+    SetUi32(rec, (UInt32)packSize)
+    SetUi32(rec + 4, unpackSize)
+  }
+  return SZ_OK;
+}
+
+
+static void LzmaChunkEnc_ThreadFunc(CLzmaChunkEncThread *t)
+{
+  CLzmaChunkEnc *p = t->owner;
+  for (;;)
+  {
+    UInt32 chunkIndex;
+    SRes res;
+    const Byte *data;
+    SizeT packSize;
+    UInt32 unpackSize;
+    unsigned type = LZMA_CHUNK_TYPE_LZMA;
+
+    LOCK_ENC(p)
+    chunkIndex = p->nextChunk;
+    if (p->res == SZ_OK && chunkIndex != p->numChunks)
+      p->nextChunk++;
+    else
+      chunkIndex = p->numChunks;
+    UNLOCK_ENC(p)
+
+    if (chunkIndex == p->numChunks)
+      return;
+
+    {
+      const SizeT offset = (SizeT)chunkIndex * p->chunkSize;
+      const SizeT rem = p->srcLen - offset;
+      unpackSize = (rem < p->chunkSize ? (UInt32)rem : p->chunkSize);
+      data = p->src + offset;
+    }
+
+    /* the chunk is stored, if LZMA data is not smaller */
+    packSize = unpackSize;
+    res = LzmaEnc_SetProps(t->enc, p->lzmaProps);
+    if (res == SZ_OK)
+      res = LzmaEnc_MemEncode(t->enc, t->outBuf, &packSize, data, unpackSize,
+          0, NULL, p->alloc, p->allocBig);
+    if (res == SZ_OK && packSize < unpackSize)
+      data = t->outBuf;
+    else if (res == SZ_OK || res == SZ_ERROR_OUTPUT_EOF)
+    {
+      res = SZ_OK;
+      type = LZMA_CHUNK_TYPE_STORED;
+      packSize = unpackSize;
+    }
+
+    LzmaChunkEnc_WaitWrite(p, chunkIndex);
+
+    LOCK_ENC(p)
+    if (p->res != SZ_OK)
+      res = p->res;
+    UNLOCK_ENC(p)
+
+    if (res == SZ_OK)
+      res = LzmaChunkEnc_WriteChunk(p, chunkIndex, type, data, packSize, unpackSize);
+
+    LzmaChunkEnc_WriteDone(p, res);
+  }
+}
+
+
+#ifndef Z7_ST
+static THREAD_FUNC_DECL LzmaChunkEnc_ThreadFunc2(void *p)
+{
+  LzmaChunkEnc_ThreadFunc((CLzmaChunkEncThread *)p);
+  return THREAD_FUNC_RET_ZERO;
+}
+#endif
+
+
+static void LzmaChunkEnc_FreeThreads(CLzmaChunkEnc *p)
+{
+  unsigned i;
+  if (!p->threads)
+    return;
+  for (i = 0; i < p->numThreads; i++)
+  {
+    CLzmaChunkEncThread *t = &p->threads[i];
+    #ifndef Z7_ST
+    Event_Close(&t->canWrite);
+    #endif
+    if (t->enc)
+      LzmaEnc_Destroy(t->enc, p->alloc, p->allocBig);
+    ISzAlloc_Free(p->allocBig, t->outBuf);
+  }
+  ISzAlloc_Free(p->alloc, p->threads);
+  p->threads = NULL;
+}
+
+
+static SRes LzmaChunkEnc_AllocThreads(CLzmaChunkEnc *p)
+{
+  unsigned i;
+  p->threads = (CLzmaChunkEncThread *)ISzAlloc_Alloc(p->alloc, p->numThreads * sizeof(CLzmaChunkEncThread));
+  if (!p->threads)
+    return SZ_ERROR_MEM;
+  for (i = 0; i < p->numThreads; i++)
+  {
+    CLzmaChunkEncThread *t = &p->threads[i];
+    t->owner = p;
+    t->enc = NULL;
+    t->outBuf = NULL;
+    #ifndef Z7_ST
+    Thread_CONSTRUCT(&t->thread)
+    Event_Construct(&t->canWrite);
+    #endif
+  }
+  for (i = 0; i < p->numThreads; i++)
+  {
+    CLzmaChunkEncThread *t = &p->threads[i];
+    t->enc = LzmaEnc_Create(p->alloc);
+    if (!t->enc)
+      return SZ_ERROR_MEM;
+    t->outBuf = (Byte *)ISzAlloc_Alloc(p->allocBig, p->srcLen < p->chunkSize ? p->srcLen + 1 : p->chunkSize);
+    if (!t->outBuf)
+      return SZ_ERROR_MEM;
+    #ifndef Z7_ST
+    if (p->numThreads > 1)
+      if (AutoResetEvent_CreateNotSignaled(&t->canWrite) != 0)
+        return SZ_ERROR_THREAD;
+    #endif
+  }
+  return SZ_OK;
+}
+
+
+static SRes LzmaChunkEnc_Run(CLzmaChunkEnc *p)
+{
+  #ifndef Z7_ST
+  if (p->numThreads > 1)
+  {
+    unsigned i;
+    SRes res = SZ_OK;
+    if (CriticalSection_Init(&p->cs) != 0)
+      return SZ_ERROR_THREAD;
+    /* the calling thread works as the first thread */
+    for (i = 1; i < p->numThreads; i++)
+      if (Thread_Create(&p->threads[i].thread, LzmaChunkEnc_ThreadFunc2, &p->threads[i]) != 0)
+      {
+        /* the chunks are still processed by created threads */
+        res = SZ_ERROR_THREAD;
+        break;
+      }
+    LzmaChunkEnc_ThreadFunc(&p->threads[0]);
+    for (i = 1; i < p->numThreads; i++)
+      Thread_Wait_Close(&p->threads[i].thread);
+    CriticalSection_Delete(&p->cs);
+    if (p->res == SZ_OK && p->nextWrite != p->numChunks)
+      p->res = res;
+    return p->res;
+  }
+  #endif
+  LzmaChunkEnc_ThreadFunc(&p->threads[0]);
+  return p->res;
+}
+
+
+SRes LzmaChunkEnc_Encode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaChunkEncProps *props2, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  CLzmaChunkEncProps props = *props2;
+  CLzmaChunkEnc p;
+  SRes res;
+  const SizeT destCap = *destLen;
+  UInt64 numChunks;
+
+  *destLen = 0;
+
+  LzmaChunkEncProps_NormalizeForSize(&props, srcLen);
+
+  numChunks = ((UInt64)srcLen + props.chunkSize - 1) / props.chunkSize;
+  if (numChunks > (UInt32)0xFFFFFFFF)
+    return SZ_ERROR_PARAM;
+  if (destCap < LZMA_CHUNK_HEADER_SIZE + LZMA_CHUNK_FOOTER_SIZE)
+    return SZ_ERROR_OUTPUT_EOF;
+
+  memset(&p, 0, sizeof(p));
+  p.src = src;
+  p.srcLen = srcLen;
+  p.dest = dest;
+  p.destCap = destCap;
+  p.lzmaProps = &props.lzmaProps;
+  p.alloc = alloc;
+  p.allocBig = allocBig;
+  p.chunkSize = props.chunkSize;
+  p.numChunks = (UInt32)numChunks;
+  p.numThreads = (unsigned)props.numThreads;
+  if (p.numThreads > p.numChunks)
+    p.numThreads = (p.numChunks == 0 ? 1 : p.numChunks);
+  p.res = SZ_OK;
+  p.outPos = LZMA_CHUNK_HEADER_SIZE;
+
+  p.index = (Byte *)ISzAlloc_Alloc(alloc, (size_t)p.numChunks * LZMA_CHUNK_INDEX_RECORD_SIZE + 1);
+  if (!p.index)
+    return SZ_ERROR_MEM;
+
+  res = LzmaChunkEnc_AllocThreads(&p);
+
+  if (res == SZ_OK)
+  {
+    SizeT propsSize = LZMA_PROPS_SIZE;
+    dest[0] = LZMA_CHUNK_SIGNATURE_0;
+    dest[1] = LZMA_CHUNK_SIGNATURE_1;
+    dest[2] = LZMA_CHUNK_SIGNATURE_2;
+    dest[3] = LZMA_CHUNK_SIGNATURE_3;
+    res = LzmaEnc_SetProps(p.threads[0].enc, &props.lzmaProps);
+    if (res == SZ_OK)
+      res = LzmaEnc_WriteProperties(p.threads[0].enc, dest + 4, &propsSize);
+    dest[9] = dest[10] = dest[11] = 0;
+    SetUi32(dest + 12, p.chunkSize)
+  }
+
+  if (res == SZ_OK)
+    res = LzmaChunkEnc_Run(&p);
+
+  if (res == SZ_OK)
+  {
+    const size_t indexSize = (size_t)p.numChunks * LZMA_CHUNK_INDEX_RECORD_SIZE;
+    if (p.destCap - p.outPos < indexSize + LZMA_CHUNK_FOOTER_SIZE)
+      res = SZ_ERROR_OUTPUT_EOF;
+    else
+    {
+      Byte *footer;
+      memcpy(dest + p.outPos, p.index, indexSize);
+      footer = dest + p.outPos + indexSize;
+      SetUi64(footer, (UInt64)srcLen)
+      SetUi32(footer + 8, p.numChunks)
+      footer[12] = LZMA_CHUNK_SIGNATURE_0;
+      footer[13] = LZMA_CHUNK_SIGNATURE_1;
+      footer[14] = LZMA_CHUNK_SIGNATURE_2;
+      footer[15] = LZMA_CHUNK_FOOTER_SIGNATURE_3;
+      *destLen = p.outPos + indexSize + LZMA_CHUNK_FOOTER_SIZE;
+    }
+  }
+
+  LzmaChunkEnc_FreeThreads(&p);
+  ISzAlloc_Free(alloc, p.index);
+  return res;
+}
@@ -0,0 +1,51 @@
+/* LzmaChunkEnc.h -- Chunked LZMA stream encoder
+2026-10-16 : Public domain */
+
+#ifndef ZIP7_INC_LZMA_CHUNK_ENC_H
+#define ZIP7_INC_LZMA_CHUNK_ENC_H
+
+#include "LzmaChunk.h"
+#include "LzmaEnc.h"
+
+EXTERN_C_BEGIN
+
+typedef struct
+{
+  CLzmaEncProps lzmaProps;
+  UInt32 chunkSize;  /* LZMA_CHUNK_SIZE_MIN <= chunkSize <= LZMA_CHUNK_SIZE_MAX,
+                        default = (dictSize * 4) in [1 MB ... 256 MB] range */
+  int numThreads;    /* 1 <= numThreads <= LZMA_CHUNK_THREADS_MAX, default = 1 */
+} CLzmaChunkEncProps;
+
+void LzmaChunkEncProps_Init(CLzmaChunkEncProps *p);
+void LzmaChunkEncProps_Normalize(CLzmaChunkEncProps *p);
+
+/* LzmaChunkEnc_GetMaxPackSize() returns the size of destination buffer
+   that is enough for LzmaChunkEnc_Encode() with (props) for any data of (srcLen) bytes,
+   or 0 for overflow. (props) are normalized like LzmaChunkEnc_Encode() does. */
+SizeT LzmaChunkEnc_GetMaxPackSize(SizeT srcLen, const CLzmaChunkEncProps *props);
+
+/*
+LzmaChunkEnc_Encode
+  Encodes the data to chunked LZMA stream.
+  Up to (numThreads) chunks are encoded at the same time.
+  Each thread uses one CLzmaEnc object and (chunkSize) bytes of output buffer.
+  A chunk that can't be compressed is stored.
+  The (lzmaProps.numThreads) value is used for each chunk. Its default is 1 here.
+
+  (alloc) and (allocBig) must be thread-safe, if (numThreads > 1).
+
+Return code:
+  SZ_OK               - OK
+  SZ_ERROR_MEM        - Memory allocation error
+  SZ_ERROR_PARAM      - Incorrect paramater
+  SZ_ERROR_OUTPUT_EOF - output buffer overflow
+  SZ_ERROR_THREAD     - error in multithreading functions
+*/
+
+SRes LzmaChunkEnc_Encode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    const CLzmaChunkEncProps *props, ISzAllocPtr alloc, ISzAllocPtr allocBig);
+
+EXTERN_C_END
+
+#endif
@@ -532,6 +532,27 @@ void LzmaEnc_RestoreState(CLzmaEncHandle p)
 
 
 Z7_NO_INLINE
+static void LzmaEnc_SetMfProps(CMatchFinder *mf, const CLzmaEncProps *props)
+{
+  mf->btMode = (Byte)(props->btMode ? 1 : 0);
+  // mf->btMode = (Byte)(props->btMode);
+  {
+    unsigned numHashBytes = 4;
+    if (props->btMode)
+    {
+           if (props->numHashBytes <  2) numHashBytes = 2;
+      else if (props->numHashBytes <  4) numHashBytes = (unsigned)props->numHashBytes;
+    }
+    if (props->numHashBytes >= 5) numHashBytes = 5;
+
+    mf->numHashBytes = numHashBytes;
+    // mf->numHashBytes_Min = 2;
+    mf->numHashOutBits = (Byte)props->numHashOutBits;
+  }
+
+  mf->cutValue = props->mc;
+}
+
 SRes LzmaEnc_SetProps(CLzmaEncHandle p, const CLzmaEncProps *props2)
 {
   // GET_CLzmaEnc_p
@@ -569,23 +590,7 @@ SRes LzmaEnc_SetProps(CLzmaEncHandle p, const CLzmaEncProps *props2)
   p->pb = (unsigned)props.pb;
   p->fastMode = (props.algo == 0);
   // p->_maxMode = True;
-  MFB.btMode = (Byte)(props.btMode ? 1 : 0);
-  // MFB.btMode = (Byte)(props.btMode);
-  {
-    unsigned numHashBytes = 4;
-    if (props.btMode)
-    {
-           if (props.numHashBytes <  2) numHashBytes = 2;
-      else if (props.numHashBytes <  4) numHashBytes = (unsigned)props.numHashBytes;
-    }
-    if (props.numHashBytes >= 5) numHashBytes = 5;
-
-    MFB.numHashBytes = numHashBytes;
-    // MFB.numHashBytes_Min = 2;
-    MFB.numHashOutBits = (Byte)props.numHashOutBits;
-  }
-
-  MFB.cutValue = props.mc;
+  LzmaEnc_SetMfProps(&MFB, &props);
 
   p->writeEndMark = (BoolInt)props.writeEndMark;
 
@@ -2765,6 +2770,54 @@ static SRes LzmaEnc_Alloc(CLzmaEnc *p, UInt32 keepWindowSize, ISzAllocPtr alloc,
   return SZ_OK;
 }
 
+UInt64 LzmaEncProps_GetMemUsage(const CLzmaEncProps *props2, BoolInt directInput, UInt64 dataSize)
+{
+  CLzmaEncProps props = *props2;
+  CMatchFinder mf;
+  UInt64 size, mfSize;
+  UInt32 dictSize;
+  unsigned fb;
+
+  LzmaEncProps_Normalize(&props);
+  if (props.lc > LZMA_LC_MAX
+      || props.lp > LZMA_LP_MAX
+      || props.pb > LZMA_PB_MAX)
+    return 0;
+
+  /* the sizes are calculated as in LzmaEnc_SetProps() and LzmaEnc_Alloc() */
+  dictSize = props.dictSize;
+  if (dictSize > kLzmaMaxHistorySize)
+    dictSize = kLzmaMaxHistorySize;
+  if (dictSize == ((UInt32)2 << 30) ||
+      dictSize == ((UInt32)3 << 30))
+    dictSize -= 1;
+  fb = (unsigned)props.fb;
+  if (fb < 5)
+    fb = 5;
+  if (fb > LZMA_MATCH_LEN_MAX)
+    fb = LZMA_MATCH_LEN_MAX;
+
+  MatchFinder_Construct(&mf);
+  LzmaEnc_SetMfProps(&mf, &props);
+  mf.directInput = (Byte)(directInput ? 1 : 0);
+  mf.expectedDataSize = dataSize;
+
+  #ifndef Z7_ST
+  if (props.numThreads > 1 && props.algo != 0 && mf.btMode)
+    mfSize = MatchFinderMt_GetMemUsage(&mf, dictSize, kNumOpts,
+        fb, LZMA_MATCH_LEN_MAX + 1);
+  else
+  #endif
+    mfSize = MatchFinder_GetMemUsage(&mf, dictSize, kNumOpts,
+        fb, LZMA_MATCH_LEN_MAX + 1);
+  if (mfSize == 0)
+    return 0;
+
+  size = sizeof(CLzmaEnc) + RC_BUF_SIZE + mfSize;
+  size += ((UInt64)0x300 * sizeof(CLzmaProb) * 2) << (props.lc + props.lp);
+  return size;
+}
+
 static void LzmaEnc_Init(CLzmaEnc *p)
 {
   unsigned i;
@@ -42,6 +42,14 @@ void LzmaEncProps_Init(CLzmaEncProps *p);
 void LzmaEncProps_Normalize(CLzmaEncProps *p);
 UInt32 LzmaEncProps_GetDictSize(const CLzmaEncProps *props2);
 
+/* LzmaEncProps_GetMemUsage() returns the size of memory that the encoder allocates
+   with (alloc) and (allocBig) for these props, or 0 for incorrect props.
+     directInput : 1 for LzmaEnc_MemEncode() and LzmaEncode() that don't allocate the window buffer
+     dataSize    : the size of data, or (UInt64)(Int64)-1, if unknown
+   The encoder makes up to LZMA_ENC_NUM_ALLOCS_MAX allocations. */
+#define LZMA_ENC_NUM_ALLOCS_MAX  8
+UInt64 LzmaEncProps_GetMemUsage(const CLzmaEncProps *props, BoolInt directInput, UInt64 dataSize);
+
 
 /* ---------- CLzmaEncHandle Interface ---------- */
 
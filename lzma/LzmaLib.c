@@ -8,18 +8,90 @@
 #include "LzmaEnc.h"
 #include "LzmaLib.h"
 
-Z7_STDAPI LzmaCompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen,
+/* as in LzmaDecode() */
+#define LZMA_LIB_RC_INIT_SIZE 5
+
+struct CLzmaCompressCtx
+{
+  CLzmaEncHandle enc;
+  CArenaAlloc alloc;  /* all allocations of (enc) */
+  UInt64 memUsage;    /* (enc) was created for this memory usage */
+  unsigned lclp;
+};
+
+static void LzmaCompressCtx_Construct(CLzmaCompressCtx *p)
+{
+  p->enc = NULL;
+  ArenaAlloc_Construct(&p->alloc, &g_Alloc);
+  p->memUsage = 0;
+  p->lclp = 0;
+}
+
+static void LzmaCompressCtx_FreeEnc(CLzmaCompressCtx *p)
+{
+  if (p->enc)
+  {
+    LzmaEnc_Destroy(p->enc, &p->alloc.vt, &p->alloc.vt);
+    p->enc = NULL;
+  }
+}
+
+static void LzmaCompressCtx_Free(CLzmaCompressCtx *p)
+{
+  LzmaCompressCtx_FreeEnc(p);
+  ArenaAlloc_Free(&p->alloc);
+}
+
+/* it keeps current encoder, if its buffers are enough for new props */
+
+static SRes LzmaCompressCtx_Prepare(CLzmaCompressCtx *p, const CLzmaEncProps *props, size_t srcLen)
+{
+  const UInt64 memUsage = LzmaEncProps_GetMemUsage(props, True, srcLen);
+  unsigned lclp;
+  {
+    CLzmaEncProps props2 = *props;
+    LzmaEncProps_Normalize(&props2);
+    lclp = (unsigned)(props2.lc + props2.lp);
+  }
+  if (p->enc && (memUsage > p->memUsage || lclp != p->lclp))
+    LzmaCompressCtx_FreeEnc(p);
+  if (!p->enc)
+  {
+    if (memUsage != 0 && memUsage < ((size_t)1 << (sizeof(size_t) * 8 - 2)))
+      ArenaAlloc_Create(&p->alloc, ArenaAlloc_GET_SIZE((size_t)memUsage, LZMA_ENC_NUM_ALLOCS_MAX));
+    /* if the arena was not allocated, the encoder uses (g_Alloc) directly */
+    p->enc = LzmaEnc_Create(&p->alloc.vt);
+    if (!p->enc)
+      return SZ_ERROR_MEM;
+    p->memUsage = memUsage;
+    p->lclp = lclp;
+  }
+  return SZ_OK;
+}
+
+CLzmaCompressCtx *LzmaCompressCtx_Create(void)
+{
+  CLzmaCompressCtx *p = (CLzmaCompressCtx *)ISzAlloc_Alloc(&g_Alloc, sizeof(CLzmaCompressCtx));
+  if (p)
+    LzmaCompressCtx_Construct(p);
+  return p;
+}
+
+void LzmaCompressCtx_Destroy(CLzmaCompressCtx *p)
+{
+  if (!p)
+    return;
+  LzmaCompressCtx_Free(p);
+  ISzAlloc_Free(&g_Alloc, p);
+}
+
+Z7_STDAPI LzmaCompressCtx_Compress(CLzmaCompressCtx *p,
+  unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen,
   unsigned char *outProps, size_t *outPropsSize,
-  int level, /* 0 <= level <= 9, default = 5 */
-  unsigned dictSize, /* use (1 << N) or (3 << N). 4 KB < dictSize <= 128 MB */
-  int lc, /* 0 <= lc <= 8, default = 3  */
-  int lp, /* 0 <= lp <= 4, default = 0  */
-  int pb, /* 0 <= pb <= 4, default = 2  */
-  int fb,  /* 5 <= fb <= 273, default = 32 */
-  int numThreads /* 1 or 2, default = 2 */
-)
+  int level, unsigned dictSize, int lc, int lp, int pb, int fb, int numThreads)
 {
   CLzmaEncProps props;
+  SRes res;
   LzmaEncProps_Init(&props);
   props.level = level;
   props.dictSize = dictSize;
@@ -29,8 +101,87 @@ Z7_STDAPI LzmaCompress(unsigned char *dest, size_t *destLen, const unsigned char
   props.fb = fb;
   props.numThreads = numThreads;
 
-  return LzmaEncode(dest, destLen, src, srcLen, &props, outProps, outPropsSize, 0,
-      NULL, &g_Alloc, &g_Alloc);
+  res = LzmaCompressCtx_Prepare(p, &props, srcLen);
+  if (res == SZ_OK)
+    res = LzmaEnc_SetProps(p->enc, &props);
+  if (res == SZ_OK)
+    res = LzmaEnc_WriteProperties(p->enc, outProps, outPropsSize);
+  if (res == SZ_OK)
+  {
+    res = LzmaEnc_MemEncode(p->enc, dest, destLen, src, srcLen, 0,
+        NULL, &p->alloc.vt, &p->alloc.vt);
+    /* the encoder is reinitialized for each stream,
+       but we don't keep it after unexpected errors */
+    if (res != SZ_OK && res != SZ_ERROR_OUTPUT_EOF)
+      LzmaCompressCtx_FreeEnc(p);
+  }
+  return res;
+}
+
+
+Z7_STDAPI LzmaCompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen,
+  unsigned char *outProps, size_t *outPropsSize,
+  int level, /* 0 <= level <= 9, default = 5 */
+  unsigned dictSize, /* use (1 << N) or (3 << N). 4 KB < dictSize <= 128 MB */
+  int lc, /* 0 <= lc <= 8, default = 3  */
+  int lp, /* 0 <= lp <= 4, default = 0  */
+  int pb, /* 0 <= pb <= 4, default = 2  */
+  int fb,  /* 5 <= fb <= 273, default = 32 */
+  int numThreads /* 1 or 2, default = 2 */
+)
+{
+  CLzmaCompressCtx ctx;
+  SRes res;
+  LzmaCompressCtx_Construct(&ctx);
+  res = LzmaCompressCtx_Compress(&ctx, dest, destLen, src, srcLen, outProps, outPropsSize,
+      level, dictSize, lc, lp, pb, fb, numThreads);
+  LzmaCompressCtx_Free(&ctx);
+  return res;
+}
+
+
+struct CLzmaUncompressCtx
+{
+  CLzmaDec dec;
+};
+
+CLzmaUncompressCtx *LzmaUncompressCtx_Create(void)
+{
+  CLzmaUncompressCtx *p = (CLzmaUncompressCtx *)ISzAlloc_Alloc(&g_Alloc, sizeof(CLzmaUncompressCtx));
+  if (p)
+    LzmaDec_CONSTRUCT(&p->dec)
+  return p;
+}
+
+void LzmaUncompressCtx_Destroy(CLzmaUncompressCtx *p)
+{
+  if (!p)
+    return;
+  LzmaDec_FreeProbs(&p->dec, &g_Alloc);
+  ISzAlloc_Free(&g_Alloc, p);
+}
+
+Z7_STDAPI LzmaUncompressCtx_Uncompress(CLzmaUncompressCtx *p,
+  unsigned char *dest, size_t *destLen, const unsigned char *src, SizeT *srcLen,
+  const unsigned char *props, size_t propsSize)
+{
+  SRes res;
+  ELzmaStatus status;
+  const SizeT outSize = *destLen, inSize = *srcLen;
+  *destLen = *srcLen = 0;
+  if (inSize < LZMA_LIB_RC_INIT_SIZE)
+    return SZ_ERROR_INPUT_EOF;
+  /* the probs are reallocated only, if (lc + lp) was changed */
+  RINOK(LzmaDec_AllocateProbs(&p->dec, props, (unsigned)propsSize, &g_Alloc))
+  p->dec.dic = dest;
+  p->dec.dicBufSize = outSize;
+  LzmaDec_Init(&p->dec);
+  *srcLen = inSize;
+  res = LzmaDec_DecodeToDic(&p->dec, outSize, src, srcLen, LZMA_FINISH_ANY, &status);
+  *destLen = p->dec.dicPos;
+  if (res == SZ_OK && status == LZMA_STATUS_NEEDS_MORE_INPUT)
+    res = SZ_ERROR_INPUT_EOF;
+  return res;
 }
 
 
@@ -133,6 +133,38 @@ Returns:
 Z7_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, SizeT *srcLen,
   const unsigned char *props, size_t propsSize);
 
+/*
+LzmaCompressCtx and LzmaUncompressCtx
+-------------------------------------
+  These contexts are intended for many calls with small or medium data.
+  The compression context keeps the encoder between calls: match finder buffers,
+  hash tables, price tables and the threads of multithreaded match finder.
+  The encoder is recreated only, if new properties or larger (srcLen) need more memory,
+  or if (lc + lp) was changed. All memory of the encoder is allocated in one arena.
+  The decompression context keeps the probability array.
+  The parameters and return codes are same as in LzmaCompress() and LzmaUncompress().
+  The context can be used by one thread at a time.
+*/
+
+typedef struct CLzmaCompressCtx CLzmaCompressCtx;
+
+CLzmaCompressCtx *LzmaCompressCtx_Create(void);
+void LzmaCompressCtx_Destroy(CLzmaCompressCtx *p);
+
+Z7_STDAPI LzmaCompressCtx_Compress(CLzmaCompressCtx *p,
+  unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen,
+  unsigned char *outProps, size_t *outPropsSize,
+  int level, unsigned dictSize, int lc, int lp, int pb, int fb, int numThreads);
+
+typedef struct CLzmaUncompressCtx CLzmaUncompressCtx;
+
+CLzmaUncompressCtx *LzmaUncompressCtx_Create(void);
+void LzmaUncompressCtx_Destroy(CLzmaUncompressCtx *p);
+
+Z7_STDAPI LzmaUncompressCtx_Uncompress(CLzmaUncompressCtx *p,
+  unsigned char *dest, size_t *destLen, const unsigned char *src, SizeT *srcLen,
+  const unsigned char *props, size_t propsSize);
+
 EXTERN_C_END
 
 #endif
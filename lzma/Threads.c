@@ -0,0 +1,249 @@
+/* Threads.c -- multithreading library (POSIX threads)
+2026-10-16 : Public domain */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// we need _GNU_SOURCE for pthread_attr_setaffinity_np() and CPU_SET()
+#define _GNU_SOURCE
+#endif
+
+#include "Precomp.h"
+
+#include <errno.h>
+#include <sched.h>
+
+#include "Threads.h"
+
+#if defined(__GLIBC__) && defined(CPU_SET)
+  #define Z7_AFFINITY_SUPPORTED
+#endif
+
+
+WRes Thread_Create_With_Affinity(CThread *p, THREAD_FUNC_TYPE func, LPVOID param, CAffinityMask affinity)
+{
+  pthread_attr_t attr;
+  int ret;
+
+  p->_created = 0;
+
+  RINOK(pthread_attr_init(&attr))
+
+  ret = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+  #ifdef Z7_AFFINITY_SUPPORTED
+  if (!ret && affinity != 0)
+  {
+    cpu_set_t cs;
+    unsigned i;
+    CPU_ZERO(&cs);
+    for (i = 0; i < sizeof(affinity) * 8; i++)
+      if ((affinity >> i) & 1)
+        CPU_SET(i, &cs);
+    ret = pthread_attr_setaffinity_np(&attr, sizeof(cs), &cs);
+  }
+  #else
+  UNUSED_VAR(affinity)
+  #endif
+
+  if (!ret)
+  {
+    ret = pthread_create(&p->_tid, &attr, func, param);
+    if (!ret)
+      p->_created = 1;
+  }
+  {
+    const int ret2 = pthread_attr_destroy(&attr);
+    if (ret == 0)
+      ret = ret2;
+  }
+  return ret;
+}
+
+
+WRes Thread_Create(CThread *p, THREAD_FUNC_TYPE func, LPVOID param)
+{
+  return Thread_Create_With_Affinity(p, func, param, 0);
+}
+
+
+WRes Thread_Wait_Close(CThread *p)
+{
+  void *thread_return;
+  int ret;
+  if (!p->_created)
+    return 0;
+  ret = pthread_join(p->_tid, &thread_return);
+  p->_tid = 0;
+  p->_created = 0;
+  return ret;
+}
+
+
+static WRes Event_Create(CEvent *p, int manualReset, int signaled)
+{
+  RINOK(pthread_mutex_init(&p->_mutex, NULL))
+  {
+    const int ret = pthread_cond_init(&p->_cond, NULL);
+    if (ret)
+    {
+      pthread_mutex_destroy(&p->_mutex);
+      return ret;
+    }
+  }
+  p->_manual_reset = manualReset;
+  p->_state = (signaled ? 1 : 0);
+  p->_created = 1;
+  return 0;
+}
+
+WRes ManualResetEvent_Create(CManualResetEvent *p, int signaled)
+  { return Event_Create(p, True, signaled); }
+WRes ManualResetEvent_CreateNotSignaled(CManualResetEvent *p)
+  { return ManualResetEvent_Create(p, 0); }
+WRes AutoResetEvent_Create(CAutoResetEvent *p, int signaled)
+  { return Event_Create(p, False, signaled); }
+WRes AutoResetEvent_CreateNotSignaled(CAutoResetEvent *p)
+  { return AutoResetEvent_Create(p, 0); }
+
+
+WRes Event_Set(CEvent *p)
+{
+  RINOK(pthread_mutex_lock(&p->_mutex))
+  p->_state = True;
+  {
+    const int ret1 = pthread_cond_broadcast(&p->_cond);
+    const int ret2 = pthread_mutex_unlock(&p->_mutex);
+    return ret1 ? ret1 : ret2;
+  }
+}
+
+WRes Event_Reset(CEvent *p)
+{
+  RINOK(pthread_mutex_lock(&p->_mutex))
+  p->_state = False;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Event_Wait(CEvent *p)
+{
+  RINOK(pthread_mutex_lock(&p->_mutex))
+  while (p->_state == False)
+  {
+    // ETIMEDOUT and EINTR are not possible for pthread_cond_wait()
+    pthread_cond_wait(&p->_cond, &p->_mutex);
+  }
+  if (p->_manual_reset == False)
+    p->_state = False;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Event_Close(CEvent *p)
+{
+  if (!p->_created)
+    return 0;
+  p->_created = 0;
+  {
+    const int ret1 = pthread_mutex_destroy(&p->_mutex);
+    const int ret2 = pthread_cond_destroy(&p->_cond);
+    return ret1 ? ret1 : ret2;
+  }
+}
+
+
+WRes Semaphore_Create(CSemaphore *p, UInt32 initCount, UInt32 maxCount)
+{
+  if (initCount > maxCount || maxCount < 1)
+    return EINVAL;
+  RINOK(pthread_mutex_init(&p->_mutex, NULL))
+  {
+    const int ret = pthread_cond_init(&p->_cond, NULL);
+    if (ret)
+    {
+      pthread_mutex_destroy(&p->_mutex);
+      return ret;
+    }
+  }
+  p->_count = initCount;
+  p->_maxCount = maxCount;
+  p->_created = 1;
+  return 0;
+}
+
+WRes Semaphore_OptCreateInit(CSemaphore *p, UInt32 initCount, UInt32 maxCount)
+{
+  if (!Semaphore_IsCreated(p))
+    return Semaphore_Create(p, initCount, maxCount);
+  if (initCount > maxCount || maxCount < 1)
+    return EINVAL;
+  RINOK(pthread_mutex_lock(&p->_mutex))
+  p->_count = initCount;
+  p->_maxCount = maxCount;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Semaphore_ReleaseN(CSemaphore *p, UInt32 num)
+{
+  UInt32 newCount;
+  int ret;
+
+  if (num < 1)
+    return EINVAL;
+
+  RINOK(pthread_mutex_lock(&p->_mutex))
+
+  newCount = p->_count + num;
+  if (newCount > p->_maxCount || newCount < num)
+    ret = (WRes)ERROR_TOO_MANY_POSTS;
+  else
+  {
+    p->_count = newCount;
+    ret = pthread_cond_broadcast(&p->_cond);
+  }
+  {
+    const int ret2 = pthread_mutex_unlock(&p->_mutex);
+    return ret ? ret : ret2;
+  }
+}
+
+WRes Semaphore_Wait(CSemaphore *p)
+{
+  RINOK(pthread_mutex_lock(&p->_mutex))
+  while (p->_count < 1)
+  {
+    pthread_cond_wait(&p->_cond, &p->_mutex);
+  }
+  p->_count--;
+  return pthread_mutex_unlock(&p->_mutex);
+}
+
+WRes Semaphore_Close(CSemaphore *p)
+{
+  if (!p->_created)
+    return 0;
+  p->_created = 0;
+  {
+    const int ret1 = pthread_mutex_destroy(&p->_mutex);
+    const int ret2 = pthread_cond_destroy(&p->_cond);
+    return ret1 ? ret1 : ret2;
+  }
+}
+
+
+WRes CriticalSection_Init(CCriticalSection *p)
+{
+  return pthread_mutex_init(&p->_mutex, NULL);
+}
+
+void CriticalSection_Enter(CCriticalSection *p)
+{
+  pthread_mutex_lock(&p->_mutex);
+}
+
+void CriticalSection_Leave(CCriticalSection *p)
+{
+  pthread_mutex_unlock(&p->_mutex);
+}
+
+void CriticalSection_Delete(CCriticalSection *p)
+{
+  pthread_mutex_destroy(&p->_mutex);
+}
@@ -0,0 +1,105 @@
+/* Threads.h -- multithreading library (POSIX threads)
+2026-10-16 : Public domain */
+
+#ifndef ZIP7_INC_THREADS_H
+#define ZIP7_INC_THREADS_H
+
+#ifdef _WIN32
+#error Threads.h : only the POSIX threads version is provided in this tree
+#endif
+
+#include <pthread.h>
+
+#include "7zTypes.h"
+
+EXTERN_C_BEGIN
+
+/* All functions return (0) on success, or (errno) error code.
+   The objects must be constructed (Xxx_Construct) before the first call,
+   and Xxx_Close() / Xxx_Delete() can be called for constructed objects only. */
+
+typedef struct
+{
+  pthread_t _tid;
+  int _created;
+} CThread;
+
+#define Thread_CONSTRUCT(p)   { (p)->_tid = 0; (p)->_created = 0; }
+#define Thread_Construct(p)   Thread_CONSTRUCT(p)
+#define Thread_WasCreated(p)  ((p)->_created != 0)
+
+typedef void * THREAD_FUNC_RET_TYPE;
+#define THREAD_FUNC_RET_ZERO  NULL
+#define THREAD_FUNC_CALL_TYPE
+#define THREAD_FUNC_DECL  THREAD_FUNC_RET_TYPE THREAD_FUNC_CALL_TYPE
+typedef THREAD_FUNC_RET_TYPE (THREAD_FUNC_CALL_TYPE * THREAD_FUNC_TYPE)(void *);
+
+/* bit (i) of CAffinityMask is cpu (i). (affinity == 0) means no restriction.
+   The affinity is ignored, if pthread_attr_setaffinity_np() is not available. */
+typedef UInt64 CAffinityMask;
+
+WRes Thread_Create(CThread *p, THREAD_FUNC_TYPE func, LPVOID param);
+WRes Thread_Create_With_Affinity(CThread *p, THREAD_FUNC_TYPE func, LPVOID param, CAffinityMask affinity);
+WRes Thread_Wait_Close(CThread *p);
+
+
+typedef struct
+{
+  int _created;
+  int _manual_reset;
+  int _state;
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+} CEvent;
+
+typedef CEvent CAutoResetEvent;
+typedef CEvent CManualResetEvent;
+
+#define Event_Construct(p)  (p)->_created = 0
+#define Event_IsCreated(p)  ((p)->_created)
+
+WRes ManualResetEvent_Create(CManualResetEvent *p, int signaled);
+WRes ManualResetEvent_CreateNotSignaled(CManualResetEvent *p);
+WRes AutoResetEvent_Create(CAutoResetEvent *p, int signaled);
+WRes AutoResetEvent_CreateNotSignaled(CAutoResetEvent *p);
+WRes Event_Set(CEvent *p);
+WRes Event_Reset(CEvent *p);
+WRes Event_Wait(CEvent *p);
+WRes Event_Close(CEvent *p);
+
+
+typedef struct
+{
+  int _created;
+  UInt32 _count;
+  UInt32 _maxCount;
+  pthread_mutex_t _mutex;
+  pthread_cond_t _cond;
+} CSemaphore;
+
+#define Semaphore_Construct(p)  (p)->_created = 0
+#define Semaphore_IsCreated(p)  ((p)->_created)
+
+WRes Semaphore_Create(CSemaphore *p, UInt32 initCount, UInt32 maxCount);
+/* Semaphore_OptCreateInit() reinitializes the counter of created semaphore.
+   No thread must wait for that semaphore at that time. */
+WRes Semaphore_OptCreateInit(CSemaphore *p, UInt32 initCount, UInt32 maxCount);
+WRes Semaphore_ReleaseN(CSemaphore *p, UInt32 num);
+#define Semaphore_Release1(p)  Semaphore_ReleaseN(p, 1)
+WRes Semaphore_Wait(CSemaphore *p);
+WRes Semaphore_Close(CSemaphore *p);
+
+
+typedef struct
+{
+  pthread_mutex_t _mutex;
+} CCriticalSection;
+
+WRes CriticalSection_Init(CCriticalSection *cs);
+void CriticalSection_Delete(CCriticalSection *cs);
+void CriticalSection_Enter(CCriticalSection *cs);
+void CriticalSection_Leave(CCriticalSection *cs);
+
+EXTERN_C_END
+
+#endif
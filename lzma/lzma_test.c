@@ -1,7 +1,12 @@
 #include <stdio.h>
 #include <string.h>
+#include "Alloc.h"
 #include "LzmaEnc.h"
 #include "LzmaDec.h"
+#include "LzmaLib.h"
+#include "LzmaChunk.h"
+#include "LzmaChunkEnc.h"
+#include "LzmaChunkDec.h"
 #include "random_data.h"
 
 #define OUT_BUF_SIZE (RANDOM_DATA_SIZE + RANDOM_DATA_SIZE / 3 + 128)  // estimated
@@ -10,8 +15,115 @@
 static unsigned char compressed_data[OUT_BUF_SIZE];
 static unsigned char decompressed_data[RANDOM_DATA_SIZE];
 static unsigned char props[PROPS_SIZE];
+static unsigned char mixed_data[RANDOM_DATA_SIZE];
+
+// Low-entropy text followed by random data : chunks of the first half must be compressed,
+// chunks of the second half stored
+static void generate_mixed(void) {
+    static const char* const words[] = { "alpha ", "beta ", "gamma ", "delta ", "epsilon ",
+                                         "zeta ", "eta ", "theta ", "iota ", "kappa " };
+    unsigned seed = 12345;
+    size_t pos = 0;
+    while (pos < RANDOM_DATA_SIZE / 2) {
+        seed = seed * 1103515245u + 12345u;
+        const char* w = words[(seed >> 16) % 10];
+        while (*w && pos < RANDOM_DATA_SIZE / 2) mixed_data[pos++] = (unsigned char)*w++;
+    }
+    memcpy(mixed_data + pos, random_data + pos, RANDOM_DATA_SIZE - pos);
+}
+
+static UInt32 get_ui32(const unsigned char *p) {
+    return (UInt32)p[0] | ((UInt32)p[1] << 8) | ((UInt32)p[2] << 16) | ((UInt32)p[3] << 24);
+}
+
+// counts the chunks of each type : the footer gives their number, records follow the header
+static void count_chunks(const unsigned char* stream, SizeT size, unsigned *num_lzma, unsigned *num_stored) {
+    UInt32 num_chunks = get_ui32(stream + size - LZMA_CHUNK_FOOTER_SIZE + 8);
+    SizeT pos = LZMA_CHUNK_HEADER_SIZE;
+    UInt32 i;
+    *num_lzma = *num_stored = 0;
+    for (i = 0; i < num_chunks && pos + LZMA_CHUNK_RECORD_HEADER_SIZE <= size; i++) {
+        if (stream[pos] == LZMA_CHUNK_TYPE_LZMA)
+            (*num_lzma)++;
+        else if (stream[pos] == LZMA_CHUNK_TYPE_STORED)
+            (*num_stored)++;
+        pos += LZMA_CHUNK_RECORD_HEADER_SIZE + get_ui32(stream + pos + 1);
+    }
+}
+
+// One context pair for all calls : sizes grow and shrink, and properties change,
+// including lc + lp, so the encoder and the decoder probs are both reused and recreated.
+// The output must be the one of LzmaCompress.
+static int test_contexts(void) {
+    static const struct {
+        size_t offset, size;
+        int level;
+        unsigned dict_size;
+        int lc, lp, pb, num_threads;
+    } cases[] = {
+        { 0,                           1 << 16,          5, 1 << 16, 3, 0, 2, 1 },
+        { 1000,                        4000,             5, 1 << 16, 3, 0, 2, 1 },
+        { 0,                           RANDOM_DATA_SIZE, 9, 1 << 20, 3, 0, 2, 2 },
+        { 300000,                      1 << 17,          1, 1 << 16, 0, 2, 0, 1 },
+        { RANDOM_DATA_SIZE / 2 - 5000, 10000,            5, 1 << 16, 4, 0, 2, 2 },
+        { 17,                          100,              9, 1 << 12, 3, 0, 2, 1 },
+        { 0,                           1 << 16,          5, 1 << 16, 3, 0, 2, 1 }
+    };
+    static unsigned char expected[OUT_BUF_SIZE];
+    CLzmaCompressCtx *enc_ctx = LzmaCompressCtx_Create();
+    CLzmaUncompressCtx *dec_ctx = LzmaUncompressCtx_Create();
+    int errors = 0;
+    size_t i;
+
+    if (!enc_ctx || !dec_ctx) {
+	    printf("Context allocation failed\n");
+	    LzmaCompressCtx_Destroy(enc_ctx);
+	    LzmaUncompressCtx_Destroy(dec_ctx);
+	    return 1;
+    }
+    generate_mixed();
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+	    const unsigned char *src = mixed_data + cases[i].offset;
+	    unsigned char expected_props[PROPS_SIZE];
+	    size_t props_size = PROPS_SIZE, expected_props_size = PROPS_SIZE;
+	    size_t dest_len = sizeof(compressed_data), expected_len = sizeof(expected);
+	    SizeT dest_len_dec = cases[i].size, src_len;
+
+	    int res = LzmaCompressCtx_Compress(enc_ctx, compressed_data, &dest_len, src, cases[i].size,
+			    props, &props_size, cases[i].level, cases[i].dict_size,
+			    cases[i].lc, cases[i].lp, cases[i].pb, 32, cases[i].num_threads);
+	    int ref = LzmaCompress(expected, &expected_len, src, cases[i].size,
+			    expected_props, &expected_props_size, cases[i].level, cases[i].dict_size,
+			    cases[i].lc, cases[i].lp, cases[i].pb, 32, cases[i].num_threads);
+	    if (res != SZ_OK || ref != SZ_OK || dest_len != expected_len ||
+			    memcmp(compressed_data, expected, dest_len) != 0 ||
+			    memcmp(props, expected_props, PROPS_SIZE) != 0) {
+		    printf("Context compression %u differs from LzmaCompress\n", (unsigned)i);
+		    errors++;
+		    continue;
+	    }
+
+	    src_len = dest_len;
+	    res = LzmaUncompressCtx_Uncompress(dec_ctx, decompressed_data, &dest_len_dec,
+			    compressed_data, &src_len, props, props_size);
+	    if (res != SZ_OK || dest_len_dec != cases[i].size ||
+			    memcmp(src, decompressed_data, cases[i].size) != 0) {
+		    printf("Context decompression %u failed: %d\n", (unsigned)i, res);
+		    errors++;
+	    }
+    }
+    LzmaCompressCtx_Destroy(enc_ctx);
+    LzmaUncompressCtx_Destroy(dec_ctx);
+
+    if (errors == 0) {
+	    printf("Context verification PASSED\n");
+    } else {
+	    printf("Context verification FAILED\n");
+	    return 1;
+    }
+    return 0;
+}
 
-extern void my_reset_pool(void) ;
 int compression_levels =10;
 int outer_loop = 4;
 int main() {
@@ -22,8 +134,10 @@ int main() {
     {
 	    for(level_idx=0; level_idx < compression_levels; level_idx++)
 	    {
-			printf("[%d] Compression Level %d \n", loop_idx, level_idx);
-			my_reset_pool();
+			// single-threaded match finder on even loops, LzFindMt on odd ones
+			int num_threads = (loop_idx & 1) + 1;
+			printf("[%d] Compression Level %d (%d thread%s)\n", loop_idx, level_idx,
+					num_threads, num_threads > 1 ? "s" : "");
     			size_t props_size = PROPS_SIZE;
 		    size_t dest_len = sizeof(compressed_data);
 
@@ -33,7 +147,7 @@ int main() {
 				    props, &props_size,
 				    level_idx,         // compression level (0-9)
 				    1 << 20,   // dictionary size = 1MB
-				    3, 0, 2, 32, 1);
+				    3, 0, 2, 32, num_threads);
 
 		    if (res != SZ_OK) {
 			    printf("Compression failed: %d\n", res);
@@ -47,7 +161,6 @@ int main() {
 		    SizeT dest_len_dec = RANDOM_DATA_SIZE;
 		    SizeT src_len = dest_len;
 
-		    ELzmaStatus status;
 		    res = LzmaUncompress(decompressed_data, &dest_len_dec,
 				    compressed_data, &src_len,
 				    props, props_size);
@@ -66,6 +179,72 @@ int main() {
 	    } //level_idx
     } //outer_loop
 
+    if (test_contexts() != 0)
+	    return 1;
+
+    // Chunked stream : chunks are encoded and decoded in parallel
+    {
+	    CLzmaChunkEncProps chunk_props;
+	    unsigned num_lzma, num_stored;
+	    LzmaChunkEncProps_Init(&chunk_props);
+	    chunk_props.lzmaProps.level = 9;
+	    chunk_props.chunkSize = 1 << 16;
+	    chunk_props.numThreads = 4;
+
+	    generate_mixed();
+	    SizeT dest_len = sizeof(compressed_data);
+	    int res = LzmaChunkEnc_Encode(compressed_data, &dest_len,
+			    mixed_data, RANDOM_DATA_SIZE, &chunk_props,
+			    &g_Alloc, &g_Alloc);
+	    if (res != SZ_OK) {
+		    printf("Chunked compression failed: %d\n", res);
+		    return 1;
+	    }
+	    count_chunks(compressed_data, dest_len, &num_lzma, &num_stored);
+	    printf("Chunked compressed size: %zu bytes (%.2f%%), %u LZMA chunks, %u stored chunks\n", dest_len,
+			    (dest_len * 100.0) / RANDOM_DATA_SIZE, num_lzma, num_stored);
+
+	    SizeT dest_len_dec = RANDOM_DATA_SIZE;
+	    res = LzmaChunkDec_Decode(decompressed_data, &dest_len_dec,
+			    compressed_data, dest_len, 4, &g_Alloc);
+	    if (res != SZ_OK || dest_len_dec != RANDOM_DATA_SIZE) {
+		    printf("Chunked decompression failed: %d\n", res);
+		    return 1;
+	    }
+
+	    if (memcmp(mixed_data, decompressed_data, RANDOM_DATA_SIZE) == 0 &&
+			    num_lzma > 0 && num_stored > 0 &&
+			    num_lzma + num_stored == RANDOM_DATA_SIZE / chunk_props.chunkSize) {
+		    printf("Chunked verification PASSED\n");
+	    } else {
+		    printf("Chunked verification FAILED\n");
+		    return 1;
+	    }
+    }
+
+    // Chunked stream of incompressible data, into a buffer sized by LzmaChunkEnc_GetMaxPackSize() with default props
+    {
+	    CLzmaChunkEncProps chunk_props;
+	    LzmaChunkEncProps_Init(&chunk_props);
+	    SizeT max_size = LzmaChunkEnc_GetMaxPackSize(RANDOM_DATA_SIZE, &chunk_props);
+	    SizeT dest_len = max_size;
+	    int res = (max_size >= RANDOM_DATA_SIZE && max_size <= sizeof(compressed_data)) ?
+			    LzmaChunkEnc_Encode(compressed_data, &dest_len, random_data, RANDOM_DATA_SIZE,
+					    &chunk_props, &g_Alloc, &g_Alloc) : SZ_ERROR_PARAM;
+	    SizeT dest_len_dec = RANDOM_DATA_SIZE;
+	    if (res == SZ_OK)
+		    res = LzmaChunkDec_Decode(decompressed_data, &dest_len_dec,
+				    compressed_data, dest_len, 1, &g_Alloc);
+	    printf("Chunked max pack size: %zu bytes, compressed size: %zu bytes\n", max_size, dest_len);
+	    if (res == SZ_OK && dest_len_dec == RANDOM_DATA_SIZE &&
+			    memcmp(random_data, decompressed_data, RANDOM_DATA_SIZE) == 0) {
+		    printf("Chunked max pack size verification PASSED\n");
+	    } else {
+		    printf("Chunked max pack size verification FAILED: %d\n", res);
+		    return 1;
+	    }
+    }
+
     return 0;
 }
 